@@ -0,0 +1,276 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "bench.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "logging.h"
+
+#define BENCH_MAX_REPEAT 32
+#define BENCH_DEFAULT_REPEAT 5
+#define BENCH_DEFAULT_MIN_TIME_MS 200
+
+#ifndef YUREI_BENCH_CORPUS_DIR
+#define YUREI_BENCH_CORPUS_DIR "bench/corpus"
+#endif
+
+// ---------------------------------------------------------------------------
+// Allocation counting: interpose the glibc allocator so allocs/op covers every
+// library the hot paths call into (cJSON, libpq, ...). Sanitizer builds bring
+// their own allocator and must define YUREI_BENCH_NO_ALLOC_HOOKS.
+// ---------------------------------------------------------------------------
+
+static _Atomic uint64_t g_allocs;
+
+#if defined(__GLIBC__) && !defined(YUREI_BENCH_NO_ALLOC_HOOKS)
+#define BENCH_ALLOC_HOOKS 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static inline void count_alloc(void) {
+    atomic_fetch_add_explicit(&g_allocs, 1, memory_order_relaxed);
+}
+
+void *malloc(size_t size) {
+    count_alloc();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    count_alloc();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    count_alloc();
+    return __libc_realloc(ptr, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    count_alloc();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    count_alloc();
+    void *ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+#else
+#define BENCH_ALLOC_HOOKS 0
+#endif
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t bench_rand(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+void bench_start(BenchRun *run) {
+    run->allocs_start = atomic_load_explicit(&g_allocs, memory_order_relaxed);
+    run->start_ns = bench_now_ns();
+}
+
+void bench_stop(BenchRun *run) {
+    run->stop_ns = bench_now_ns();
+    run->allocs = atomic_load_explicit(&g_allocs, memory_order_relaxed) - run->allocs_start;
+}
+
+bool bench_selected(const BenchContext *ctx, const char *name) {
+    return !ctx->filter || strstr(name, ctx->filter) != NULL;
+}
+
+static bool run_once(BenchFn fn, const void *arg, uint64_t iters, BenchRun *run) {
+    memset(run, 0, sizeof(*run));
+    run->iters = iters;
+    if (!fn(arg, run) || run->stop_ns < run->start_ns) {
+        return false;
+    }
+    if (run->events == 0) {
+        run->events = iters;
+    }
+    return true;
+}
+
+static uint64_t elapsed_ns(const BenchRun *run) {
+    uint64_t ns = run->stop_ns - run->start_ns;
+    return ns ? ns : 1;
+}
+
+static double ns_per_op(const BenchRun *run) {
+    return (double)elapsed_ns(run) / (double)run->iters;
+}
+
+static int compare_runs(const void *a, const void *b) {
+    double x = ns_per_op((const BenchRun *)a);
+    double y = ns_per_op((const BenchRun *)b);
+    return (x > y) - (x < y);
+}
+
+static void report(const BenchContext *ctx, const char *name, const BenchRun *run) {
+    double seconds = (double)elapsed_ns(run) / 1e9;
+    double events_per_sec = (double)run->events / seconds;
+    double mb_per_sec = (double)run->bytes / seconds / (1024.0 * 1024.0);
+    double allocs = (double)run->allocs / (double)run->iters;
+
+    if (ctx->csv) {
+        printf("%s,%" PRIu64 ",%.1f,%.0f,", name, run->iters, ns_per_op(run), events_per_sec);
+        if (BENCH_ALLOC_HOOKS) {
+            printf("%.3f,", allocs);
+        } else {
+            printf(",");
+        }
+        if (run->bytes) {
+            printf("%.1f\n", mb_per_sec);
+        } else {
+            printf("\n");
+        }
+    } else {
+        char allocs_buf[32] = "n/a";
+        char mb_buf[32] = "-";
+        if (BENCH_ALLOC_HOOKS) {
+            snprintf(allocs_buf, sizeof(allocs_buf), "%.3f", allocs);
+        }
+        if (run->bytes) {
+            snprintf(mb_buf, sizeof(mb_buf), "%.1f", mb_per_sec);
+        }
+        printf("%-36s %12" PRIu64 " %12.1f %14.0f %10s %10s\n",
+               name, run->iters, ns_per_op(run), events_per_sec, allocs_buf, mb_buf);
+    }
+    fflush(stdout);
+}
+
+void bench_case(BenchContext *ctx,
+                const char *name,
+                BenchFn fn,
+                const void *arg,
+                uint64_t fixed_iters) {
+    if (!bench_selected(ctx, name)) {
+        return;
+    }
+
+    BenchRun runs[BENCH_MAX_REPEAT];
+    uint64_t iters = fixed_iters;
+    if (iters == 0) {
+        // Grow until a run is long enough to time, then scale to min_time
+        iters = 1;
+        for (;;) {
+            if (!run_once(fn, arg, iters, &runs[0])) {
+                YUREI_LOG_ERROR("Benchmark %s failed during calibration", name);
+                return;
+            }
+            uint64_t ns = elapsed_ns(&runs[0]);
+            if (ns >= ctx->min_time_ns / 10 || iters >= (UINT64_MAX / 100)) {
+                double scale = (double)ctx->min_time_ns / (double)ns;
+                if (scale > 1.0) {
+                    iters = (uint64_t)((double)iters * scale) + 1;
+                }
+                break;
+            }
+            iters *= 10;
+        }
+    }
+
+    uint32_t repeat = ctx->repeat;
+    for (uint32_t i = 0; i < repeat; ++i) {
+        if (!run_once(fn, arg, iters, &runs[i])) {
+            YUREI_LOG_ERROR("Benchmark %s failed", name);
+            return;
+        }
+    }
+    qsort(runs, repeat, sizeof(runs[0]), compare_runs);
+    report(ctx, name, &runs[repeat / 2]);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-c path/to/.env] [--filter substr] [--repeat N] "
+            "[--min-time-ms N] [--corpus dir] [--csv]\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    const char *env_path = ".env";
+    BenchContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.corpus_dir = YUREI_BENCH_CORPUS_DIR;
+    ctx.repeat = BENCH_DEFAULT_REPEAT;
+    ctx.min_time_ns = BENCH_DEFAULT_MIN_TIME_MS * 1000000ULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) &&
+            i + 1 < argc) {
+            env_path = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            ctx.filter = argv[++i];
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            ctx.repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            ctx.min_time_ns = strtoull(argv[++i], NULL, 10) * 1000000ULL;
+        } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            ctx.corpus_dir = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            ctx.csv = true;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (ctx.repeat == 0) {
+        ctx.repeat = 1;
+    }
+    if (ctx.repeat > BENCH_MAX_REPEAT) {
+        ctx.repeat = BENCH_MAX_REPEAT;
+    }
+
+    if (yurei_config_load(env_path, &ctx.config) != 0) {
+        YUREI_LOG_ERROR("Failed to load configuration");
+        return 1;
+    }
+    // Keep per-event warnings out of the timed loops
+    yurei_log_set_level(YUREI_LOG_ERROR);
+
+    if (ctx.csv) {
+        printf("name,iters,ns_per_op,events_per_sec,allocs_per_op,mb_per_sec\n");
+    } else {
+        printf("%-36s %12s %12s %14s %10s %10s\n",
+               "benchmark", "iters", "ns/op", "events/s", "allocs/op", "MB/s");
+    }
+
+    bench_parser(&ctx);
+    bench_base64(&ctx);
+    bench_queue(&ctx);
+    bench_db_writer(&ctx);
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_BENCH_H
+#define YUREI_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+
+// One timed run of a benchmark. The harness fills iters; the benchmark
+// brackets the measured region with bench_start/bench_stop (setup and
+// teardown stay outside) and reports what it processed.
+typedef struct {
+    uint64_t iters;
+    uint64_t events;  // events produced or consumed; defaults to iters
+    uint64_t bytes;   // input bytes processed, 0 if not meaningful
+    uint64_t start_ns;
+    uint64_t stop_ns;
+    uint64_t allocs_start;
+    uint64_t allocs;
+} BenchRun;
+
+typedef bool (*BenchFn)(const void *arg, BenchRun *run);
+
+typedef struct {
+    YureiConfig config;
+    const char *corpus_dir;
+    const char *filter;
+    uint32_t repeat;
+    uint64_t min_time_ns;
+    bool csv;
+} BenchContext;
+
+void bench_start(BenchRun *run);
+void bench_stop(BenchRun *run);
+
+// Calibrate iterations to min_time, run `repeat` times and report the median.
+// fixed_iters > 0 skips calibration (for benchmarks with external side effects).
+void bench_case(BenchContext *ctx,
+                const char *name,
+                BenchFn fn,
+                const void *arg,
+                uint64_t fixed_iters);
+bool bench_selected(const BenchContext *ctx, const char *name);
+
+uint64_t bench_now_ns(void);
+// Deterministic xorshift PRNG so every run sees the same inputs
+uint64_t bench_rand(uint64_t *state);
+
+void bench_parser(BenchContext *ctx);
+void bench_base64(BenchContext *ctx);
+void bench_queue(BenchContext *ctx);
+void bench_db_writer(BenchContext *ctx);
+
+#endif // YUREI_BENCH_H
@@ -0,0 +1,105 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+#include "event_queue.h"
+
+typedef struct {
+    const char *encoded;
+    size_t encoded_len;
+    uint8_t *output;
+    size_t output_cap;
+} Base64Bench;
+
+static size_t encode(const uint8_t *input, size_t len, char *out) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = (uint32_t)input[i] << 16 | (uint32_t)input[i + 1] << 8 | input[i + 2];
+        out[o++] = alphabet[(v >> 18) & 63];
+        out[o++] = alphabet[(v >> 12) & 63];
+        out[o++] = alphabet[(v >> 6) & 63];
+        out[o++] = alphabet[v & 63];
+    }
+    if (i < len) {
+        uint32_t v = (uint32_t)input[i] << 16;
+        if (i + 1 < len) {
+            v |= (uint32_t)input[i + 1] << 8;
+        }
+        out[o++] = alphabet[(v >> 18) & 63];
+        out[o++] = alphabet[(v >> 12) & 63];
+        out[o++] = i + 1 < len ? alphabet[(v >> 6) & 63] : '=';
+        out[o++] = '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+// One op decodes one payload of the given decoded size
+static bool run_decode(const void *arg, BenchRun *run) {
+    const Base64Bench *bench = arg;
+    size_t out_len = 0;
+    uint64_t sink = 0;
+
+    bench_start(run);
+    for (uint64_t i = 0; i < run->iters; ++i) {
+        if (!yurei_base64_decode(bench->encoded, bench->encoded_len,
+                                 bench->output, bench->output_cap, &out_len)) {
+            return false;
+        }
+        sink += bench->output[i % out_len];
+    }
+    bench_stop(run);
+    run->bytes = run->iters * bench->encoded_len;
+    return sink != UINT64_MAX;
+}
+
+void bench_base64(BenchContext *ctx) {
+    static const size_t sizes[] = {64, 256, 1024, YUREI_EVENT_PAYLOAD_MAX};
+    static const YureiBase64Impl impls[] = {
+        YUREI_BASE64_SCALAR, YUREI_BASE64_SSE41, YUREI_BASE64_AVX2
+    };
+    YureiBase64Impl active = yurei_base64_active_impl();
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        size_t len = sizes[s];
+        uint8_t *raw = malloc(len);
+        char *encoded = malloc(len / 3 * 4 + 8);
+        Base64Bench bench = {0};
+        bench.output_cap = yurei_base64_decoded_max(len / 3 * 4 + 4) + YUREI_BASE64_SIMD_SLACK;
+        bench.output = malloc(bench.output_cap);
+        if (!raw || !encoded || !bench.output) {
+            free(raw);
+            free(encoded);
+            free(bench.output);
+            return;
+        }
+        for (size_t i = 0; i < len; ++i) {
+            raw[i] = (uint8_t)bench_rand(&seed);
+        }
+        bench.encoded = encoded;
+        bench.encoded_len = encode(raw, len, encoded);
+
+        for (size_t k = 0; k < sizeof(impls) / sizeof(impls[0]); ++k) {
+            if (!yurei_base64_select(impls[k])) {
+                continue;  // not supported on this CPU
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "base64/%s/%zu", yurei_base64_impl_name(impls[k]), len);
+            bench_case(ctx, name, run_decode, &bench, 0);
+        }
+        free(raw);
+        free(encoded);
+        free(bench.output);
+    }
+    yurei_base64_select(active);
+}
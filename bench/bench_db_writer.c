@@ -0,0 +1,181 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "bench.h"
+
+#include <inttypes.h>
+#include <libpq-fe.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "db_writer.h"
+#include "pipeline.h"
+#include "sharded_queue.h"
+#include "logging.h"
+
+// Scratch table so benchmark rows never land next to real data
+#define DB_BENCH_TABLE "yurei_bench_events"
+#define DB_BENCH_PROGRAM_A "BenchProgramA1111111111111111111111111111111"
+#define DB_BENCH_PROGRAM_B "BenchProgramB1111111111111111111111111111111"
+#define DB_BENCH_EVENTS 20000
+#define DB_BENCH_PAYLOAD 256
+
+typedef struct {
+    const YureiConfig *base;
+    const char *mode;
+    uint32_t writers;
+} DbBench;
+
+static bool exec_sql(PGconn *conn, const char *sql) {
+    PGresult *res = PQexec(conn, sql);
+    bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok) {
+        YUREI_LOG_ERROR("Benchmark SQL failed: %s", PQerrorMessage(conn));
+    }
+    PQclear(res);
+    return ok;
+}
+
+static bool reset_table(const char *conninfo) {
+    PGconn *conn = PQconnectdb(conninfo);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        PQfinish(conn);
+        return false;
+    }
+    bool ok = exec_sql(conn,
+                       "DROP TABLE IF EXISTS " DB_BENCH_TABLE ", " DB_BENCH_TABLE "_staging") &&
+              exec_sql(conn,
+                       "CREATE TABLE " DB_BENCH_TABLE " ("
+                       "observed_at TIMESTAMPTZ DEFAULT now(), "
+                       "slot BIGINT NOT NULL, "
+                       "signature TEXT PRIMARY KEY, "
+                       "program_id TEXT, "
+                       "raw_log BYTEA NOT NULL)");
+    PQfinish(conn);
+    return ok;
+}
+
+static long long count_rows(const char *conninfo) {
+    PGconn *conn = PQconnectdb(conninfo);
+    long long rows = -1;
+    if (PQstatus(conn) == CONNECTION_OK) {
+        PGresult *res = PQexec(conn, "SELECT COUNT(*) FROM " DB_BENCH_TABLE);
+        if (PQresultStatus(res) == PGRES_TUPLES_OK) {
+            rows = strtoll(PQgetvalue(res, 0, 0), NULL, 10);
+        }
+        PQclear(res);
+    }
+    PQfinish(conn);
+    return rows;
+}
+
+static void drop_table(const char *conninfo) {
+    PGconn *conn = PQconnectdb(conninfo);
+    if (PQstatus(conn) == CONNECTION_OK) {
+        exec_sql(conn, "DROP TABLE IF EXISTS " DB_BENCH_TABLE ", " DB_BENCH_TABLE "_staging");
+    }
+    PQfinish(conn);
+}
+
+// One op is one event pushed through the queue and committed by the writer.
+// The clock stops once the writer has drained the closed queue (and, in copy
+// mode, merged staging), so the figure is end-to-end commit throughput.
+static bool run_writer(const void *arg, BenchRun *run) {
+    const DbBench *bench = arg;
+    YureiConfig config = *bench->base;
+    // Two programs sharing the bench table, so batches interleave kinds
+    yurei_program_registry_init(&config.programs);
+    if (yurei_program_registry_parse(&config.programs,
+                                     "bench_a:" DB_BENCH_PROGRAM_A ":" DB_BENCH_TABLE
+                                     ",bench_b:" DB_BENCH_PROGRAM_B ":" DB_BENCH_TABLE) != 0 ||
+        yurei_program_registry_build(&config.programs) != 0) {
+        return false;
+    }
+    snprintf(config.db_write_mode, sizeof(config.db_write_mode), "%s", bench->mode);
+    config.db_writers = bench->writers;
+
+    if (!reset_table(config.pg_conninfo)) {
+        return false;
+    }
+    YureiShardedQueue queue;
+    if (yurei_sharded_queue_init(&queue, config.db_writers, config.queue_capacity) != 0) {
+        return false;
+    }
+
+    uint8_t payload[DB_BENCH_PAYLOAD];
+    uint64_t seed = 0x2545f4914f6cdd1dULL;
+    for (size_t i = 0; i < sizeof(payload); ++i) {
+        payload[i] = (uint8_t)bench_rand(&seed);
+    }
+
+    YureiPipeline pipeline = {.queue = &queue};
+    YureiDbWriter writer;
+    bench_start(run);
+    if (yurei_db_writer_start(&writer, &config, &pipeline) != 0) {
+        yurei_sharded_queue_destroy(&queue);
+        return false;
+    }
+    for (uint64_t i = 0; i < run->iters; ++i) {
+        YureiEvent event;
+        memset(&event, 0, sizeof(event));
+        event.kind = (YureiEventKind)(i & 1);
+        event.slot = i;
+        snprintf(event.signature, sizeof(event.signature), "bench-%d-%" PRIu64, (int)getpid(), i);
+        snprintf(event.program_id, sizeof(event.program_id), "%.*s",
+                 (int)sizeof(event.program_id) - 1, config.programs.programs[event.kind].program_id);
+        size_t shard_idx = yurei_shard_for_signature(event.signature, queue.count);
+        YureiEventQueue *shard = &queue.shards[shard_idx];
+        if (yurei_event_payload_alloc(shard, &event, sizeof(payload)) != 0) {
+            break;
+        }
+        memcpy(event.data, payload, sizeof(payload));
+        event.data_len = sizeof(payload);
+        if (yurei_queue_push(shard, &event) != 0) {
+            yurei_event_release(shard, &event);
+            break;
+        }
+    }
+    yurei_sharded_queue_close(&queue);
+    yurei_db_writer_stop(&writer);
+    bench_stop(run);
+    yurei_sharded_queue_destroy(&queue);
+
+    long long rows = count_rows(config.pg_conninfo);
+    drop_table(config.pg_conninfo);
+    if (rows != (long long)run->iters) {
+        YUREI_LOG_ERROR("DB writer (%s) committed %lld of %" PRIu64 " rows",
+                        bench->mode, rows, run->iters);
+        return false;
+    }
+    return true;
+}
+
+void bench_db_writer(BenchContext *ctx) {
+    static const DbBench cases[] = {
+        {NULL, YUREI_DB_MODE_INSERT, 1},
+        {NULL, YUREI_DB_MODE_INSERT, 4},
+        {NULL, YUREI_DB_MODE_COPY, 1},
+        {NULL, YUREI_DB_MODE_COPY, 4},
+    };
+    char names[sizeof(cases) / sizeof(cases[0])][64];
+    bool any = false;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        snprintf(names[i], sizeof(names[i]), "db_writer/%s/%uw", cases[i].mode, cases[i].writers);
+        any = any || bench_selected(ctx, names[i]);
+    }
+    if (!any) {
+        return;
+    }
+    // Writers keep retrying a dead server until shutdown; only run against a live one
+    if (PQping(ctx->config.pg_conninfo) != PQPING_OK) {
+        fprintf(stderr, "db_writer: PostgreSQL not reachable via YUREI_PG_CONNINFO, skipping\n");
+        return;
+    }
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        DbBench bench = cases[i];
+        bench.base = &ctx->config;
+        bench_case(ctx, names[i], run_writer, &bench, DB_BENCH_EVENTS);
+    }
+}
@@ -0,0 +1,253 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "bench.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logging.h"
+#include "parser.h"
+#include "parser_pool.h"
+#include "pipeline.h"
+#include "sharded_queue.h"
+
+#define PARSER_QUEUE_CAPACITY 4096
+#define PARSER_DRAIN_BATCH 256
+
+typedef struct {
+    char *data;  // one message per line, newlines replaced by NUL
+    const char **messages;
+    size_t *lengths;
+    size_t count;
+} Corpus;
+
+typedef struct {
+    const Corpus *corpus;
+    const YureiConfig *config;
+    const YureiPipeline *pipeline;
+} ParserBench;
+
+static bool load_corpus(const char *dir, const char *file, Corpus *corpus) {
+    memset(corpus, 0, sizeof(*corpus));
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        YUREI_LOG_ERROR("Unable to open corpus %s", path);
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(fp);
+        return false;
+    }
+    corpus->data = malloc((size_t)size + 1);
+    if (!corpus->data || fread(corpus->data, 1, (size_t)size, fp) != (size_t)size) {
+        fclose(fp);
+        free(corpus->data);
+        corpus->data = NULL;
+        return false;
+    }
+    fclose(fp);
+    corpus->data[size] = '\0';
+
+    size_t lines = 1;
+    for (long i = 0; i < size; ++i) {
+        lines += corpus->data[i] == '\n';
+    }
+    corpus->messages = calloc(lines, sizeof(*corpus->messages));
+    corpus->lengths = calloc(lines, sizeof(*corpus->lengths));
+    if (!corpus->messages || !corpus->lengths) {
+        return false;
+    }
+    char *save = NULL;
+    for (char *line = strtok_r(corpus->data, "\n", &save); line;
+         line = strtok_r(NULL, "\n", &save)) {
+        corpus->messages[corpus->count] = line;
+        corpus->lengths[corpus->count] = strlen(line);
+        corpus->count++;
+    }
+    return corpus->count > 0;
+}
+
+static void free_corpus(Corpus *corpus) {
+    free(corpus->data);
+    free(corpus->messages);
+    free(corpus->lengths);
+    memset(corpus, 0, sizeof(*corpus));
+}
+
+// Force the cJSON fallback: an escaped "Program data:" line cannot be sliced
+// in place, so the fast scanner hands the whole message over.
+static void escape_payload_lines(Corpus *corpus) {
+    static const char needle[] = "Program data: ";
+    static const char escaped[] = "Program data:\\u0020";
+    size_t total = 0;
+    for (size_t i = 0; i < corpus->count; ++i) {
+        total += corpus->lengths[i] * 2 + 1;
+    }
+    char *data = malloc(total);
+    if (!data) {
+        return;
+    }
+    char *out = data;
+    for (size_t i = 0; i < corpus->count; ++i) {
+        const char *in = corpus->messages[i];
+        const char *end = in + corpus->lengths[i];
+        char *start = out;
+        while (in < end) {
+            const char *hit = strstr(in, needle);
+            if (!hit || hit >= end) {
+                hit = end;
+            }
+            memcpy(out, in, (size_t)(hit - in));
+            out += hit - in;
+            in = hit;
+            if (in < end) {
+                memcpy(out, escaped, sizeof(escaped) - 1);
+                out += sizeof(escaped) - 1;
+                in += sizeof(needle) - 1;
+            }
+        }
+        *out++ = '\0';
+        corpus->messages[i] = start;
+        corpus->lengths[i] = (size_t)(out - start - 1);
+    }
+    free(corpus->data);
+    corpus->data = data;
+}
+
+static void drain(YureiShardedQueue *queue) {
+    YureiEvent events[PARSER_DRAIN_BATCH];
+    for (size_t s = 0; s < queue->count; ++s) {
+        YureiEventQueue *shard = &queue->shards[s];
+        size_t n;
+        while ((n = yurei_queue_try_pop_batch(shard, events, PARSER_DRAIN_BATCH)) > 0) {
+            for (size_t i = 0; i < n; ++i) {
+                yurei_event_release(shard, &events[i]);
+            }
+        }
+    }
+}
+
+// One op is one message, including handing its events to the queue and
+// releasing them again, as the writer would.
+static bool run_parser(const void *arg, BenchRun *run) {
+    const ParserBench *bench = arg;
+    const Corpus *corpus = bench->corpus;
+    uint64_t highest_slot = 0;
+    uint64_t events = 0;
+
+    bench_start(run);
+    for (uint64_t i = 0; i < run->iters; ++i) {
+        size_t idx = (size_t)(i % corpus->count);
+        int rc = yurei_parser_handle_buffer(corpus->messages[idx],
+                                            corpus->lengths[idx],
+                                            bench->config,
+                                            bench->pipeline,
+                                            &highest_slot);
+        if (rc < 0) {
+            return false;
+        }
+        events += (uint64_t)rc;
+        run->bytes += corpus->lengths[idx];
+        drain(bench->pipeline->queue);
+    }
+    bench_stop(run);
+    run->events = events;
+    return true;
+}
+
+static void *drain_thread(void *arg) {
+    YureiEventQueue *shard = arg;
+    YureiEvent events[PARSER_DRAIN_BATCH];
+    int n;
+    while ((n = yurei_queue_pop_batch(shard, events, PARSER_DRAIN_BATCH,
+                                      YUREI_QUEUE_WAIT_FOREVER)) > 0) {
+        for (int i = 0; i < n; ++i) {
+            yurei_event_release(shard, &events[i]);
+        }
+    }
+    return NULL;
+}
+
+// One op is one message submitted from the network thread's side and parsed
+// by the pool (YUREI_PARSER_THREADS workers); the clock stops once the pool
+// has drained. Submits that find the buffer full wait for the workers.
+static bool run_parser_pool(const void *arg, BenchRun *run) {
+    const ParserBench *bench = arg;
+    const Corpus *corpus = bench->corpus;
+    YureiShardedQueue queue;
+    if (yurei_sharded_queue_init(&queue, 1, PARSER_QUEUE_CAPACITY) != 0) {
+        return false;
+    }
+    pthread_t drainer;
+    if (pthread_create(&drainer, NULL, drain_thread, &queue.shards[0]) != 0) {
+        yurei_sharded_queue_destroy(&queue);
+        return false;
+    }
+    YureiPipeline pipeline = {.queue = &queue};
+    YureiParserPool pool;
+    bool ok = yurei_parser_pool_start(&pool, bench->config, &pipeline) == 0;
+
+    bench_start(run);
+    for (uint64_t i = 0; ok && i < run->iters; ++i) {
+        size_t idx = (size_t)(i % corpus->count);
+        yurei_parser_pool_submit(&pool, corpus->messages[idx], corpus->lengths[idx], 0);
+        run->bytes += corpus->lengths[idx];
+    }
+    if (ok) {
+        yurei_parser_pool_stop(&pool);
+    }
+    bench_stop(run);
+
+    yurei_sharded_queue_close(&queue);
+    pthread_join(drainer, NULL);
+    yurei_sharded_queue_destroy(&queue);
+    return ok;
+}
+
+static void run_corpus(BenchContext *ctx,
+                       const YureiPipeline *pipeline,
+                       const char *name,
+                       const char *file,
+                       BenchFn fn,
+                       bool force_fallback) {
+    if (!bench_selected(ctx, name)) {
+        return;
+    }
+    Corpus corpus;
+    if (!load_corpus(ctx->corpus_dir, file, &corpus)) {
+        free_corpus(&corpus);
+        return;
+    }
+    if (force_fallback) {
+        escape_payload_lines(&corpus);
+    }
+    ParserBench bench = {&corpus, &ctx->config, pipeline};
+    bench_case(ctx, name, fn, &bench, 0);
+    free_corpus(&corpus);
+}
+
+void bench_parser(BenchContext *ctx) {
+    YureiShardedQueue queue;
+    if (yurei_sharded_queue_init(&queue, 1, PARSER_QUEUE_CAPACITY) != 0) {
+        YUREI_LOG_ERROR("Unable to initialize parser bench queue");
+        return;
+    }
+    // No dedup, metrics or spill: the cases measure the parser alone
+    YureiPipeline pipeline = {.queue = &queue};
+    run_corpus(ctx, &pipeline, "parser/logs_notification", "logs_notifications.jsonl",
+               run_parser, false);
+    run_corpus(ctx, &pipeline, "parser/get_logs", "get_logs.jsonl", run_parser, false);
+    run_corpus(ctx, &pipeline, "parser/logs_notification_cjson", "logs_notifications.jsonl",
+               run_parser, true);
+    run_corpus(ctx, &pipeline, "parser/pool/logs_notification", "logs_notifications.jsonl",
+               run_parser_pool, false);
+    yurei_sharded_queue_destroy(&queue);
+}
@@ -0,0 +1,175 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "bench.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dedup_cache.h"
+#include "event_queue.h"
+#include "metrics.h"
+#include "sharded_queue.h"
+
+#define QUEUE_BENCH_CAPACITY 1024
+#define QUEUE_BENCH_POP_BATCH 256
+#define QUEUE_BENCH_MAX_PRODUCERS 8
+#define DEDUP_BENCH_ENTRIES 262144
+#define DEDUP_BENCH_WINDOW_SLOTS 300
+// Distinct keys cycled through by the duplicate case
+#define DEDUP_BENCH_HOT_KEYS 4096
+
+typedef struct {
+    size_t producers;
+} QueueBench;
+
+typedef struct {
+    YureiEventQueue *queue;
+    _Atomic bool *go;
+    uint64_t count;
+    uint64_t first_slot;
+} ProducerArgs;
+
+static void *producer_thread(void *arg) {
+    ProducerArgs *args = arg;
+    YureiEvent event;
+    memset(&event, 0, sizeof(event));
+    event.kind = 0;
+    while (!atomic_load_explicit(args->go, memory_order_acquire)) {
+    }
+    for (uint64_t i = 0; i < args->count; ++i) {
+        event.slot = args->first_slot + i;
+        if (yurei_queue_push(args->queue, &event) != 0) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+// One op is one event pushed by some producer and popped by the single
+// consumer, mirroring the parser -> DB writer hand-off.
+static bool run_push_pop(const void *arg, BenchRun *run) {
+    const QueueBench *bench = arg;
+    YureiEventQueue queue;
+    if (yurei_queue_init(&queue, QUEUE_BENCH_CAPACITY) != 0) {
+        return false;
+    }
+
+    _Atomic bool go = false;
+    pthread_t threads[QUEUE_BENCH_MAX_PRODUCERS];
+    ProducerArgs args[QUEUE_BENCH_MAX_PRODUCERS];
+    uint64_t per_producer = run->iters / bench->producers + 1;
+    size_t started = 0;
+    for (size_t p = 0; p < bench->producers; ++p) {
+        args[p] = (ProducerArgs){&queue, &go, per_producer, p * per_producer};
+        if (pthread_create(&threads[p], NULL, producer_thread, &args[p]) != 0) {
+            break;
+        }
+        started++;
+    }
+    uint64_t expected = per_producer * started;
+
+    YureiEvent events[QUEUE_BENCH_POP_BATCH];
+    uint64_t popped = 0;
+    bench_start(run);
+    atomic_store_explicit(&go, true, memory_order_release);
+    while (popped < expected) {
+        int n = yurei_queue_pop_batch(&queue, events, QUEUE_BENCH_POP_BATCH,
+                                      YUREI_QUEUE_WAIT_FOREVER);
+        if (n < 0) {
+            break;
+        }
+        popped += (uint64_t)n;
+    }
+    bench_stop(run);
+
+    yurei_queue_close(&queue);
+    for (size_t p = 0; p < started; ++p) {
+        pthread_join(threads[p], NULL);
+    }
+    yurei_queue_destroy(&queue);
+
+    run->iters = expected;
+    run->events = popped;
+    return started == bench->producers && popped == expected;
+}
+
+typedef struct {
+    bool duplicates;
+} DedupBench;
+
+// The parser's sequence: look the key up, and record it once the event is
+// enqueued (always, here)
+static bool dedup_seen(YureiDedupCache *cache, uint64_t sig_hash, uint32_t log_index) {
+    if (yurei_dedup_contains(cache, sig_hash, log_index)) {
+        return true;
+    }
+    yurei_dedup_insert(cache, sig_hash, log_index);
+    return false;
+}
+
+// One op is one (signature, log index) lookup; the unique case inserts a
+// fresh key per op, evicting the oldest once the table is full, the
+// duplicate case replays a small hot set that is always found.
+static bool run_dedup(const void *arg, BenchRun *run) {
+    const DedupBench *bench = arg;
+    YureiDedupCache cache;
+    if (yurei_dedup_init(&cache, DEDUP_BENCH_ENTRIES, DEDUP_BENCH_WINDOW_SLOTS) != 0) {
+        return false;
+    }
+    uint64_t base = yurei_signature_hash("5VERv8NMvzbJMEkV8xnrLkEaWRtSz9CosKDYjCJjBRnb");
+    if (bench->duplicates) {
+        for (uint64_t i = 0; i < DEDUP_BENCH_HOT_KEYS; ++i) {
+            dedup_seen(&cache, base + i, 0);
+        }
+    }
+    uint64_t found = 0;
+    bench_start(run);
+    for (uint64_t i = 0; i < run->iters; ++i) {
+        if (bench->duplicates) {
+            found += dedup_seen(&cache, base + (i % DEDUP_BENCH_HOT_KEYS), 0);
+        } else {
+            found += dedup_seen(&cache, base + i, (uint32_t)(i & 7));
+        }
+    }
+    bench_stop(run);
+    yurei_dedup_destroy(&cache);
+    run->events = run->iters;
+    return bench->duplicates ? found == run->iters : found == 0;
+}
+
+// One op is one stage latency recorded into the calling thread's histogram,
+// with values spread over several decades like real stage timings
+static bool run_metrics_record(const void *arg, BenchRun *run) {
+    (void)arg;
+    YureiMetrics metrics;
+    yurei_metrics_init(&metrics);
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    bench_start(run);
+    for (uint64_t i = 0; i < run->iters; ++i) {
+        uint64_t latency = bench_rand(&seed) >> (40 + (i & 15));
+        yurei_metrics_record(&metrics, YUREI_STAGE_QUEUE_WAIT, latency);
+    }
+    bench_stop(run);
+    YureiHistogramSnapshot snapshot;
+    yurei_metrics_snapshot(&metrics, YUREI_STAGE_QUEUE_WAIT, &snapshot);
+    yurei_metrics_destroy(&metrics);
+    run->events = run->iters;
+    return snapshot.count == run->iters;
+}
+
+void bench_queue(BenchContext *ctx) {
+    static const QueueBench cases[] = {{1}, {2}, {4}};
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "queue/push_pop/%zup1c", cases[i].producers);
+        bench_case(ctx, name, run_push_pop, &cases[i], 0);
+    }
+    static const DedupBench unique = {false};
+    static const DedupBench duplicates = {true};
+    bench_case(ctx, "dedup/check/unique", run_dedup, &unique, 0);
+    bench_case(ctx, "dedup/check/duplicate", run_dedup, &duplicates, 0);
+    bench_case(ctx, "metrics/record", run_metrics_record, NULL, 0);
+}
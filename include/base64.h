@@ -0,0 +1,42 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_BASE64_H
+#define YUREI_BASE64_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Vector kernels store a full register per step; callers that size output
+// buffers with this much slack let the whole input take the vector path.
+#define YUREI_BASE64_SIMD_SLACK 32
+
+typedef enum {
+    YUREI_BASE64_SCALAR = 0,
+    YUREI_BASE64_SSE41,
+    YUREI_BASE64_AVX2
+} YureiBase64Impl;
+
+// Upper bound on decoded bytes for len input characters
+size_t yurei_base64_decoded_max(size_t len);
+
+// Decode standard (RFC 4648) base64. Space-separated chunks, as emitted by
+// sol_log_data, are each decoded (with their own padding) and concatenated.
+// Returns false on any character outside the alphabet, malformed padding, or
+// if the output would exceed out_cap.
+bool yurei_base64_decode(const char *input,
+                         size_t len,
+                         uint8_t *output,
+                         size_t out_cap,
+                         size_t *out_len);
+
+// Implementation chosen by CPU dispatch at load time
+YureiBase64Impl yurei_base64_active_impl(void);
+const char *yurei_base64_impl_name(YureiBase64Impl impl);
+
+// Override the dispatched implementation (benchmarks); returns false if the
+// CPU does not support it
+bool yurei_base64_select(YureiBase64Impl impl);
+
+#endif // YUREI_BASE64_H
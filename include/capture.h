@@ -0,0 +1,61 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_CAPTURE_H
+#define YUREI_CAPTURE_H
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "pipeline.h"
+
+typedef enum {
+    YUREI_CAPTURE_WS = 0,    // one complete WebSocket message
+    YUREI_CAPTURE_HTTP = 1,  // one HTTP response body (a JSON-RPC batch)
+} YureiCaptureSource;
+
+// Recorder for raw RPC traffic. The file is a 16-byte header ("YUREICP1",
+// wall-clock start in ns) followed by records of a 16-byte header (offset
+// from the start in ns, length, source) and the bytes as received, in host
+// byte order. Writes are buffered and serialized by a mutex, so the WebSocket
+// and HTTP threads can share one capture.
+typedef struct YureiCapture {
+    FILE *file;
+    pthread_mutex_t lock;
+    uint64_t start_ns;  // monotonic time of the first byte recorded
+    uint64_t records;
+    uint64_t bytes;
+    bool failed;        // a write failed; recording stopped
+} YureiCapture;
+
+typedef struct {
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t events;
+    uint64_t elapsed_ns;
+} YureiReplayStats;
+
+int yurei_capture_open(YureiCapture *capture, const char *path);
+void yurei_capture_record(YureiCapture *capture,
+                          YureiCaptureSource source,
+                          const char *data,
+                          size_t len);
+void yurei_capture_close(YureiCapture *capture);
+
+// Feed a capture through the parser into the pipeline on the calling thread: at the
+// recorded pacing when paced is true, otherwise as fast as the queue accepts.
+// HTTP responses are split into their calls as the poller does. Returns early
+// once *stop becomes non-zero.
+int yurei_capture_replay(const char *path,
+                         const YureiConfig *config,
+                         const YureiPipeline *pipeline,
+                         bool paced,
+                         const volatile sig_atomic_t *stop,
+                         YureiReplayStats *stats);
+
+#endif // YUREI_CAPTURE_H
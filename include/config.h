@@ -8,26 +8,67 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "program_registry.h"
+
 #define YUREI_RPC_MODE_WS "ws"
 #define YUREI_RPC_MODE_HTTP "http"
 #define YUREI_RPC_MODE_DUAL "dual"
+// No network: feed YUREI_REPLAY_FILE through the pipeline, then exit
+#define YUREI_RPC_MODE_REPLAY "replay"
+
+#define YUREI_REPLAY_PACE_ORIGINAL "original"
+#define YUREI_REPLAY_PACE_MAX "max"
+
+#define YUREI_DB_MODE_INSERT "insert"
+#define YUREI_DB_MODE_COPY "copy"
+// Pop and release events without a database, for load tests
+#define YUREI_DB_MODE_DISCARD "discard"
+
+#define YUREI_DB_WRITERS_MAX 64
+#define YUREI_HTTP_INFLIGHT_MAX 64
+// Longest .env line / value, sized for a YUREI_PROGRAMS list
+#define YUREI_CONFIG_LINE_MAX 4096
 
 typedef struct {
     char rpc_endpoint[256];
-    char wss_endpoint[256];
+    char wss_endpoint[1024];  // one URL, or several separated by commas to hedge
     char rpc_api_key[128];
     char rpc_mode[16];
     uint32_t poll_interval_ms;
+    uint32_t http_max_inflight;
+    uint32_t http_slot_span;
+    uint64_t http_start_slot;
     uint32_t ws_backoff_ms;
     uint32_t ws_backoff_max_ms;
+    uint32_t ws_hedge_window_ms;
     size_t queue_capacity;
     uint32_t batch_size;
+    uint32_t db_linger_ms;
+    char db_write_mode[16];
+    uint32_t db_merge_interval_ms;
+    uint32_t db_writers;
+    bool db_received_at;  // also write each event's receive time to received_at
+    char spill_dir[256];      // empty disables the on-disk overflow
+    uint64_t spill_max_bytes;  // across all shards; 0 = unlimited
+    uint32_t parser_threads;
+    size_t parser_buffer_bytes;
+    bool parser_drop_when_full;  // drop WebSocket messages instead of stalling the socket
+    size_t dedup_entries;
+    uint32_t dedup_window_slots;
     uint32_t rate_limit_rps;
+    char capture_file[256];  // record raw RPC traffic here; empty disables
+    char replay_file[256];   // capture fed through the pipeline in replay mode
+    char replay_pace[16];
+    uint32_t metrics_port;  // 0 disables the metrics endpoint
+    char metrics_bind[64];
     bool log_color;
     char pumpfun_program[64];
     char raydium_program[64];
     char pumpfun_table[64];
     char raydium_table[64];
+    // YUREI_PROGRAMS as given; the legacy PumpFun/Raydium keys apply when empty
+    char programs_spec[YUREI_CONFIG_LINE_MAX];
+    YureiProgramRegistry programs;
     char pg_conninfo[512];
     char log_level[16];
 } YureiConfig;
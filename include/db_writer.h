@@ -5,21 +5,42 @@
 #define YUREI_DB_WRITER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <pthread.h>
 
 #include "config.h"
-#include "event_queue.h"
+#include "pipeline.h"
 
+// One writer thread with its own connection, draining one queue shard
 typedef struct {
-    bool running;
     pthread_t thread;
+    size_t index;
     const YureiConfig *config;
     YureiEventQueue *queue;
+    YureiMetrics *metrics;
+    YureiSpillQueue *spill;  // optional overflow for this shard
+    uint64_t tables;         // registry tables found on the current connection, by index
+    // Spill records the server rejected: attempts so far, records left to
+    // retry one at a time, and when the next attempt is due
+    uint32_t replay_failures;
+    size_t replay_isolating;
+    uint64_t replay_at_ms;
+} YureiDbShard;
+
+typedef struct {
+    bool running;
+    YureiDbShard *shards;
+    size_t shard_count;
 } YureiDbWriter;
 
+// Start one writer per shard of the pipeline's queue, each replaying that
+// shard's spill. On failure the queue has been closed.
 int yurei_db_writer_start(YureiDbWriter *writer,
                           const YureiConfig *config,
-                          YureiEventQueue *queue);
+                          const YureiPipeline *pipeline);
+// Close the queue first: each writer drains its shard, then exits. Records
+// still in a shard's spill stay on disk for the next run.
 void yurei_db_writer_stop(YureiDbWriter *writer);
 
 #endif // YUREI_DB_WRITER_H
@@ -0,0 +1,54 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_DEDUP_CACHE_H
+#define YUREI_DEDUP_CACHE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_queue.h"
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} YureiDedupStats;
+
+// Bounded, time-windowed set of recently enqueued (signature, log index)
+// keys, so events seen again (dual mode, overlapping getLogs ranges) are
+// dropped before they cost a queue slot and a DB round-trip.
+//
+// Open addressing with short linear probes over 64-bit words that pack a
+// 48-bit key fingerprint with a 16-bit epoch: the coarse monotonic time of
+// insertion divided by the window. Keys age by when they were recorded, not
+// by their event's slot, so a backfill far behind the tip is remembered as
+// long as live traffic. Entries more than one epoch old are free for reuse,
+// so the table needs no clearing. Lock-free: concurrent copies of the same
+// key may both miss before either is inserted, which only lets a duplicate
+// through to ON CONFLICT.
+typedef struct {
+    _Atomic uint64_t *entries;
+    size_t mask;
+    uint64_t window_ns;
+    _Alignas(YUREI_CACHE_LINE) _Atomic uint64_t hits;
+    _Atomic uint64_t misses;
+    _Atomic uint64_t evictions;
+} YureiDedupCache;
+
+// entries is rounded up to a power of two. The window is window_slots slot
+// times (400 ms each); 0 means 1.
+int yurei_dedup_init(YureiDedupCache *cache, size_t entries, uint64_t window_slots);
+void yurei_dedup_destroy(YureiDedupCache *cache);
+// True if the key was recorded within the window (a duplicate). sig_hash is
+// yurei_signature_hash. Lookup only: record the key with yurei_dedup_insert
+// once the event is actually enqueued, so a failed enqueue does not turn
+// later copies into duplicates.
+bool yurei_dedup_contains(YureiDedupCache *cache, uint64_t sig_hash, uint32_t log_index);
+void yurei_dedup_insert(YureiDedupCache *cache, uint64_t sig_hash, uint32_t log_index);
+void yurei_dedup_stats(const YureiDedupCache *cache, YureiDedupStats *out);
+void yurei_dedup_log(const YureiDedupCache *cache);
+
+#endif // YUREI_DEDUP_CACHE_H
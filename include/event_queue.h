@@ -4,44 +4,93 @@
 #ifndef YUREI_EVENT_QUEUE_H
 #define YUREI_EVENT_QUEUE_H
 
-#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
-#define YUREI_EVENT_PAYLOAD_MAX 4096
+#include "payload_slab.h"
 
-typedef enum {
-    YUREI_EVENT_KIND_UNKNOWN = 0,
-    YUREI_EVENT_KIND_PUMPFUN,
-    YUREI_EVENT_KIND_RAYDIUM
-} YureiEventKind;
+#define YUREI_EVENT_PAYLOAD_MAX YUREI_SLAB_MAX_BLOCK
+// Base58 program IDs are at most 44 characters, signatures at most 88
+#define YUREI_PROGRAM_ID_MAX 48
+#define YUREI_SIGNATURE_MAX 96
 
+// Index of the event's program in the registry (config->programs)
+typedef uint16_t YureiEventKind;
+#define YUREI_EVENT_KIND_UNKNOWN UINT16_MAX
+
+// Compact event header. The payload lives in the queue's slab and only the
+// pointer travels through the ring; whoever pops an event owns its payload
+// and must hand it back with yurei_event_release.
+//
+// The *_ns fields trace the event through the pipeline in CLOCK_MONOTONIC
+// nanoseconds; 0 means not taken (no metrics, or lost with a spill).
 typedef struct {
     YureiEventKind kind;
-    char program_id[64];
-    char signature[128];
     uint64_t slot;
-    uint8_t data[YUREI_EVENT_PAYLOAD_MAX];
+    uint64_t received_ns;  // frame or HTTP response carrying the event arrived
+    uint64_t parsed_ns;    // payload decoded
+    uint64_t enqueued_ns;  // published on its shard; the push sets it if nonzero
+    uint64_t dequeued_ns;  // popped by a DB writer
+    uint8_t *data;
     size_t data_len;
+    size_t data_cap;
+    char program_id[YUREI_PROGRAM_ID_MAX];
+    char signature[YUREI_SIGNATURE_MAX];
 } YureiEvent;
 
+#define YUREI_CACHE_LINE 64
+// Timeout value for yurei_queue_pop_batch that waits indefinitely
+#define YUREI_QUEUE_WAIT_FOREVER UINT32_MAX
+
+// Ring cell: sequence == position means free for the producer claiming that
+// position, sequence == position + 1 means published for the consumer.
 typedef struct {
-    YureiEvent *buffer;
+    _Atomic size_t sequence;
+    YureiEvent event;
+} YureiQueueCell;
+
+// Bounded lock-free multi-producer/multi-consumer ring. Producer and consumer
+// cursors sit on their own cache lines; threads only sleep on a futex word
+// when the ring is full (push) or empty (pop).
+typedef struct {
+    _Alignas(YUREI_CACHE_LINE) _Atomic size_t tail;
+    _Alignas(YUREI_CACHE_LINE) _Atomic size_t head;
+    _Alignas(YUREI_CACHE_LINE) _Atomic uint32_t not_empty;
+    _Atomic uint32_t pop_waiters;
+    _Alignas(YUREI_CACHE_LINE) _Atomic uint32_t not_full;
+    _Atomic uint32_t push_waiters;
+    _Alignas(YUREI_CACHE_LINE) YureiQueueCell *cells;
     size_t capacity;
-    size_t head;
-    size_t tail;
-    size_t size;
-    bool closed;
-    pthread_mutex_t mutex;
-    pthread_cond_t cond_push;
-    pthread_cond_t cond_pop;
+    size_t mask;
+    _Atomic bool closed;
+    YureiPayloadSlab slab;
 } YureiEventQueue;
 
+// Capacity is rounded up to the next power of two
 int yurei_queue_init(YureiEventQueue *queue, size_t capacity);
 void yurei_queue_destroy(YureiEventQueue *queue);
 int yurei_queue_push(YureiEventQueue *queue, const YureiEvent *event);
-int yurei_queue_pop(YureiEventQueue *queue, YureiEvent *event);
+// Non-blocking push: -1 if the ring is full or closed
+int yurei_queue_try_push(YureiEventQueue *queue, const YureiEvent *event);
+// Push all events, blocking while full; returns how many were pushed (< count only once closed)
+size_t yurei_queue_push_batch(YureiEventQueue *queue, const YureiEvent *events, size_t count);
+// Non-blocking: claim up to max contiguous published events; returns how many
+size_t yurei_queue_try_pop_batch(YureiEventQueue *queue, YureiEvent *events, size_t max);
+// Wait up to timeout_ms for events, then claim up to max contiguous ones in a
+// single CAS. Returns the count (0 on timeout), or -1 once closed and drained.
+int yurei_queue_pop_batch(YureiEventQueue *queue,
+                          YureiEvent *events,
+                          size_t max,
+                          uint32_t timeout_ms);
 void yurei_queue_close(YureiEventQueue *queue);
+// Events pushed but not yet popped; approximate while producers are active
+size_t yurei_queue_depth(YureiEventQueue *queue);
+
+// Attach a slab payload of at least len bytes to event (len <= YUREI_EVENT_PAYLOAD_MAX)
+int yurei_event_payload_alloc(YureiEventQueue *queue, YureiEvent *event, size_t len);
+// Return an event's payload to the queue's slab
+void yurei_event_release(YureiEventQueue *queue, YureiEvent *event);
 
 #endif // YUREI_EVENT_QUEUE_H
@@ -0,0 +1,38 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_FUTEX_H
+#define YUREI_FUTEX_H
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Thin wrappers over the Linux futex syscall for the lock-free rings' sleep paths
+
+static inline void yurei_futex_wait(_Atomic uint32_t *word,
+                                    uint32_t expected,
+                                    const struct timespec *timeout) {
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+}
+
+static inline void yurei_futex_wake_all(_Atomic uint32_t *word) {
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+// Wake sleepers on word only if any registered; the fence orders the
+// preceding publish against the waiter count load. Waiters must increment
+// waiters (seq_cst) before re-checking their condition and sleeping.
+static inline void yurei_futex_notify(_Atomic uint32_t *word, _Atomic uint32_t *waiters) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiters, memory_order_relaxed) > 0) {
+        atomic_fetch_add_explicit(word, 1, memory_order_release);
+        yurei_futex_wake_all(word);
+    }
+}
+
+#endif // YUREI_FUTEX_H
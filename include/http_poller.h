@@ -9,24 +9,24 @@
 #include <pthread.h>
 
 #include "config.h"
-#include "event_queue.h"
 #include "metrics.h"
+#include "pipeline.h"
 #include "rate_limiter.h"
 
 typedef struct {
     bool running;
     pthread_t thread;
     const YureiConfig *config;
-    YureiEventQueue *queue;
-    YureiMetrics *metrics;
+    const YureiPipeline *pipeline;
+    YureiMetrics *metrics;  // the pipeline's
     YureiRateLimiter *rate_limiter;
-    uint64_t last_slot;
+    uint64_t last_slot;  // highest slot an event was enqueued from
+    uint64_t tip_slot;   // latest confirmed slot reported by getSlot
 } YureiHttpPoller;
 
 int yurei_http_poller_start(YureiHttpPoller *poller,
                             const YureiConfig *config,
-                            YureiEventQueue *queue,
-                            YureiMetrics *metrics,
+                            const YureiPipeline *pipeline,
                             YureiRateLimiter *rate_limiter);
 void yurei_http_poller_stop(YureiHttpPoller *poller);
 
@@ -0,0 +1,60 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_JSON_SCAN_H
+#define YUREI_JSON_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal in-place JSON scanner. Nothing is allocated or copied: strings are
+// returned as slices of the input with escapes left undecoded.
+
+typedef struct {
+    const char *ptr;
+    size_t len;
+    bool escaped;  // slice contains backslash escapes
+} YureiJsonSlice;
+
+typedef struct {
+    const char *begin;
+    const char *cur;
+    const char *end;
+} YureiJsonScanner;
+
+typedef enum {
+    YUREI_JSON_NONE = 0,
+    YUREI_JSON_OBJECT,
+    YUREI_JSON_ARRAY,
+    YUREI_JSON_STRING,
+    YUREI_JSON_NUMBER,
+    YUREI_JSON_LITERAL
+} YureiJsonType;
+
+void yurei_json_init(YureiJsonScanner *sc, const char *json, size_t len);
+
+// Type of the next value without consuming it
+YureiJsonType yurei_json_peek(YureiJsonScanner *sc);
+
+bool yurei_json_skip_value(YureiJsonScanner *sc);
+bool yurei_json_string(YureiJsonScanner *sc, YureiJsonSlice *out);
+// Integer part of a number; any fraction/exponent is consumed and ignored
+bool yurei_json_uint64(YureiJsonScanner *sc, uint64_t *out);
+
+// Object iteration: call _begin, then _next until it returns 0 (end) or -1
+// (error). On 1 the scanner is positioned at the member value, which the
+// caller must consume.
+bool yurei_json_object_begin(YureiJsonScanner *sc);
+int yurei_json_object_next(YureiJsonScanner *sc, YureiJsonSlice *key);
+
+// Array iteration: same protocol; on 1 the scanner is positioned at an element
+bool yurei_json_array_begin(YureiJsonScanner *sc);
+int yurei_json_array_next(YureiJsonScanner *sc);
+
+bool yurei_json_slice_equals(const YureiJsonSlice *slice, const char *literal);
+
+// True once only whitespace remains
+bool yurei_json_at_end(YureiJsonScanner *sc);
+
+#endif // YUREI_JSON_SCAN_H
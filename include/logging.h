@@ -6,6 +6,8 @@
 
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
 
 typedef enum {
     YUREI_LOG_TRACE = 0,
@@ -15,14 +17,90 @@ typedef enum {
     YUREI_LOG_ERROR
 } YureiLogLevel;
 
+// Lowest level compiled into the binary (0 = trace ... 4 = error). Calls
+// below it, arguments included, are removed by the compiler; the CMake cache
+// variable YUREI_LOG_COMPILE_LEVEL sets it for the project targets.
+#ifndef YUREI_LOG_COMPILE_LEVEL
+#define YUREI_LOG_COMPILE_LEVEL 0
+#endif
+
+// Rate-limited call sites log at most this many lines per interval each
+#define YUREI_LOG_SITE_BURST 5
+#define YUREI_LOG_SITE_INTERVAL_MS 1000
+
+// Runtime threshold, read inline so disabled levels cost one compare
+extern YureiLogLevel yurei_log_threshold;
+
+#define YUREI_LOG_ENABLED(level) \
+    ((int)(level) >= YUREI_LOG_COMPILE_LEVEL && (level) >= yurei_log_threshold)
+
+// Per-call-site limiter state; one static instance per YUREI_LOG_*_LIMITED use
+typedef struct YureiLogSite {
+    _Atomic uint64_t window_ns;
+    _Atomic uint32_t emitted;
+    _Atomic uint64_t suppressed;
+    // Identifies the site in the summary the flusher writes once it goes quiet
+    YureiLogLevel severity;
+    const char *file;
+    int line;
+    const char *format;
+    _Atomic bool registered;
+    struct YureiLogSite *next;  // flusher's list, joined on the first suppressed line
+} YureiLogSite;
+
 void yurei_log_set_level(YureiLogLevel level);
 void yurei_log_set_color(bool enabled);
-void yurei_log(YureiLogLevel level, const char *fmt, ...);
+void yurei_log(YureiLogLevel level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// Admit one line at a site: 0 if over its budget for the current interval,
+// otherwise 1 + the number of lines suppressed there since the last one.
+uint64_t yurei_log_site_admit(YureiLogSite *site);
+// yurei_log with a "(suppressed N similar messages)" note when N > 0
+void yurei_log_site(YureiLogLevel level, uint64_t suppressed, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+// Lines held back by rate-limited sites since startup
+uint64_t yurei_log_suppressed(void);
+
+// Hand stderr to a background flusher. Each thread then formats into its own
+// lock-free ring and never waits on the terminal; a line that does not fit
+// in a full ring is dropped and counted. Until started (and after stop) lines
+// are written synchronously.
+int yurei_log_start(void);
+// Drain every ring and join the flusher
+void yurei_log_stop(void);
+// Lines dropped because their thread's ring was full
+uint64_t yurei_log_dropped(void);
+
+#define YUREI_LOG_AT(level, fmt, ...)                    \
+    do {                                                 \
+        if (YUREI_LOG_ENABLED(level)) {                  \
+            yurei_log((level), fmt, ##__VA_ARGS__);      \
+        }                                                \
+    } while (0)
+
+// For sites that can fire per event or per request during an incident: at
+// most YUREI_LOG_SITE_BURST lines per interval, then one line noting how many
+// were suppressed once the next interval admits it, or from the flusher once
+// an interval passes without the site firing.
+#define YUREI_LOG_LIMITED(level, fmt, ...)                                    \
+    do {                                                                      \
+        static YureiLogSite yurei_log_site_ = {                               \
+            .severity = (level), .file = __FILE__, .line = __LINE__, .format = (fmt)}; \
+        if (YUREI_LOG_ENABLED(level)) {                                       \
+            uint64_t yurei_log_admit_ = yurei_log_site_admit(&yurei_log_site_); \
+            if (yurei_log_admit_) {                                           \
+                yurei_log_site((level), yurei_log_admit_ - 1, fmt, ##__VA_ARGS__); \
+            }                                                                 \
+        }                                                                     \
+    } while (0)
+
+#define YUREI_LOG_TRACE(fmt, ...) YUREI_LOG_AT(YUREI_LOG_TRACE, fmt, ##__VA_ARGS__)
+#define YUREI_LOG_DEBUG(fmt, ...) YUREI_LOG_AT(YUREI_LOG_DEBUG, fmt, ##__VA_ARGS__)
+#define YUREI_LOG_INFO(fmt, ...) YUREI_LOG_AT(YUREI_LOG_INFO, fmt, ##__VA_ARGS__)
+#define YUREI_LOG_WARN(fmt, ...) YUREI_LOG_AT(YUREI_LOG_WARN, fmt, ##__VA_ARGS__)
+#define YUREI_LOG_ERROR(fmt, ...) YUREI_LOG_AT(YUREI_LOG_ERROR, fmt, ##__VA_ARGS__)
 
-#define YUREI_LOG_TRACE(fmt, ...) yurei_log(YUREI_LOG_TRACE, fmt, ##__VA_ARGS__)
-#define YUREI_LOG_DEBUG(fmt, ...) yurei_log(YUREI_LOG_DEBUG, fmt, ##__VA_ARGS__)
-#define YUREI_LOG_INFO(fmt, ...) yurei_log(YUREI_LOG_INFO, fmt, ##__VA_ARGS__)
-#define YUREI_LOG_WARN(fmt, ...) yurei_log(YUREI_LOG_WARN, fmt, ##__VA_ARGS__)
-#define YUREI_LOG_ERROR(fmt, ...) yurei_log(YUREI_LOG_ERROR, fmt, ##__VA_ARGS__)
+#define YUREI_LOG_WARN_LIMITED(fmt, ...) YUREI_LOG_LIMITED(YUREI_LOG_WARN, fmt, ##__VA_ARGS__)
+#define YUREI_LOG_ERROR_LIMITED(fmt, ...) YUREI_LOG_LIMITED(YUREI_LOG_ERROR, fmt, ##__VA_ARGS__)
 
 #endif // YUREI_LOGGING_H
@@ -0,0 +1,68 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_MESSAGE_RING_H
+#define YUREI_MESSAGE_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_queue.h"
+
+// Descriptor of one message. Plain fields are written by the producer before
+// publishing and only read by the consumer that claimed the slot.
+typedef struct {
+    const char *data;
+    size_t len;
+    uint64_t end;  // byte cursor just past the record, for reclaim
+    uint64_t received_ns;  // producer's receive timestamp, 0 if untracked
+    bool heap;  // data is a malloc'd copy of an oversized message, freed when done
+    _Atomic uint32_t done;
+} YureiMessage;
+
+// Single-producer, multi-consumer ring of raw messages. Bytes are copied
+// into a power-of-two buffer and described by a slot in a parallel ring of
+// descriptors; consumers claim slots in order with a CAS on read, parse the
+// bytes in place (possibly out of order) and mark each slot done. The
+// producer reclaims space only up to the first slot still in use; when that
+// leaves no room it either gives up on the message or sleeps until a
+// consumer marks a slot done.
+typedef struct {
+    _Alignas(YUREI_CACHE_LINE) _Atomic uint64_t write;  // next slot to publish
+    uint64_t write_pos;  // producer-only byte cursors
+    uint64_t reclaim;
+    uint64_t reclaim_pos;
+    _Alignas(YUREI_CACHE_LINE) _Atomic uint64_t read;
+    _Alignas(YUREI_CACHE_LINE) _Atomic uint32_t not_empty;
+    _Atomic uint32_t waiters;
+    _Alignas(YUREI_CACHE_LINE) _Atomic uint32_t not_full;
+    _Atomic uint32_t full_waiters;
+    _Alignas(YUREI_CACHE_LINE) char *buffer;
+    size_t capacity;
+    size_t mask;
+    YureiMessage *slots;
+    size_t slot_mask;
+    _Atomic bool closed;
+} YureiMessageRing;
+
+// Capacity is rounded up to a power of two (at least 64 KiB)
+int yurei_message_ring_init(YureiMessageRing *ring, size_t capacity);
+void yurei_message_ring_destroy(YureiMessageRing *ring);
+// Largest message copied into the buffer; bigger ones get a heap copy of
+// their own and only take a descriptor slot
+size_t yurei_message_ring_max_message(const YureiMessageRing *ring);
+// Producer only. Copies len bytes in; returns 0, or -1 if the ring is full,
+// closed, or out of memory for an oversized copy. Never blocks.
+int yurei_message_ring_put(YureiMessageRing *ring, const void *data, size_t len, uint64_t received_ns);
+// Producer only. Like yurei_message_ring_put, but a full ring makes it wait
+// for consumers instead; returns -1 only once closed or out of memory.
+int yurei_message_ring_put_wait(YureiMessageRing *ring, const void *data, size_t len, uint64_t received_ns);
+// Consumers. Blocks until a message is available; returns NULL once closed
+// and drained. The bytes stay valid until yurei_message_ring_done.
+YureiMessage *yurei_message_ring_take(YureiMessageRing *ring);
+void yurei_message_ring_done(YureiMessageRing *ring, YureiMessage *message);
+void yurei_message_ring_close(YureiMessageRing *ring);
+
+#endif // YUREI_MESSAGE_RING_H
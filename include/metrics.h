@@ -7,23 +7,73 @@
 #include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <time.h>
+
+#include "program_registry.h"
+
+// Pipeline stages with a latency histogram each
+typedef enum {
+    YUREI_STAGE_RECEIVE_TO_PARSE,   // WebSocket receive until a parser picks the message up
+    YUREI_STAGE_PARSE,              // parse start until an event's payload is decoded
+    YUREI_STAGE_PARSE_TO_ENQUEUE,   // decoded until the event is on the queue (backpressure)
+    YUREI_STAGE_QUEUE_WAIT,         // enqueue until a DB writer pops the event
+    YUREI_STAGE_DEQUEUE_TO_COMMIT,  // pop until the event's batch commits, linger included
+    YUREI_STAGE_DB_COMMIT,          // one DB batch, first statement to commit
+    YUREI_STAGE_END_TO_END,         // frame receipt until the event is committed
+    YUREI_STAGE_RPC_REQUEST,        // one HTTP JSON-RPC request, send to reply
+    YUREI_STAGE_COUNT
+} YureiStage;
+
+// Log-linear (HDR-style) buckets: exact below 2^SUB_BITS ns, then
+// 2^SUB_BITS buckets per power of two, so any recorded value is off by at
+// most 1/2^SUB_BITS (about 6%). Values are clamped to 2^MAX_BITS ns (~18 min).
+#define YUREI_HIST_SUB_BITS 4
+#define YUREI_HIST_MAX_BITS 40
+#define YUREI_HIST_BUCKETS (((YUREI_HIST_MAX_BITS - YUREI_HIST_SUB_BITS) + 1) << YUREI_HIST_SUB_BITS)
+
+// Written only by its owning thread, so recording is plain relaxed
+// load/store with no locked instructions; readers sum all threads' copies.
+typedef struct {
+    _Atomic uint64_t counts[YUREI_HIST_BUCKETS];
+    _Atomic uint64_t sum_ns;
+    _Atomic uint64_t max_ns;
+} YureiHistogram;
+
+typedef struct YureiMetricsShard YureiMetricsShard;
 
 typedef struct {
     _Atomic uint64_t requests_total;
     _Atomic uint64_t requests_success;
     _Atomic uint64_t requests_failed;
     _Atomic uint64_t events_processed;
-    _Atomic uint64_t latency_sum_us;
-    _Atomic uint64_t latency_count;
-    _Atomic uint64_t latency_min_us;
-    _Atomic uint64_t latency_max_us;
     _Atomic uint64_t bytes_received;
     _Atomic uint64_t ws_reconnects;
+    _Atomic uint64_t truncated_slots;
+    // Per-thread stage histograms, pushed on a thread's first record
+    _Atomic(YureiMetricsShard *) shards;
 } YureiMetrics;
 
+// Merged view of one stage across threads
+typedef struct {
+    uint64_t counts[YUREI_HIST_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+} YureiHistogramSnapshot;
+
+static inline uint64_t yurei_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 // Initialize metrics to zero
 void yurei_metrics_init(YureiMetrics *m);
 
+// Free the per-thread histograms. Every thread that recorded, other than
+// the caller, must have exited.
+void yurei_metrics_destroy(YureiMetrics *m);
+
 // Record a request with latency (in microseconds)
 void yurei_metrics_request(YureiMetrics *m, bool success, uint64_t latency_us);
 
@@ -36,6 +86,35 @@ void yurei_metrics_event(YureiMetrics *m);
 // Record a WebSocket reconnection
 void yurei_metrics_ws_reconnect(YureiMetrics *m);
 
+// Record a slot whose getLogs entries did not fit in the largest page
+void yurei_metrics_truncated_slot(YureiMetrics *m);
+
+// Record one stage latency into the calling thread's histogram
+void yurei_metrics_record(YureiMetrics *m, YureiStage stage, uint64_t latency_ns);
+
+// Count an event enqueued for a registered program (thread-local, like stages)
+void yurei_metrics_program_event(YureiMetrics *m, YureiEventKind kind);
+
+// Events enqueued for a program, summed over threads
+uint64_t yurei_metrics_program_events(const YureiMetrics *m, YureiEventKind kind);
+
+// Record into a histogram only the calling thread writes
+void yurei_histogram_record(YureiHistogram *hist, uint64_t value_ns);
+
+// Add one histogram's counts to a snapshot (zeroed by the caller)
+void yurei_histogram_merge(YureiHistogramSnapshot *out, const YureiHistogram *hist);
+
+// Merge every thread's histogram for a stage
+void yurei_metrics_snapshot(const YureiMetrics *m, YureiStage stage, YureiHistogramSnapshot *out);
+
+// Value at quantile q (0..1) of a snapshot, in nanoseconds
+uint64_t yurei_histogram_quantile(const YureiHistogramSnapshot *snapshot, double q);
+
+// Upper bound of a bucket in nanoseconds
+uint64_t yurei_histogram_bucket_limit(size_t bucket);
+
+const char *yurei_stage_name(YureiStage stage);
+
 // Log current metrics summary
 void yurei_metrics_log(const YureiMetrics *m);
 
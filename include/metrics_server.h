@@ -0,0 +1,45 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_METRICS_SERVER_H
+#define YUREI_METRICS_SERVER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "config.h"
+#include "metrics.h"
+#include "parser_pool.h"
+#include "pipeline.h"
+#include "websocket_client.h"
+
+// Minimal HTTP listener serving GET /metrics in OpenMetrics text format.
+// It only reads atomics and per-thread histograms, never logs per scrape,
+// and serves one connection at a time on its own thread, so a slow or
+// stuck scraper cannot hold up the pipeline.
+typedef struct {
+    bool running;
+    pthread_t thread;
+    int listen_fd;
+    _Atomic bool stop;
+    const YureiConfig *config;
+    const YureiPipeline *pipeline;
+    const YureiMetrics *metrics;  // the pipeline's
+    YureiParserPool *parsers;  // optional; NULL when the WebSocket path is off
+    const YureiWebsocketClient *ws;  // likewise
+    char *body;  // response buffer, reused across scrapes
+    size_t body_len;
+    size_t body_cap;
+} YureiMetricsServer;
+
+// No-op returning 0 when config->metrics_port is 0
+int yurei_metrics_server_start(YureiMetricsServer *server,
+                               const YureiConfig *config,
+                               const YureiPipeline *pipeline,
+                               YureiParserPool *parsers,
+                               const YureiWebsocketClient *ws);
+void yurei_metrics_server_stop(YureiMetricsServer *server);
+
+#endif // YUREI_METRICS_SERVER_H
@@ -8,11 +8,27 @@
 #include <stdint.h>
 
 #include "config.h"
-#include "event_queue.h"
+#include "pipeline.h"
 
 int yurei_parser_handle_message(const char *json,
                                 const YureiConfig *config,
-                                YureiEventQueue *queue,
+                                const YureiPipeline *pipeline,
                                 uint64_t *out_highest_slot);
 
+// Same as yurei_parser_handle_message for a buffer that need not be NUL-terminated
+int yurei_parser_handle_buffer(const char *json,
+                               size_t len,
+                               const YureiConfig *config,
+                               const YureiPipeline *pipeline,
+                               uint64_t *out_highest_slot);
+
+// Same, for a message that arrived at received_ns (CLOCK_MONOTONIC); its events
+// carry that time through the pipeline. 0 means now.
+int yurei_parser_handle_received(const char *json,
+                                 size_t len,
+                                 uint64_t received_ns,
+                                 const YureiConfig *config,
+                                 const YureiPipeline *pipeline,
+                                 uint64_t *out_highest_slot);
+
 #endif // YUREI_PARSER_H
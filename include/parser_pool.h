@@ -0,0 +1,39 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_PARSER_POOL_H
+#define YUREI_PARSER_POOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "message_ring.h"
+#include "pipeline.h"
+
+// Parser threads fed from a raw-message ring, so the network thread only
+// copies bytes and never parses or blocks on the event queue itself
+typedef struct {
+    YureiMessageRing ring;
+    pthread_t *threads;
+    size_t thread_count;
+    const YureiConfig *config;
+    const YureiPipeline *pipeline;
+    _Atomic uint64_t dropped;  // with parser_drop_when_full
+    bool dropping;  // producer-only: inside a burst of drops
+} YureiParserPool;
+
+int yurei_parser_pool_start(YureiParserPool *pool,
+                            const YureiConfig *config,
+                            const YureiPipeline *pipeline);
+// Hand one complete message, whose first frame arrived at received_ns, to the
+// pool. Single producer. While the ring is full this waits for the parsers,
+// or with parser_drop_when_full drops the message and returns -1.
+int yurei_parser_pool_submit(YureiParserPool *pool, const char *data, size_t len, uint64_t received_ns);
+// Parse whatever is buffered, then stop the threads
+void yurei_parser_pool_stop(YureiParserPool *pool);
+
+#endif // YUREI_PARSER_POOL_H
@@ -0,0 +1,47 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_PAYLOAD_SLAB_H
+#define YUREI_PAYLOAD_SLAB_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Power-of-two size classes from 64 bytes up to 4096 bytes
+#define YUREI_SLAB_MIN_SHIFT 6
+#define YUREI_SLAB_MAX_SHIFT 12
+#define YUREI_SLAB_CLASSES (YUREI_SLAB_MAX_SHIFT - YUREI_SLAB_MIN_SHIFT + 1)
+#define YUREI_SLAB_MAX_BLOCK ((size_t)1 << YUREI_SLAB_MAX_SHIFT)
+
+typedef struct YureiSlabBlock YureiSlabBlock;
+typedef struct YureiSlabChunk YureiSlabChunk;
+
+typedef struct {
+    size_t block_size;
+    YureiSlabBlock *free_list;
+    YureiSlabChunk *chunks;
+    size_t blocks_total;
+    pthread_mutex_t mutex;
+} YureiSlabClass;
+
+typedef struct {
+    YureiSlabClass classes[YUREI_SLAB_CLASSES];
+} YureiPayloadSlab;
+
+int yurei_slab_init(YureiPayloadSlab *slab);
+
+// Release every chunk; outstanding blocks become invalid
+void yurei_slab_destroy(YureiPayloadSlab *slab);
+
+// Allocate a block of at least len bytes (len <= YUREI_SLAB_MAX_BLOCK).
+// The usable size is written to *out_cap. Returns NULL on failure.
+uint8_t *yurei_slab_alloc(YureiPayloadSlab *slab, size_t len, size_t *out_cap);
+
+// Return a block obtained from yurei_slab_alloc; cap must be the value it reported
+void yurei_slab_free(YureiPayloadSlab *slab, uint8_t *block, size_t cap);
+
+// Total bytes currently reserved from the system across all classes
+size_t yurei_slab_reserved_bytes(YureiPayloadSlab *slab);
+
+#endif // YUREI_PAYLOAD_SLAB_H
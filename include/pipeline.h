@@ -0,0 +1,33 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_PIPELINE_H
+#define YUREI_PIPELINE_H
+
+#include <stddef.h>
+
+#include "dedup_cache.h"
+#include "event_queue.h"
+#include "metrics.h"
+#include "sharded_queue.h"
+#include "spill_queue.h"
+
+struct YureiCapture;
+
+// What the stages between the network and the DB writers share: the queue
+// events travel through and the optional services around it. Filled in and
+// owned by main (or a benchmark); parsers, pollers and writers keep a pointer.
+typedef struct {
+    YureiShardedQueue *queue;
+    YureiDedupCache *dedup;        // optional; checked before push
+    YureiMetrics *metrics;         // optional; stage latencies
+    YureiSpillQueue *spills;       // optional; one per queue shard
+    struct YureiCapture *capture;  // optional; raw traffic recorder
+} YureiPipeline;
+
+// Push to one queue shard. With spills, an event that finds the ring full
+// goes to disk instead of blocking (its slab payload is released); without
+// them, or once the spill is at its cap, the push blocks as before.
+int yurei_pipeline_push(const YureiPipeline *pipeline, size_t shard_idx, YureiEvent *event);
+
+#endif // YUREI_PIPELINE_H
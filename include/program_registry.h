@@ -0,0 +1,61 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_PROGRAM_REGISTRY_H
+#define YUREI_PROGRAM_REGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_queue.h"
+
+#define YUREI_PROGRAMS_MAX 64
+#define YUREI_PROGRAM_NAME_MAX 32
+#define YUREI_TABLE_NAME_MAX 64
+// Perfect-hash table slots; at least 4x YUREI_PROGRAMS_MAX keeps seeds easy to find
+#define YUREI_PROGRAM_INDEX_MAX 256
+
+typedef struct {
+    char name[YUREI_PROGRAM_NAME_MAX];
+    char program_id[YUREI_PROGRAM_ID_MAX];
+    size_t program_id_len;
+    uint16_t table;  // index into YureiProgramRegistry.tables
+} YureiProgram;
+
+// Programs to follow, each with its own subscription and target table.
+// Several programs may share a table; tables are stored once.
+//
+// Lookup by program ID goes through a perfect hash chosen when the registry
+// is built: the first 8 bytes of the base58 ID (uniformly random for real
+// keys) times a searched odd multiplier give a collision-free slot, and a
+// single memcmp confirms the match.
+typedef struct {
+    YureiProgram programs[YUREI_PROGRAMS_MAX];
+    size_t count;
+    char tables[YUREI_PROGRAMS_MAX][YUREI_TABLE_NAME_MAX];
+    size_t table_count;
+    uint64_t multiplier;
+    unsigned shift;
+    uint8_t index[YUREI_PROGRAM_INDEX_MAX];  // program index + 1, 0 when empty
+} YureiProgramRegistry;
+
+void yurei_program_registry_init(YureiProgramRegistry *registry);
+// Append one program; table defaults to "<name>_events". Returns -1 if the
+// registry is full, an argument is invalid, or the ID is already registered.
+int yurei_program_registry_add(YureiProgramRegistry *registry,
+                               const char *name,
+                               const char *program_id,
+                               const char *table);
+// Parse a "name:program_id[:table]" list separated by commas or whitespace
+int yurei_program_registry_parse(YureiProgramRegistry *registry, const char *spec);
+// Choose the perfect-hash parameters; call after the last add
+int yurei_program_registry_build(YureiProgramRegistry *registry);
+// Index of the program with this ID, or YUREI_EVENT_KIND_UNKNOWN
+YureiEventKind yurei_program_lookup(const YureiProgramRegistry *registry,
+                                    const char *program_id,
+                                    size_t len);
+const YureiProgram *yurei_program_get(const YureiProgramRegistry *registry, YureiEventKind kind);
+// Target table of a program, or NULL for unknown kinds
+const char *yurei_program_table(const YureiProgramRegistry *registry, YureiEventKind kind);
+
+#endif // YUREI_PROGRAM_REGISTRY_H
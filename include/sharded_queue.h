@@ -0,0 +1,32 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_SHARDED_QUEUE_H
+#define YUREI_SHARDED_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_queue.h"
+
+#define YUREI_QUEUE_SHARDS_MAX 64
+
+// A set of independent rings, one per DB writer shard. Producers pick the
+// ring from the event signature, so a given row always reaches the same
+// writer connection; each ring keeps its own payload slab.
+typedef struct {
+    YureiEventQueue *shards;
+    size_t count;
+} YureiShardedQueue;
+
+// total_capacity is split evenly across shards (each rounded up to a power of two)
+int yurei_sharded_queue_init(YureiShardedQueue *queue, size_t shard_count, size_t total_capacity);
+void yurei_sharded_queue_destroy(YureiShardedQueue *queue);
+// Well-mixed 64-bit hash of a signature, shared by routing and dedup
+uint64_t yurei_signature_hash(const char *signature);
+// Shard index for a signature; stable for a given shard count
+size_t yurei_shard_for_signature(const char *signature, size_t shard_count);
+size_t yurei_shard_for_hash(uint64_t hash, size_t shard_count);
+void yurei_sharded_queue_close(YureiShardedQueue *queue);
+
+#endif // YUREI_SHARDED_QUEUE_H
@@ -0,0 +1,93 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_SPILL_QUEUE_H
+#define YUREI_SPILL_QUEUE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_queue.h"
+
+// Bytes per segment file; the last segment's unused tail stays sparse
+#define YUREI_SPILL_SEGMENT_BYTES (64u * 1024u * 1024u)
+
+// Overflow tier behind one queue shard. Producers append events to mmap'd,
+// append-only segment files ("<dir>/shard-<n>-<seq>.spill") when the ring is
+// full or the shard's writer cannot reach Postgres; the shard's DB writer
+// replays them in batches and advances a committed offset stored in each
+// segment header, unlinking a segment once all of it has been committed.
+//
+// Every record carries a CRC32C, so a record torn by a crash ends replay of
+// its segment instead of reaching the database. Segments left by a previous
+// run are replayed from their committed offset on startup. Records keep the
+// event's receive time as wall-clock time, so it survives a restart; those in
+// segments from before it was stored come back without one.
+//
+// Appends may come from any thread (serialized by a mutex: this is the slow
+// path); read/commit/rewind belong to the shard's writer thread.
+typedef struct {
+    char dir[256];
+    size_t shard;
+    uint64_t max_bytes;  // cap on segment bytes on disk; 0 = unlimited
+    pthread_mutex_t lock;
+    // Appender state, under lock
+    int write_fd;
+    uint8_t *write_map;
+    uint64_t write_seq;
+    bool full_logged;
+    // Published to the reader
+    _Atomic uint64_t write_seq_published;  // segment being appended to
+    _Atomic uint64_t write_off;            // bytes written to that segment
+    _Atomic uint64_t disk_bytes;
+    // Reader state, writer thread only
+    uint64_t read_seq;
+    uint8_t *read_map;
+    uint64_t read_size;
+    uint32_t read_header;    // record header bytes in that segment's format
+    uint64_t read_off;       // next record to hand out
+    uint64_t committed_off;  // records before this are in the database
+    uint64_t read_count;     // records handed out since the last commit
+    // Counters
+    _Atomic uint64_t spilled;
+    _Atomic uint64_t replayed;
+    _Atomic uint64_t dead_lettered;
+} YureiSpillQueue;
+
+// Create dir if needed and pick up segments left by a previous run
+int yurei_spill_init(YureiSpillQueue *spill, const char *dir, size_t shard, uint64_t max_bytes);
+void yurei_spill_destroy(YureiSpillQueue *spill);
+
+// Copy one event to disk. Returns -1 if the size cap is reached or the
+// segment cannot be written; the caller keeps ownership of the event.
+int yurei_spill_append(YureiSpillQueue *spill, const YureiEvent *event);
+
+// True while records are waiting to be replayed
+bool yurei_spill_pending(YureiSpillQueue *spill);
+
+// Fill up to max events whose payloads point into the segment mapping
+// (data_cap is 0: they are not slab blocks), with received_ns restored when
+// it is known and the other timestamps 0. Kinds are left as
+// YUREI_EVENT_KIND_UNKNOWN for the caller to resolve from the program ID,
+// since the program list may have changed since the event was spilled.
+// Every read must be followed by a commit or a rewind; payloads stay valid
+// until then.
+size_t yurei_spill_read(YureiSpillQueue *spill, YureiEvent *events, size_t max);
+
+// Mark everything read so far as stored; unlinks fully committed segments
+void yurei_spill_commit(YureiSpillQueue *spill);
+
+// Hand the uncommitted records out again on the next read
+void yurei_spill_rewind(YureiSpillQueue *spill);
+
+// Move the records read since the last commit, which the database keeps
+// rejecting, to "<segment>.dead" and skip past them. That file is a
+// segment of its own, so it can be inspected or renamed back for replay;
+// ".corrupt" is kept for segments that could not be read at all.
+// Returns -1 if the records could not be saved; they are skipped anyway.
+int yurei_spill_dead_letter(YureiSpillQueue *spill);
+
+#endif // YUREI_SPILL_QUEUE_H
@@ -4,27 +4,83 @@
 #ifndef YUREI_WEBSOCKET_CLIENT_H
 #define YUREI_WEBSOCKET_CLIENT_H
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <pthread.h>
 
 #include "config.h"
-#include "event_queue.h"
+#include "metrics.h"
+#include "parser_pool.h"
 
+// Providers one client can hedge across (entries in YUREI_WSS_ENDPOINT)
+#define YUREI_WS_MAX_ENDPOINTS 8
+
+typedef struct YureiWebsocketClient YureiWebsocketClient;
+
+// One upstream connection. All fields but the counters and the lag
+// histogram belong to the client's service thread.
 typedef struct {
-    void *context;
+    YureiWebsocketClient *client;
+    size_t index;
+    char url[512];
+    char host[256];  // for logs and metric labels; the URL may carry an API key
     void *wsi;
+    _Atomic bool connected;
+    bool established;  // connected at least once, so a new connect is a reconnect
+    uint32_t backoff_ms;
+    uint64_t retry_at_ns;
+    // logsSubscribe requests, sent one per writeable callback
+    char outbound[512];
+    size_t outbound_len;
+    bool send_pending;
+    size_t next_program;  // registry index of the next subscription to send
+    // Reassembly buffer for fragmented messages, reused across messages and reconnects
+    char *rx_buffer;
+    size_t rx_len;
+    size_t rx_capacity;
+    uint64_t rx_started_ns;  // arrival of the current message's first frame
+    bool rx_discarding;  // skipping the rest of an oversized message
+    // Hedging: notifications carrying a signature, how many arrived here
+    // first, how far behind the first copy the others were, and first
+    // copies the parser buffer rejected (left unclaimed for other endpoints)
+    _Atomic uint64_t notifications;
+    _Atomic uint64_t wins;
+    _Atomic uint64_t hedge_dropped;
+    YureiHistogram lag;
+} YureiWsEndpoint;
+
+// First arrival of a signature across endpoints
+typedef struct {
+    uint64_t sig_hash;
+    uint64_t first_ns;
+    uint32_t winner;
+} YureiWsHedgeEntry;
+
+struct YureiWebsocketClient {
+    void *context;
     pthread_t thread;
-    YureiEventQueue *queue;
+    YureiParserPool *parsers;
     const YureiConfig *config;
+    YureiMetrics *metrics;  // the pipeline's, if any
     bool running;
-    bool connected;
-    uint32_t backoff_ms;
-} YureiWebsocketClient;
+    YureiWsEndpoint endpoints[YUREI_WS_MAX_ENDPOINTS];
+    size_t endpoint_count;
+    // Signatures seen recently, only with more than one endpoint. Touched by
+    // the service thread alone, so it needs no atomics.
+    YureiWsHedgeEntry *hedge;
+    size_t hedge_mask;
+    uint64_t hedge_window_ns;
+};
 
+// Connects to every endpoint in config->wss_endpoint on one service thread.
+// With several, each notification is forwarded once, from whichever
+// provider delivered it first.
 int yurei_ws_client_start(YureiWebsocketClient *client,
                           const YureiConfig *config,
-                          YureiEventQueue *queue);
+                          YureiParserPool *parsers);
 void yurei_ws_client_stop(YureiWebsocketClient *client);
+// Per-endpoint win rate and lag; silent with a single endpoint
+void yurei_ws_client_log(const YureiWebsocketClient *client);
 
 #endif // YUREI_WEBSOCKET_CLIENT_H
@@ -0,0 +1,208 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "mock_rpc.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MOCK_SIGNATURE_LEN 88
+#define MOCK_COMPUTE_BUDGET "ComputeBudget111111111111111111111111111111"
+
+static const char BASE58[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+uint64_t mock_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t mock_hash(uint64_t a, uint64_t b, uint64_t c) {
+    return splitmix64(a ^ splitmix64(b ^ splitmix64(c)));
+}
+
+static double unit_interval(uint64_t h) {
+    return (double)(h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// ---------------------------------------------------------------------------
+// Slot schedule
+// ---------------------------------------------------------------------------
+
+uint64_t mock_chain_current_slot(const MockChain *chain) {
+    uint64_t elapsed = mock_now_ns() - chain->start_ns;
+    return chain->start_slot + elapsed / ((uint64_t)chain->slot_ms * 1000000ULL);
+}
+
+uint64_t mock_chain_tip(const MockChain *chain) {
+    uint64_t current = mock_chain_current_slot(chain);
+    return current > chain->start_slot ? current - 1 : chain->start_slot;
+}
+
+uint32_t mock_slot_events(const MockChain *chain, uint64_t slot) {
+    double mean = chain->rate * (double)chain->slot_ms / 1000.0;
+    if (chain->burst > 1.0) {
+        if (unit_interval(mock_hash(chain->seed, slot, 0xB0057)) >= 1.0 / chain->burst) {
+            return 0;
+        }
+        mean *= chain->burst;
+    }
+    // Round the fractional part up with the matching probability
+    uint32_t count = (uint32_t)mean;
+    if (unit_interval(mock_hash(chain->seed, slot, 0xF7AC)) < mean - (double)count) {
+        count++;
+    }
+    return count;
+}
+
+uint64_t mock_event_due_ns(const MockChain *chain, uint64_t slot, uint32_t index, uint32_t count) {
+    uint64_t slot_ns = (uint64_t)chain->slot_ms * 1000000ULL;
+    uint64_t start = chain->start_ns + (slot - chain->start_slot) * slot_ns;
+    if (count == 0) {
+        return start;
+    }
+    uint64_t window = (uint64_t)((double)slot_ns / (chain->burst > 1.0 ? chain->burst : 1.0));
+    return start + window * index / count;
+}
+
+YureiEventKind mock_event_program(const MockChain *chain, uint64_t slot, uint32_t index) {
+    size_t programs = chain->programs->count ? chain->programs->count : 1;
+    return (YureiEventKind)(mock_hash(chain->seed, slot, index) % programs);
+}
+
+// ---------------------------------------------------------------------------
+// Transaction JSON
+// ---------------------------------------------------------------------------
+
+static void make_signature(const MockChain *chain, uint64_t slot, uint32_t index, char *out) {
+    uint64_t h = mock_hash(chain->seed ^ 0x5167ULL, slot, index);
+    for (size_t i = 0; i < MOCK_SIGNATURE_LEN; ++i) {
+        if (i % 10 == 0) {
+            h = splitmix64(h);
+        }
+        out[i] = BASE58[(h >> ((i % 10) * 6)) % 58];
+    }
+    out[MOCK_SIGNATURE_LEN] = '\0';
+}
+
+// Base64 of len pseudo-random bytes, appended to buf
+static bool append_payload(MockBuffer *buf, uint64_t seed, size_t len) {
+    size_t encoded = (len + 2) / 3 * 4;
+    if (!mock_buffer_reserve(buf, encoded)) {
+        return false;
+    }
+    char *out = buf->data + buf->len;
+    uint64_t h = seed;
+    for (size_t i = 0; i < len; i += 3) {
+        h = splitmix64(h);
+        uint32_t triple = (uint32_t)(h & 0xFFFFFFu);
+        size_t left = len - i;
+        *out++ = BASE64[(triple >> 18) & 0x3F];
+        *out++ = BASE64[(triple >> 12) & 0x3F];
+        *out++ = left > 1 ? BASE64[(triple >> 6) & 0x3F] : '=';
+        *out++ = left > 2 ? BASE64[triple & 0x3F] : '=';
+    }
+    buf->len += encoded;
+    buf->data[buf->len] = '\0';
+    return true;
+}
+
+bool mock_append_tx(MockBuffer *buf, const MockChain *chain, uint64_t slot, uint32_t index) {
+    char signature[MOCK_SIGNATURE_LEN + 1];
+    make_signature(chain, slot, index, signature);
+    const YureiProgram *program = yurei_program_get(chain->programs,
+                                                    mock_event_program(chain, slot, index));
+    const char *id = program ? program->program_id : "11111111111111111111111111111111";
+    uint64_t h = mock_hash(chain->seed ^ 0xDA7AULL, slot, index);
+    uint32_t span = chain->data_max - chain->data_min + 1;
+    size_t data_len = chain->data_min + (size_t)(h % span);
+
+    bool ok = mock_buffer_printf(buf,
+                                 "\"signature\":\"%s\",\"err\":null,\"logs\":["
+                                 "\"Program " MOCK_COMPUTE_BUDGET " invoke [1]\","
+                                 "\"Program " MOCK_COMPUTE_BUDGET " success\","
+                                 "\"Program %s invoke [1]\","
+                                 "\"Program log: Instruction: Swap\"",
+                                 signature, id);
+    for (uint32_t i = 0; ok && i < chain->log_lines; ++i) {
+        ok = mock_buffer_printf(buf, ",\"Program log: filler %u of %u for %016llx\"",
+                                i + 1, chain->log_lines, (unsigned long long)h);
+    }
+    ok = ok && mock_buffer_append(buf, ",\"Program data: ", 16) &&
+         append_payload(buf, h, data_len) &&
+         mock_buffer_printf(buf,
+                            "\",\"Program %s consumed %u of 200000 compute units\","
+                            "\"Program %s success\"]",
+                            id, 20000u + (uint32_t)(h >> 48) % 60000u, id);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Buffers
+// ---------------------------------------------------------------------------
+
+bool mock_buffer_reserve(MockBuffer *buf, size_t extra) {
+    size_t needed = buf->len + extra + 1;
+    if (needed <= buf->cap) {
+        return true;
+    }
+    size_t cap = buf->cap ? buf->cap : 4096;
+    while (cap < needed) {
+        cap *= 2;
+    }
+    char *grown = realloc(buf->data, cap);
+    if (!grown) {
+        return false;
+    }
+    buf->data = grown;
+    buf->cap = cap;
+    return true;
+}
+
+bool mock_buffer_append(MockBuffer *buf, const char *data, size_t len) {
+    if (!mock_buffer_reserve(buf, len)) {
+        return false;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    buf->data[buf->len] = '\0';
+    return true;
+}
+
+bool mock_buffer_printf(MockBuffer *buf, const char *fmt, ...) {
+    for (;;) {
+        size_t room = buf->cap > buf->len ? buf->cap - buf->len : 0;
+        va_list args;
+        va_start(args, fmt);
+        int written = vsnprintf(room ? buf->data + buf->len : NULL, room, fmt, args);
+        va_end(args);
+        if (written < 0) {
+            return false;
+        }
+        if ((size_t)written < room) {
+            buf->len += (size_t)written;
+            return true;
+        }
+        if (!mock_buffer_reserve(buf, (size_t)written)) {
+            return false;
+        }
+    }
+}
+
+void mock_buffer_free(MockBuffer *buf) {
+    free(buf->data);
+    buf->data = NULL;
+    buf->len = 0;
+    buf->cap = 0;
+}
@@ -0,0 +1,421 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "mock_rpc.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "json_scan.h"
+#include "logging.h"
+
+#define HTTP_POLL_MS 200
+#define HTTP_HEADER_MAX (16u * 1024u)
+#define HTTP_BODY_MAX (8u * 1024u * 1024u)
+#define HTTP_READ_CHUNK (64u * 1024u)
+// getLogs limit when the call gives none, and the widest slot range served
+#define GETLOGS_DEFAULT_LIMIT 1000
+#define GETLOGS_SLOT_RANGE_MAX 10000
+
+typedef struct {
+    MockHttpServer *server;
+    int fd;
+} HttpConnection;
+
+typedef struct {
+    bool has_id;
+    uint64_t id;
+    YureiJsonSlice method;
+    bool has_start;
+    uint64_t start_slot;
+    bool has_end;
+    uint64_t end_slot;
+    uint64_t limit;
+    uint64_t mentions;  // bitmask of registry indexes
+} RpcCall;
+
+// ---------------------------------------------------------------------------
+// JSON-RPC
+// ---------------------------------------------------------------------------
+
+static bool parse_filter(YureiJsonScanner *sc, const MockChain *chain, RpcCall *call) {
+    if (!yurei_json_object_begin(sc)) {
+        return false;
+    }
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(sc, &key)) > 0) {
+        if (yurei_json_slice_equals(&key, "startSlot")) {
+            ok = call->has_start = yurei_json_uint64(sc, &call->start_slot);
+        } else if (yurei_json_slice_equals(&key, "endSlot")) {
+            ok = call->has_end = yurei_json_uint64(sc, &call->end_slot);
+        } else if (yurei_json_slice_equals(&key, "limit")) {
+            ok = yurei_json_uint64(sc, &call->limit);
+        } else if (yurei_json_slice_equals(&key, "mentions") &&
+                   yurei_json_peek(sc) == YUREI_JSON_ARRAY) {
+            yurei_json_array_begin(sc);
+            YureiJsonSlice id;
+            while (ok && yurei_json_array_next(sc) > 0) {
+                ok = yurei_json_string(sc, &id);
+                if (!ok) {
+                    break;  // malformed; the caller answers -32600
+                }
+                YureiEventKind kind = yurei_program_lookup(chain->programs, id.ptr, id.len);
+                if (kind < 64) {
+                    call->mentions |= 1ULL << kind;
+                }
+            }
+        } else {
+            ok = yurei_json_skip_value(sc);
+        }
+    }
+    return ok;
+}
+
+static bool parse_call(const char *json, size_t len, const MockChain *chain, RpcCall *call) {
+    memset(call, 0, sizeof(*call));
+    YureiJsonScanner sc;
+    yurei_json_init(&sc, json, len);
+    if (!yurei_json_object_begin(&sc)) {
+        return false;
+    }
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(&sc, &key)) > 0) {
+        if (yurei_json_slice_equals(&key, "id")) {
+            ok = call->has_id = yurei_json_uint64(&sc, &call->id);
+        } else if (yurei_json_slice_equals(&key, "method")) {
+            ok = yurei_json_string(&sc, &call->method);
+        } else if (yurei_json_slice_equals(&key, "params") &&
+                   yurei_json_peek(&sc) == YUREI_JSON_ARRAY) {
+            yurei_json_array_begin(&sc);
+            bool first = true;
+            while (ok && yurei_json_array_next(&sc) > 0) {
+                if (first && yurei_json_peek(&sc) == YUREI_JSON_OBJECT) {
+                    ok = parse_filter(&sc, chain, call);
+                } else {
+                    ok = yurei_json_skip_value(&sc);
+                }
+                first = false;
+            }
+        } else {
+            ok = yurei_json_skip_value(&sc);
+        }
+    }
+    return ok && call->has_id;
+}
+
+static void answer_get_logs(MockHttpServer *server, const RpcCall *call, MockBuffer *out) {
+    const MockChain *chain = server->chain;
+    uint64_t tip = mock_chain_tip(chain);
+    uint64_t start = call->has_start ? call->start_slot : tip;
+    uint64_t end = call->has_end && call->end_slot < tip ? call->end_slot : tip;
+    if (start < chain->start_slot) {
+        start = chain->start_slot;
+    }
+    if (end > start + GETLOGS_SLOT_RANGE_MAX) {
+        end = start + GETLOGS_SLOT_RANGE_MAX;
+    }
+    uint64_t limit = call->limit ? call->limit : GETLOGS_DEFAULT_LIMIT;
+    uint64_t mentions = call->mentions ? call->mentions : UINT64_MAX;
+
+    mock_buffer_printf(out, "{\"jsonrpc\":\"2.0\",\"id\":%" PRIu64 ",\"result\":[", call->id);
+    uint64_t served = 0;
+    for (uint64_t slot = start; slot <= end && served < limit; ++slot) {
+        uint32_t count = mock_slot_events(chain, slot);
+        for (uint32_t i = 0; i < count && served < limit; ++i) {
+            YureiEventKind kind = mock_event_program(chain, slot, i);
+            if (!(mentions & (1ULL << kind))) {
+                continue;
+            }
+            const YureiProgram *program = yurei_program_get(chain->programs, kind);
+            mock_buffer_printf(out, "%s{\"slot\":%" PRIu64 ",\"programId\":\"%s\",",
+                               served ? "," : "", slot, program ? program->program_id : "");
+            mock_append_tx(out, chain, slot, i);
+            mock_buffer_append(out, "}", 1);
+            served++;
+        }
+    }
+    mock_buffer_append(out, "]}", 2);
+    atomic_fetch_add_explicit(&server->stats->http_events, served, memory_order_relaxed);
+}
+
+static void answer_call(MockHttpServer *server, const char *json, size_t len, MockBuffer *out) {
+    RpcCall call;
+    if (!parse_call(json, len, server->chain, &call)) {
+        mock_buffer_printf(out, "{\"jsonrpc\":\"2.0\",\"id\":null,"
+                                "\"error\":{\"code\":-32600,\"message\":\"Invalid request\"}}");
+    } else if (yurei_json_slice_equals(&call.method, "getSlot")) {
+        mock_buffer_printf(out, "{\"jsonrpc\":\"2.0\",\"id\":%" PRIu64 ",\"result\":%" PRIu64 "}",
+                           call.id, mock_chain_tip(server->chain));
+    } else if (yurei_json_slice_equals(&call.method, "getLogs")) {
+        answer_get_logs(server, &call, out);
+    } else {
+        mock_buffer_printf(out, "{\"jsonrpc\":\"2.0\",\"id\":%" PRIu64 ","
+                                "\"error\":{\"code\":-32601,\"message\":\"Method not found\"}}",
+                           call.id);
+    }
+}
+
+// A batch gets a batch reply; a single call a single object
+static void answer_body(MockHttpServer *server, const char *body, size_t len, MockBuffer *out) {
+    YureiJsonScanner sc;
+    yurei_json_init(&sc, body, len);
+    if (yurei_json_peek(&sc) != YUREI_JSON_ARRAY) {
+        answer_call(server, body, len, out);
+        return;
+    }
+    yurei_json_array_begin(&sc);
+    mock_buffer_append(out, "[", 1);
+    bool first = true;
+    while (yurei_json_array_next(&sc) > 0) {
+        yurei_json_peek(&sc);
+        const char *element = sc.cur;
+        if (!yurei_json_skip_value(&sc)) {
+            break;
+        }
+        if (!first) {
+            mock_buffer_append(out, ",", 1);
+        }
+        answer_call(server, element, (size_t)(sc.cur - element), out);
+        first = false;
+    }
+    mock_buffer_append(out, "]", 1);
+}
+
+// ---------------------------------------------------------------------------
+// HTTP/1.1 with keep-alive, one thread per connection
+// ---------------------------------------------------------------------------
+
+static bool send_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+static bool send_response(int fd, const char *status, const char *extra_headers, const MockBuffer *body) {
+    char header[256];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 %s\r\nContent-Type: application/json\r\n"
+                     "Content-Length: %zu\r\n%s\r\n",
+                     status, body->len, extra_headers);
+    return send_all(fd, header, (size_t)n) && send_all(fd, body->data, body->len);
+}
+
+static size_t content_length(const char *headers, size_t len) {
+    static const char name[] = "\r\ncontent-length:";
+    for (size_t i = 0; i + sizeof(name) - 1 < len; ++i) {
+        if (strncasecmp(headers + i, name, sizeof(name) - 1) == 0) {
+            return (size_t)strtoull(headers + i + sizeof(name) - 1, NULL, 10);
+        }
+    }
+    return 0;
+}
+
+// Read into in until it holds at least want bytes; false on close, error or stop
+static bool read_at_least(MockHttpServer *server, int fd, MockBuffer *in, size_t want) {
+    while (in->len < want) {
+        if (!mock_buffer_reserve(in, HTTP_READ_CHUNK)) {
+            return false;
+        }
+        ssize_t got = recv(fd, in->data + in->len, in->cap - in->len - 1, 0);
+        if (got > 0) {
+            in->len += (size_t)got;
+            in->data[in->len] = '\0';
+            continue;
+        }
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) &&
+            !atomic_load_explicit(&server->stop, memory_order_acquire)) {
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+static void serve_connection(MockHttpServer *server, int fd) {
+    const MockServerOptions *options = server->options;
+    uint64_t rng = mock_hash(server->chain->seed, (uint64_t)fd, mock_now_ns());
+    MockBuffer in = {0};
+    MockBuffer out = {0};
+    for (;;) {
+        // Headers
+        char *header_end = NULL;
+        while (!(header_end = in.data ? strstr(in.data, "\r\n\r\n") : NULL)) {
+            if (in.len > HTTP_HEADER_MAX || !read_at_least(server, fd, &in, in.len + 1)) {
+                goto done;
+            }
+        }
+        size_t header_len = (size_t)(header_end - in.data) + 4;
+        size_t body_len = content_length(in.data, header_len);
+        if (body_len > HTTP_BODY_MAX || !read_at_least(server, fd, &in, header_len + body_len)) {
+            break;
+        }
+        atomic_fetch_add_explicit(&server->stats->http_requests, 1, memory_order_relaxed);
+        if (options->http_delay_ms) {
+            usleep(options->http_delay_ms * 1000);
+        }
+
+        out.len = 0;
+        bool ok;
+        rng = mock_hash(rng, 0, 0);
+        if (strncmp(in.data, "POST ", 5) != 0) {
+            mock_buffer_printf(&out, "{\"error\":\"POST JSON-RPC requests only\"}");
+            ok = send_response(fd, "405 Method Not Allowed", "", &out);
+        } else if (options->http_429 > 0 &&
+                   (double)(rng >> 11) * (1.0 / 9007199254740992.0) < options->http_429) {
+            atomic_fetch_add_explicit(&server->stats->http_throttled, 1, memory_order_relaxed);
+            mock_buffer_printf(&out, "{\"jsonrpc\":\"2.0\",\"id\":null,"
+                                     "\"error\":{\"code\":429,\"message\":\"Too many requests\"}}");
+            ok = send_response(fd, "429 Too Many Requests", "Retry-After: 1\r\n", &out);
+        } else {
+            answer_body(server, in.data + header_len, body_len, &out);
+            ok = send_response(fd, "200 OK", "", &out);
+        }
+        if (!ok) {
+            break;
+        }
+
+        // Keep whatever of the next request already arrived
+        size_t used = header_len + body_len;
+        memmove(in.data, in.data + used, in.len - used);
+        in.len -= used;
+        in.data[in.len] = '\0';
+    }
+done:
+    mock_buffer_free(&in);
+    mock_buffer_free(&out);
+}
+
+static void *connection_thread(void *arg) {
+    HttpConnection *conn = (HttpConnection *)arg;
+    MockHttpServer *server = conn->server;
+    serve_connection(server, conn->fd);
+    close(conn->fd);
+    free(conn);
+    atomic_fetch_sub_explicit(&server->connections, 1, memory_order_release);
+    return NULL;
+}
+
+static void *accept_thread(void *arg) {
+    MockHttpServer *server = (MockHttpServer *)arg;
+    struct pollfd pfd = {.fd = server->listen_fd, .events = POLLIN};
+    while (!atomic_load_explicit(&server->stop, memory_order_acquire)) {
+        if (poll(&pfd, 1, HTTP_POLL_MS) <= 0) {
+            continue;
+        }
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        // The receive timeout lets idle keep-alive threads notice a stop
+        struct timeval timeout = {.tv_sec = 0, .tv_usec = HTTP_POLL_MS * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        HttpConnection *conn = malloc(sizeof(*conn));
+        pthread_attr_t attr;
+        pthread_t thread;
+        bool started = false;
+        if (conn && pthread_attr_init(&attr) == 0) {
+            conn->server = server;
+            conn->fd = fd;
+            pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+            atomic_fetch_add_explicit(&server->connections, 1, memory_order_relaxed);
+            started = pthread_create(&thread, &attr, connection_thread, conn) == 0;
+            if (!started) {
+                atomic_fetch_sub_explicit(&server->connections, 1, memory_order_relaxed);
+            }
+            pthread_attr_destroy(&attr);
+        }
+        if (!started) {
+            free(conn);
+            close(fd);
+        }
+    }
+    return NULL;
+}
+
+int mock_http_start(MockHttpServer *server, MockChain *chain, const MockServerOptions *options, MockStats *stats) {
+    if (!server || !chain || !options || !stats) {
+        return -1;
+    }
+    memset(server, 0, sizeof(*server));
+    server->listen_fd = -1;
+    if (options->http_port == 0) {
+        return 0;
+    }
+    server->chain = chain;
+    server->options = options;
+    server->stats = stats;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options->http_port);
+    if (inet_pton(AF_INET, options->bind, &addr.sin_addr) != 1) {
+        YUREI_LOG_ERROR("Invalid bind address: %s", options->bind);
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        YUREI_LOG_ERROR("Unable to listen on %s:%u: %s",
+                        options->bind, options->http_port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    server->listen_fd = fd;
+    atomic_init(&server->stop, false);
+    atomic_init(&server->connections, 0);
+    if (pthread_create(&server->thread, NULL, accept_thread, server) != 0) {
+        close(fd);
+        server->listen_fd = -1;
+        return -1;
+    }
+    server->running = true;
+    YUREI_LOG_INFO("Mock JSON-RPC listening on http://%s:%u", options->bind, options->http_port);
+    return 0;
+}
+
+void mock_http_stop(MockHttpServer *server) {
+    if (!server || !server->running) {
+        return;
+    }
+    atomic_store_explicit(&server->stop, true, memory_order_release);
+    pthread_join(server->thread, NULL);
+    close(server->listen_fd);
+    server->listen_fd = -1;
+    // Connection threads see the stop within one receive timeout
+    while (atomic_load_explicit(&server->connections, memory_order_acquire) > 0) {
+        usleep(10000);
+    }
+    server->running = false;
+}
@@ -0,0 +1,188 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "logging.h"
+#include "mock_rpc.h"
+
+#define MOCK_DEFAULT_WS_PORT 8900
+#define MOCK_DEFAULT_HTTP_PORT 8899
+#define MOCK_DEFAULT_RATE 1000.0
+#define MOCK_DEFAULT_SLOT_MS 400
+#define MOCK_DEFAULT_DATA_MIN 64
+#define MOCK_DEFAULT_DATA_MAX 512
+#define MOCK_DEFAULT_LOG_LINES 8
+#define MOCK_DEFAULT_START_SLOT 300000000ULL
+
+static volatile sig_atomic_t g_should_exit = 0;
+
+static void handle_signal(int signum) {
+    (void)signum;
+    g_should_exit = 1;
+}
+
+static void install_signal_handlers(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-c path/to/.env] [--bind addr] [--ws-port N] [--http-port N]\n"
+            "          [--rate events/s] [--burst B] [--slot-ms N] [--data-bytes MIN[:MAX]]\n"
+            "          [--log-lines N] [--ws-fragment bytes] [--disconnect-every S]\n"
+            "          [--http-429 P] [--http-delay-ms N] [--duration S] [--seed N]\n"
+            "          [--start-slot N]\n",
+            prog);
+}
+
+static void log_stats(MockStats *stats, MockStats *last, double seconds) {
+    uint64_t ws_messages = atomic_load(&stats->ws_messages);
+    uint64_t ws_bytes = atomic_load(&stats->ws_bytes);
+    uint64_t http_requests = atomic_load(&stats->http_requests);
+    uint64_t http_events = atomic_load(&stats->http_events);
+    YUREI_LOG_INFO("ws: %" PRIu64 " clients, %.0f msg/s, %.2f MB/s, %" PRIu64 " dropped | "
+                   "http: %.0f req/s, %.0f events/s, %" PRIu64 " throttled",
+                   atomic_load(&stats->ws_clients),
+                   (double)(ws_messages - atomic_load(&last->ws_messages)) / seconds,
+                   (double)(ws_bytes - atomic_load(&last->ws_bytes)) / seconds / 1e6,
+                   atomic_load(&stats->ws_disconnects),
+                   (double)(http_requests - atomic_load(&last->http_requests)) / seconds,
+                   (double)(http_events - atomic_load(&last->http_events)) / seconds,
+                   atomic_load(&stats->http_throttled));
+    atomic_store(&last->ws_messages, ws_messages);
+    atomic_store(&last->ws_bytes, ws_bytes);
+    atomic_store(&last->http_requests, http_requests);
+    atomic_store(&last->http_events, http_events);
+}
+
+int main(int argc, char **argv) {
+    const char *env_path = ".env";
+    MockServerOptions options = {
+        .bind = "127.0.0.1",
+        .ws_port = MOCK_DEFAULT_WS_PORT,
+        .http_port = MOCK_DEFAULT_HTTP_PORT,
+    };
+    MockChain chain = {
+        .seed = 1,
+        .rate = MOCK_DEFAULT_RATE,
+        .burst = 1.0,
+        .slot_ms = MOCK_DEFAULT_SLOT_MS,
+        .data_min = MOCK_DEFAULT_DATA_MIN,
+        .data_max = MOCK_DEFAULT_DATA_MAX,
+        .log_lines = MOCK_DEFAULT_LOG_LINES,
+        .start_slot = MOCK_DEFAULT_START_SLOT,
+    };
+    uint32_t duration_s = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) && has_value) {
+            env_path = argv[++i];
+        } else if (strcmp(argv[i], "--bind") == 0 && has_value) {
+            options.bind = argv[++i];
+        } else if (strcmp(argv[i], "--ws-port") == 0 && has_value) {
+            options.ws_port = (uint16_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--http-port") == 0 && has_value) {
+            options.http_port = (uint16_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--rate") == 0 && has_value) {
+            chain.rate = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--burst") == 0 && has_value) {
+            chain.burst = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--slot-ms") == 0 && has_value) {
+            chain.slot_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--data-bytes") == 0 && has_value) {
+            char *end = NULL;
+            chain.data_min = (uint32_t)strtoul(argv[++i], &end, 10);
+            chain.data_max = *end == ':' ? (uint32_t)strtoul(end + 1, NULL, 10) : chain.data_min;
+        } else if (strcmp(argv[i], "--log-lines") == 0 && has_value) {
+            chain.log_lines = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--ws-fragment") == 0 && has_value) {
+            options.ws_fragment = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--disconnect-every") == 0 && has_value) {
+            options.disconnect_s = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--http-429") == 0 && has_value) {
+            options.http_429 = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--http-delay-ms") == 0 && has_value) {
+            options.http_delay_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--duration") == 0 && has_value) {
+            duration_s = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            chain.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--start-slot") == 0 && has_value) {
+            chain.start_slot = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (chain.rate < 0 || chain.burst < 1.0 || chain.slot_ms == 0 ||
+        chain.data_max < chain.data_min || options.http_429 < 0 || options.http_429 > 1) {
+        YUREI_LOG_ERROR("Invalid traffic shape: need rate >= 0, burst >= 1, slot-ms > 0, "
+                        "data-bytes MIN <= MAX and 0 <= http-429 <= 1");
+        return 1;
+    }
+
+    // Only the program list is used: it names what the mock emits
+    YureiConfig config;
+    if (yurei_config_load(env_path, &config) != 0) {
+        YUREI_LOG_ERROR("Failed to load configuration");
+        return 1;
+    }
+    chain.programs = &config.programs;
+    chain.start_ns = mock_now_ns();
+    YUREI_LOG_INFO("Mock chain: %zu programs, %.0f events/s, burst %.1f, %u ms slots, "
+                   "%u-%u data bytes, seed %" PRIu64,
+                   config.programs.count, chain.rate, chain.burst, chain.slot_ms,
+                   chain.data_min, chain.data_max, chain.seed);
+
+    MockStats stats;
+    memset(&stats, 0, sizeof(stats));
+    MockWsServer ws;
+    MockHttpServer http;
+    if (mock_ws_start(&ws, &chain, &options, &stats) != 0) {
+        return 1;
+    }
+    if (mock_http_start(&http, &chain, &options, &stats) != 0) {
+        mock_ws_stop(&ws);
+        return 1;
+    }
+    if (!ws.running && !http.running) {
+        YUREI_LOG_ERROR("Both servers are disabled");
+        return 1;
+    }
+
+    install_signal_handlers();
+    MockStats last;
+    memset(&last, 0, sizeof(last));
+    uint64_t started = mock_now_ns();
+    uint64_t last_log = started;
+    while (!g_should_exit) {
+        sleep(1);
+        uint64_t now = mock_now_ns();
+        log_stats(&stats, &last, (double)(now - last_log) / 1e9);
+        last_log = now;
+        if (duration_s && now - started >= (uint64_t)duration_s * 1000000000ULL) {
+            break;
+        }
+    }
+
+    mock_http_stop(&http);
+    mock_ws_stop(&ws);
+    YUREI_LOG_INFO("Mock stopped: %" PRIu64 " WebSocket messages, %" PRIu64 " HTTP requests",
+                   atomic_load(&stats.ws_messages), atomic_load(&stats.http_requests));
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#ifndef YUREI_MOCK_RPC_H
+#define YUREI_MOCK_RPC_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "program_registry.h"
+
+// Synthetic chain shared by the WebSocket and HTTP servers. Every slot's
+// transactions are a pure function of (seed, slot, index), so both transports
+// serve identical events and a dual-mode client sees real duplicates.
+//
+// Burstiness: with burst = B only one slot in B (chosen by hash) carries
+// traffic, B times the mean, streamed within the first 1/B of the slot. B = 1
+// spreads the mean rate evenly over every slot.
+typedef struct {
+    const YureiProgramRegistry *programs;
+    uint64_t seed;
+    double rate;         // mean events per second
+    double burst;        // >= 1
+    uint32_t slot_ms;
+    uint32_t data_min;   // decoded "Program data:" bytes per event
+    uint32_t data_max;
+    uint32_t log_lines;  // filler "Program log:" lines per transaction
+    uint64_t start_slot;
+    uint64_t start_ns;
+} MockChain;
+
+// Growable output buffer; data stays NUL-terminated
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} MockBuffer;
+
+typedef struct {
+    _Atomic uint64_t ws_clients;
+    _Atomic uint64_t ws_messages;
+    _Atomic uint64_t ws_bytes;
+    _Atomic uint64_t ws_disconnects;  // connections closed by the mock
+    _Atomic uint64_t http_requests;
+    _Atomic uint64_t http_throttled;  // answered with 429
+    _Atomic uint64_t http_events;
+} MockStats;
+
+typedef struct {
+    const char *bind;
+    uint16_t ws_port;       // 0 disables the WebSocket server
+    uint32_t ws_fragment;   // split messages into frames of at most this many bytes; 0 = whole
+    uint32_t disconnect_s;  // close each WebSocket after about this long; 0 = never
+    uint16_t http_port;     // 0 disables the HTTP server
+    double http_429;        // probability an HTTP request is rejected with 429
+    uint32_t http_delay_ms; // added to every HTTP response
+} MockServerOptions;
+
+typedef struct {
+    MockChain *chain;
+    const MockServerOptions *options;
+    MockStats *stats;
+    _Atomic bool stop;
+    void *context;  // struct lws_context
+    pthread_t service_thread;
+    pthread_t tick_thread;
+    bool running;
+} MockWsServer;
+
+typedef struct {
+    MockChain *chain;
+    const MockServerOptions *options;
+    MockStats *stats;
+    _Atomic bool stop;
+    int listen_fd;
+    _Atomic uint32_t connections;  // live connection threads
+    pthread_t thread;
+    bool running;
+} MockHttpServer;
+
+uint64_t mock_now_ns(void);
+uint64_t mock_hash(uint64_t a, uint64_t b, uint64_t c);
+
+// Slot being produced now, and the last slot whose events are all out
+uint64_t mock_chain_current_slot(const MockChain *chain);
+uint64_t mock_chain_tip(const MockChain *chain);
+uint32_t mock_slot_events(const MockChain *chain, uint64_t slot);
+// Monotonic time at which event index of slot is streamed
+uint64_t mock_event_due_ns(const MockChain *chain, uint64_t slot, uint32_t index, uint32_t count);
+YureiEventKind mock_event_program(const MockChain *chain, uint64_t slot, uint32_t index);
+// {"signature":...,"err":null,"logs":[...]} members, without braces
+bool mock_append_tx(MockBuffer *buf, const MockChain *chain, uint64_t slot, uint32_t index);
+
+bool mock_buffer_reserve(MockBuffer *buf, size_t extra);
+bool mock_buffer_append(MockBuffer *buf, const char *data, size_t len);
+bool mock_buffer_printf(MockBuffer *buf, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+void mock_buffer_free(MockBuffer *buf);
+
+int mock_ws_start(MockWsServer *server, MockChain *chain, const MockServerOptions *options, MockStats *stats);
+void mock_ws_stop(MockWsServer *server);
+int mock_http_start(MockHttpServer *server, MockChain *chain, const MockServerOptions *options, MockStats *stats);
+void mock_http_stop(MockHttpServer *server);
+
+#endif // YUREI_MOCK_RPC_H
@@ -0,0 +1,344 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "mock_rpc.h"
+
+#include <libwebsockets.h>
+
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "json_scan.h"
+#include "logging.h"
+
+// The service loop is woken this often to stream events that fell due
+#define WS_TICK_NS 1000000L
+#define WS_MAX_PENDING_REPLIES 32
+
+typedef struct {
+    uint64_t id;
+    uint64_t subscription;  // 0 answers with an error
+} WsReply;
+
+typedef struct {
+    // Next event to consider: index of slot, which holds count events
+    uint64_t slot;
+    uint32_t index;
+    uint32_t count;
+    uint64_t mask;  // subscribed registry indexes
+    uint64_t subscriptions[64];
+    WsReply replies[WS_MAX_PENDING_REPLIES];
+    size_t reply_count;
+    // Message being sent; the payload starts LWS_PRE bytes in
+    MockBuffer message;
+    size_t sent;
+    uint64_t close_at_ns;
+} WsSession;
+
+static _Atomic uint64_t g_next_subscription = 1;
+
+static int ws_callback(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
+
+static const struct lws_protocols protocols[] = {
+    {"http", lws_callback_http_dummy, 0, 0, 0, NULL, 0},
+    {"yurei-protocol", ws_callback, sizeof(WsSession), 0, 0, NULL, 0},
+    {NULL, NULL, 0, 0, 0, NULL, 0}
+};
+
+static MockWsServer *server_of(struct lws *wsi) {
+    return (MockWsServer *)lws_context_user(lws_get_context(wsi));
+}
+
+static void start_cursor(const MockChain *chain, WsSession *session) {
+    session->slot = mock_chain_current_slot(chain);
+    session->index = 0;
+    session->count = mock_slot_events(chain, session->slot);
+}
+
+// {"id":N,"method":"logsSubscribe","params":[{"mentions":["<program>"]},...]}
+static void handle_request(MockWsServer *server, WsSession *session, const char *json, size_t len) {
+    YureiJsonScanner sc;
+    yurei_json_init(&sc, json, len);
+    if (!yurei_json_object_begin(&sc)) {
+        return;
+    }
+    uint64_t id = 0;
+    bool subscribe = false;
+    YureiEventKind kind = YUREI_EVENT_KIND_UNKNOWN;
+    YureiJsonSlice key;
+    YureiJsonSlice value;
+    bool ok = true;
+    while (ok && yurei_json_object_next(&sc, &key) > 0) {
+        if (yurei_json_slice_equals(&key, "id")) {
+            ok = yurei_json_uint64(&sc, &id);
+        } else if (yurei_json_slice_equals(&key, "method")) {
+            ok = yurei_json_string(&sc, &value);
+            subscribe = ok && yurei_json_slice_equals(&value, "logsSubscribe");
+        } else if (yurei_json_slice_equals(&key, "params") &&
+                   yurei_json_peek(&sc) == YUREI_JSON_ARRAY) {
+            // Only the first mention of the first filter matters
+            yurei_json_array_begin(&sc);
+            bool first = true;
+            while (ok && yurei_json_array_next(&sc) > 0) {
+                if (!first || yurei_json_peek(&sc) != YUREI_JSON_OBJECT) {
+                    ok = yurei_json_skip_value(&sc);
+                    continue;
+                }
+                first = false;
+                yurei_json_object_begin(&sc);
+                while (ok && yurei_json_object_next(&sc, &key) > 0) {
+                    if (!yurei_json_slice_equals(&key, "mentions") ||
+                        yurei_json_peek(&sc) != YUREI_JSON_ARRAY) {
+                        ok = yurei_json_skip_value(&sc);
+                        continue;
+                    }
+                    yurei_json_array_begin(&sc);
+                    while (ok && yurei_json_array_next(&sc) > 0) {
+                        ok = yurei_json_string(&sc, &value);
+                        if (ok && kind == YUREI_EVENT_KIND_UNKNOWN) {
+                            kind = yurei_program_lookup(server->chain->programs, value.ptr, value.len);
+                        }
+                    }
+                }
+            }
+        } else {
+            ok = yurei_json_skip_value(&sc);
+        }
+    }
+    if (!ok || session->reply_count == WS_MAX_PENDING_REPLIES) {
+        return;
+    }
+    WsReply *reply = &session->replies[session->reply_count++];
+    reply->id = id;
+    reply->subscription = 0;
+    if (subscribe && kind < 64) {
+        if (session->mask == 0) {
+            start_cursor(server->chain, session);
+        }
+        session->mask |= 1ULL << kind;
+        session->subscriptions[kind] =
+            atomic_fetch_add_explicit(&g_next_subscription, 1, memory_order_relaxed);
+        reply->subscription = session->subscriptions[kind];
+    }
+}
+
+// Advance the cursor to the next due event of a subscribed program
+static bool next_due_event(const MockChain *chain, WsSession *session, uint64_t now) {
+    for (;;) {
+        while (session->index >= session->count) {
+            if (mock_event_due_ns(chain, session->slot + 1, 0, 0) > now) {
+                return false;
+            }
+            session->slot++;
+            session->index = 0;
+            session->count = mock_slot_events(chain, session->slot);
+        }
+        if (mock_event_due_ns(chain, session->slot, session->index, session->count) > now) {
+            return false;
+        }
+        YureiEventKind kind = mock_event_program(chain, session->slot, session->index);
+        if (kind < 64 && (session->mask & (1ULL << kind))) {
+            return true;
+        }
+        session->index++;
+    }
+}
+
+static bool build_message(MockWsServer *server, WsSession *session, uint64_t now) {
+    MockBuffer *msg = &session->message;
+    msg->len = 0;
+    session->sent = 0;
+    if (!mock_buffer_reserve(msg, LWS_PRE)) {
+        return false;
+    }
+    memset(msg->data, 0, LWS_PRE);
+    msg->len = LWS_PRE;
+
+    if (session->reply_count > 0) {
+        WsReply reply = session->replies[0];
+        memmove(session->replies, session->replies + 1,
+                (session->reply_count - 1) * sizeof(WsReply));
+        session->reply_count--;
+        if (reply.subscription) {
+            return mock_buffer_printf(msg, "{\"jsonrpc\":\"2.0\",\"result\":%" PRIu64 ",\"id\":%" PRIu64 "}",
+                                      reply.subscription, reply.id);
+        }
+        return mock_buffer_printf(msg, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32601,"
+                                       "\"message\":\"Method not found\"},\"id\":%" PRIu64 "}",
+                                  reply.id);
+    }
+
+    const MockChain *chain = server->chain;
+    if (!session->mask || !next_due_event(chain, session, now)) {
+        msg->len = 0;
+        return true;
+    }
+    uint64_t slot = session->slot;
+    uint32_t index = session->index++;
+    YureiEventKind kind = mock_event_program(chain, slot, index);
+    return mock_buffer_printf(msg, "{\"jsonrpc\":\"2.0\",\"method\":\"logsNotification\",\"params\":"
+                                   "{\"result\":{\"context\":{\"slot\":%" PRIu64 "},\"value\":{",
+                              slot) &&
+           mock_append_tx(msg, chain, slot, index) &&
+           mock_buffer_printf(msg, "}},\"subscription\":%" PRIu64 "}}", session->subscriptions[kind]);
+}
+
+// One frame per writeable callback, so a slow reader gets TCP backpressure
+static int write_next(struct lws *wsi, MockWsServer *server, WsSession *session) {
+    uint64_t now = mock_now_ns();
+    if (session->close_at_ns && now >= session->close_at_ns) {
+        static const char reason[] = "mock disconnect";
+        atomic_fetch_add_explicit(&server->stats->ws_disconnects, 1, memory_order_relaxed);
+        lws_close_reason(wsi, LWS_CLOSE_STATUS_GOINGAWAY, (unsigned char *)reason, sizeof(reason) - 1);
+        return -1;
+    }
+    MockBuffer *msg = &session->message;
+    bool continuing = msg->len > LWS_PRE && session->sent > 0;
+    if (!continuing) {
+        if (!build_message(server, session, now)) {
+            return -1;
+        }
+        if (msg->len <= LWS_PRE) {
+            return 0;
+        }
+    }
+
+    size_t payload = msg->len - LWS_PRE;
+    size_t chunk = payload - session->sent;
+    uint32_t fragment = server->options->ws_fragment;
+    if (fragment && chunk > fragment) {
+        chunk = fragment;
+    }
+    bool last = session->sent + chunk == payload;
+    int flags = continuing ? LWS_WRITE_CONTINUATION : LWS_WRITE_TEXT;
+    if (!last) {
+        flags |= LWS_WRITE_NO_FIN;
+    }
+    // lws may use the LWS_PRE bytes ahead of the chunk; mid-message those are
+    // already sent, so they are free to overwrite
+    unsigned char *start = (unsigned char *)msg->data + LWS_PRE + session->sent;
+    if (lws_write(wsi, start, chunk, (enum lws_write_protocol)flags) < (int)chunk) {
+        return -1;
+    }
+    session->sent += chunk;
+    if (last) {
+        atomic_fetch_add_explicit(&server->stats->ws_messages, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&server->stats->ws_bytes, payload, memory_order_relaxed);
+        msg->len = 0;
+        session->sent = 0;
+    }
+    lws_callback_on_writable(wsi);
+    return 0;
+}
+
+static int ws_callback(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len) {
+    WsSession *session = (WsSession *)user;
+    switch (reason) {
+    case LWS_CALLBACK_ESTABLISHED: {
+        MockWsServer *server = server_of(wsi);
+        memset(session, 0, sizeof(*session));
+        uint32_t disconnect_s = server->options->disconnect_s;
+        if (disconnect_s) {
+            // 75-125% of the interval so clients do not all drop together
+            uint64_t base = (uint64_t)disconnect_s * 1000000000ULL;
+            uint64_t jitter = mock_hash(server->chain->seed, (uint64_t)(uintptr_t)wsi, mock_now_ns()) %
+                              (base / 2 + 1);
+            session->close_at_ns = mock_now_ns() + base * 3 / 4 + jitter;
+        }
+        atomic_fetch_add_explicit(&server->stats->ws_clients, 1, memory_order_relaxed);
+        break;
+    }
+    case LWS_CALLBACK_RECEIVE:
+        handle_request(server_of(wsi), session, (const char *)in, len);
+        lws_callback_on_writable(wsi);
+        break;
+    case LWS_CALLBACK_SERVER_WRITEABLE:
+        return write_next(wsi, server_of(wsi), session);
+    case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+        // The tick thread woke the loop: let every session stream what fell due
+        lws_callback_on_writable_all_protocol(lws_get_context(wsi), &protocols[1]);
+        break;
+    case LWS_CALLBACK_CLOSED:
+        atomic_fetch_sub_explicit(&server_of(wsi)->stats->ws_clients, 1, memory_order_relaxed);
+        mock_buffer_free(&session->message);
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+static void *service_thread(void *arg) {
+    MockWsServer *server = (MockWsServer *)arg;
+    while (!atomic_load_explicit(&server->stop, memory_order_acquire)) {
+        lws_service((struct lws_context *)server->context, 0);
+    }
+    return NULL;
+}
+
+static void *tick_thread(void *arg) {
+    MockWsServer *server = (MockWsServer *)arg;
+    struct timespec tick = {0, WS_TICK_NS};
+    while (!atomic_load_explicit(&server->stop, memory_order_acquire)) {
+        nanosleep(&tick, NULL);
+        lws_cancel_service((struct lws_context *)server->context);
+    }
+    return NULL;
+}
+
+int mock_ws_start(MockWsServer *server, MockChain *chain, const MockServerOptions *options, MockStats *stats) {
+    if (!server || !chain || !options || !stats) {
+        return -1;
+    }
+    memset(server, 0, sizeof(*server));
+    if (options->ws_port == 0) {
+        return 0;
+    }
+    server->chain = chain;
+    server->options = options;
+    server->stats = stats;
+    atomic_init(&server->stop, false);
+
+    struct lws_context_creation_info info;
+    memset(&info, 0, sizeof(info));
+    info.port = options->ws_port;
+    info.iface = options->bind;
+    info.protocols = protocols;
+    info.user = server;
+    server->context = lws_create_context(&info);
+    if (!server->context) {
+        YUREI_LOG_ERROR("Unable to listen for WebSockets on %s:%u", options->bind, options->ws_port);
+        return -1;
+    }
+    if (pthread_create(&server->service_thread, NULL, service_thread, server) != 0) {
+        lws_context_destroy((struct lws_context *)server->context);
+        server->context = NULL;
+        return -1;
+    }
+    if (pthread_create(&server->tick_thread, NULL, tick_thread, server) != 0) {
+        atomic_store_explicit(&server->stop, true, memory_order_release);
+        lws_cancel_service((struct lws_context *)server->context);
+        pthread_join(server->service_thread, NULL);
+        lws_context_destroy((struct lws_context *)server->context);
+        server->context = NULL;
+        return -1;
+    }
+    server->running = true;
+    YUREI_LOG_INFO("Mock logsSubscribe listening on ws://%s:%u", options->bind, options->ws_port);
+    return 0;
+}
+
+void mock_ws_stop(MockWsServer *server) {
+    if (!server || !server->running) {
+        return;
+    }
+    atomic_store_explicit(&server->stop, true, memory_order_release);
+    pthread_join(server->tick_thread, NULL);
+    lws_cancel_service((struct lws_context *)server->context);
+    pthread_join(server->service_thread, NULL);
+    lws_context_destroy((struct lws_context *)server->context);
+    server->context = NULL;
+    server->running = false;
+}
@@ -4,7 +4,8 @@ CREATE TABLE IF NOT EXISTS pumpfun_trades (
     slot BIGINT NOT NULL,
     signature TEXT PRIMARY KEY,
     program_id TEXT,
-    raw_log BYTEA NOT NULL
+    raw_log BYTEA NOT NULL,
+    received_at TIMESTAMPTZ  -- filled when YUREI_DB_RECEIVED_AT is enabled
 );
 
 CREATE TABLE IF NOT EXISTS raydium_swaps (
@@ -12,5 +13,17 @@ CREATE TABLE IF NOT EXISTS raydium_swaps (
     slot BIGINT NOT NULL,
     signature TEXT PRIMARY KEY,
     program_id TEXT,
-    raw_log BYTEA NOT NULL
+    raw_log BYTEA NOT NULL,
+    received_at TIMESTAMPTZ  -- filled when YUREI_DB_RECEIVED_AT is enabled
 );
+
+-- Tables created before received_at existed
+ALTER TABLE pumpfun_trades ADD COLUMN IF NOT EXISTS received_at TIMESTAMPTZ;
+ALTER TABLE raydium_swaps ADD COLUMN IF NOT EXISTS received_at TIMESTAMPTZ;
+
+-- Unlogged staging tables used by YUREI_DB_WRITE_MODE=copy. The writer creates
+-- them on connect if missing; they are listed here for roles without CREATE.
+CREATE UNLOGGED TABLE IF NOT EXISTS pumpfun_trades_staging (LIKE pumpfun_trades INCLUDING DEFAULTS);
+CREATE UNLOGGED TABLE IF NOT EXISTS raydium_swaps_staging (LIKE raydium_swaps INCLUDING DEFAULTS);
+ALTER TABLE pumpfun_trades_staging ADD COLUMN IF NOT EXISTS received_at TIMESTAMPTZ;
+ALTER TABLE raydium_swaps_staging ADD COLUMN IF NOT EXISTS received_at TIMESTAMPTZ;
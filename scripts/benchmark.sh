@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+# Build and run the yurei-bench suite, saving results as CSV and optionally
+# comparing against a previous run.
+# Usage: scripts/benchmark.sh [.env] [baseline.csv]
+#   BUILD_DIR   build tree (default: build-bench)
+#   RESULTS_DIR where CSV snapshots go (default: bench-results)
+#   THRESHOLD   allowed ns/op regression in percent (default: 10)
+#   BENCH_ARGS  extra yurei-bench flags, e.g. "--filter parser --repeat 9"
+set -euo pipefail
+
+CONFIG_FILE=${1:-.env}
+BASELINE=${2:-}
+BUILD_DIR=${BUILD_DIR:-build-bench}
+RESULTS_DIR=${RESULTS_DIR:-bench-results}
+THRESHOLD=${THRESHOLD:-10}
+BENCH_ARGS=${BENCH_ARGS:-}
+
+if [[ ! -f "${CONFIG_FILE}" ]]; then
+    echo "Config file ${CONFIG_FILE} not found; using built-in defaults" >&2
+fi
+if [[ -n "${BASELINE}" && ! -f "${BASELINE}" ]]; then
+    echo "Baseline ${BASELINE} not found" >&2
+    exit 1
+fi
+
+cmake -S . -B "${BUILD_DIR}" -DCMAKE_BUILD_TYPE=Release -DYUREI_BUILD_BENCH=ON >/dev/null
+cmake --build "${BUILD_DIR}" --target yurei-bench -j"$(nproc)" >/dev/null
+
+mkdir -p "${RESULTS_DIR}"
+REVISION=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+OUTPUT="${RESULTS_DIR}/$(date +%Y%m%d-%H%M%S)-${REVISION}.csv"
+
+# shellcheck disable=SC2086
+"${BUILD_DIR}/yurei-bench" -c "${CONFIG_FILE}" --csv ${BENCH_ARGS} 2>/dev/null > "${OUTPUT}"
+column -s, -t < "${OUTPUT}"
+echo "Results written to ${OUTPUT}"
+
+if [[ -z "${BASELINE}" ]]; then
+    exit 0
+fi
+
+echo
+echo "-- Comparison against ${BASELINE} (threshold ${THRESHOLD}%) --"
+awk -F, -v threshold="${THRESHOLD}" '
+    FNR == 1 { next }
+    NR == FNR { base[$1] = $3; next }
+    ($1 in base) && base[$1] > 0 {
+        delta = ($3 - base[$1]) / base[$1] * 100
+        flag = delta > threshold ? "REGRESSION" : ""
+        printf "%-36s %12.1f -> %12.1f ns/op %+7.1f%% %s\n", $1, base[$1], $3, delta, flag
+        if (flag != "") regressions++
+    }
+    END {
+        if (regressions > 0) {
+            printf "%d benchmark(s) regressed by more than %s%%\n", regressions, threshold
+            exit 1
+        }
+    }
+' "${BASELINE}" "${OUTPUT}"
@@ -0,0 +1,307 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "base64.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define YUREI_BASE64_X86 1
+#endif
+
+// Sextet value per input byte, -1 outside the alphabet ('=' included)
+static const int8_t decode_table[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,};
+
+// Decode a whole number of vector blocks; returns the input bytes consumed.
+// Stops early at the first block holding a non-alphabet byte (padding,
+// garbage) or when the output lacks room for a full register store.
+typedef size_t (*DecodeBlocksFn)(const uint8_t *in, size_t len, uint8_t *out, size_t out_cap,
+                                 size_t *written);
+
+static size_t decode_blocks_none(const uint8_t *in, size_t len, uint8_t *out, size_t out_cap,
+                                 size_t *written) {
+    (void)in;
+    (void)len;
+    (void)out;
+    (void)out_cap;
+    *written = 0;
+    return 0;
+}
+
+#ifdef YUREI_BASE64_X86
+
+// Validation and translation follow the nibble-lookup scheme of Muła and
+// Lemire: a byte is valid iff lut_lo[low nibble] & lut_hi[high nibble] == 0,
+// and the sextet is byte + lut_roll[high nibble (+ -1 for '/')]. The packing
+// step merges sextet pairs with maddubs, then pairs of 12-bit fields with madd.
+
+__attribute__((target("sse4.1")))
+static size_t decode_blocks_sse41(const uint8_t *in, size_t len, uint8_t *out, size_t out_cap,
+                                  size_t *written) {
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+    const __m128i pack_pairs = _mm_set1_epi32(0x01400140);
+    const __m128i pack_quads = _mm_set1_epi32(0x00011000);
+    const __m128i reshuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                            -1, -1, -1, -1);
+
+    size_t consumed = 0;
+    size_t produced = 0;
+    while (len - consumed >= 16 && out_cap - produced >= 16) {
+        __m128i str = _mm_loadu_si128((const __m128i *)(in + consumed));
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm_testz_si128(lo, hi)) {
+            break;
+        }
+        __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+        str = _mm_add_epi8(str, roll);
+
+        str = _mm_maddubs_epi16(str, pack_pairs);
+        str = _mm_madd_epi16(str, pack_quads);
+        str = _mm_shuffle_epi8(str, reshuffle);
+        _mm_storeu_si128((__m128i *)(out + produced), str);
+
+        consumed += 16;
+        produced += 12;
+    }
+    *written = produced;
+    return consumed;
+}
+
+__attribute__((target("avx2")))
+static size_t decode_blocks_avx2(const uint8_t *in, size_t len, uint8_t *out, size_t out_cap,
+                                 size_t *written) {
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+    const __m256i pack_pairs = _mm256_set1_epi32(0x01400140);
+    const __m256i pack_quads = _mm256_set1_epi32(0x00011000);
+    const __m256i reshuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                               -1, -1, -1, -1,
+                                               2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                               -1, -1, -1, -1);
+    // Gather the 12 valid bytes of each 128-bit lane into 24 contiguous bytes
+    const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+    size_t consumed = 0;
+    size_t produced = 0;
+    while (len - consumed >= 32 && out_cap - produced >= 32) {
+        __m256i str = _mm256_loadu_si256((const __m256i *)(in + consumed));
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+        __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        str = _mm256_maddubs_epi16(str, pack_pairs);
+        str = _mm256_madd_epi16(str, pack_quads);
+        str = _mm256_shuffle_epi8(str, reshuffle);
+        str = _mm256_permutevar8x32_epi32(str, compact);
+        _mm256_storeu_si256((__m256i *)(out + produced), str);
+
+        consumed += 32;
+        produced += 24;
+    }
+
+    // The SSE kernel is legacy-encoded: clear the upper halves first or every
+    // SSE instruction after the 256-bit loop pays a state-transition penalty
+    _mm256_zeroupper();
+
+    // Finish any 16-byte remainder with the SSE kernel
+    size_t tail_written = 0;
+    consumed += decode_blocks_sse41(in + consumed, len - consumed, out + produced,
+                                    out_cap - produced, &tail_written);
+    *written = produced + tail_written;
+    return consumed;
+}
+
+#endif // YUREI_BASE64_X86
+
+static YureiBase64Impl g_impl = YUREI_BASE64_SCALAR;
+static DecodeBlocksFn g_decode_blocks = decode_blocks_none;
+
+static bool cpu_supports(YureiBase64Impl impl) {
+    switch (impl) {
+        case YUREI_BASE64_SCALAR:
+            return true;
+#ifdef YUREI_BASE64_X86
+        case YUREI_BASE64_SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case YUREI_BASE64_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+bool yurei_base64_select(YureiBase64Impl impl) {
+    if (!cpu_supports(impl)) {
+        return false;
+    }
+    switch (impl) {
+#ifdef YUREI_BASE64_X86
+        case YUREI_BASE64_SSE41:
+            g_decode_blocks = decode_blocks_sse41;
+            break;
+        case YUREI_BASE64_AVX2:
+            g_decode_blocks = decode_blocks_avx2;
+            break;
+#endif
+        default:
+            g_decode_blocks = decode_blocks_none;
+            break;
+    }
+    g_impl = impl;
+    return true;
+}
+
+// Resolve once before main so the hot path is a plain indirect call
+__attribute__((constructor))
+static void dispatch_init(void) {
+#ifdef YUREI_BASE64_X86
+    __builtin_cpu_init();
+#endif
+    if (!yurei_base64_select(YUREI_BASE64_AVX2) && !yurei_base64_select(YUREI_BASE64_SSE41)) {
+        yurei_base64_select(YUREI_BASE64_SCALAR);
+    }
+}
+
+YureiBase64Impl yurei_base64_active_impl(void) {
+    return g_impl;
+}
+
+const char *yurei_base64_impl_name(YureiBase64Impl impl) {
+    switch (impl) {
+        case YUREI_BASE64_AVX2:
+            return "avx2";
+        case YUREI_BASE64_SSE41:
+            return "sse4.1";
+        case YUREI_BASE64_SCALAR:
+        default:
+            return "scalar";
+    }
+}
+
+size_t yurei_base64_decoded_max(size_t len) {
+    return (len / 4) * 3 + 3;
+}
+
+// Decode one padded or unpadded chunk
+static bool decode_chunk(const uint8_t *in, size_t len, uint8_t *out, size_t out_cap,
+                         size_t *out_len) {
+    size_t padding = 0;
+    while (len > 0 && padding < 2 && in[len - 1] == '=') {
+        len--;
+        padding++;
+    }
+    if ((padding > 0 && (len + padding) % 4 != 0) || len % 4 == 1) {
+        return false;
+    }
+
+    size_t produced = 0;
+    size_t consumed = g_decode_blocks(in, len, out, out_cap, &produced);
+
+    for (; len - consumed >= 4; consumed += 4) {
+        int32_t a = decode_table[in[consumed]];
+        int32_t b = decode_table[in[consumed + 1]];
+        int32_t c = decode_table[in[consumed + 2]];
+        int32_t d = decode_table[in[consumed + 3]];
+        if ((a | b | c | d) < 0 || out_cap - produced < 3) {
+            return false;
+        }
+        uint32_t triple = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) |
+                          (uint32_t)d;
+        out[produced++] = (uint8_t)(triple >> 16);
+        out[produced++] = (uint8_t)(triple >> 8);
+        out[produced++] = (uint8_t)triple;
+    }
+
+    size_t rem = len - consumed;
+    if (rem >= 2) {
+        int32_t a = decode_table[in[consumed]];
+        int32_t b = decode_table[in[consumed + 1]];
+        int32_t c = rem == 3 ? decode_table[in[consumed + 2]] : 0;
+        if ((a | b | c) < 0 || out_cap - produced < rem - 1) {
+            return false;
+        }
+        uint32_t triple = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6);
+        out[produced++] = (uint8_t)(triple >> 16);
+        if (rem == 3) {
+            out[produced++] = (uint8_t)(triple >> 8);
+        }
+    }
+    *out_len = produced;
+    return true;
+}
+
+bool yurei_base64_decode(const char *input,
+                         size_t len,
+                         uint8_t *output,
+                         size_t out_cap,
+                         size_t *out_len) {
+    if (!input || !output || !out_len) {
+        return false;
+    }
+    const uint8_t *in = (const uint8_t *)input;
+    const uint8_t *end = in + len;
+    size_t produced = 0;
+    while (in < end) {
+        if (*in == ' ') {
+            in++;
+            continue;
+        }
+        const uint8_t *space = memchr(in, ' ', (size_t)(end - in));
+        const uint8_t *chunk_end = space ? space : end;
+        size_t written = 0;
+        if (!decode_chunk(in, (size_t)(chunk_end - in), output + produced,
+                          out_cap - produced, &written)) {
+            return false;
+        }
+        produced += written;
+        in = chunk_end;
+    }
+    *out_len = produced;
+    return true;
+}
@@ -0,0 +1,226 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "capture.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "json_scan.h"
+#include "logging.h"
+#include "metrics.h"
+#include "parser.h"
+
+#define CAPTURE_MAGIC "YUREICP1"
+// stdio buffer; flushed when full and on close
+#define CAPTURE_BUFFER_BYTES (1u << 20)
+// Longest uninterrupted sleep while pacing, so a stop request is seen promptly
+#define REPLAY_SLEEP_MAX_NS 100000000ULL
+
+typedef struct {
+    char magic[8];
+    uint64_t start_unix_ns;
+} CaptureFileHeader;
+
+typedef struct {
+    uint64_t offset_ns;
+    uint32_t length;
+    uint8_t source;
+    uint8_t reserved[3];
+} CaptureRecord;
+
+_Static_assert(sizeof(CaptureFileHeader) == 16, "capture header layout");
+_Static_assert(sizeof(CaptureRecord) == 16, "capture record layout");
+
+int yurei_capture_open(YureiCapture *capture, const char *path) {
+    if (!capture || !path || !*path) {
+        return -1;
+    }
+    memset(capture, 0, sizeof(*capture));
+    capture->file = fopen(path, "wb");
+    if (!capture->file) {
+        YUREI_LOG_ERROR("Unable to create capture file %s: %s", path, strerror(errno));
+        return -1;
+    }
+    setvbuf(capture->file, NULL, _IOFBF, CAPTURE_BUFFER_BYTES);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    CaptureFileHeader header;
+    memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.start_unix_ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    if (fwrite(&header, sizeof(header), 1, capture->file) != 1 ||
+        pthread_mutex_init(&capture->lock, NULL) != 0) {
+        fclose(capture->file);
+        capture->file = NULL;
+        return -1;
+    }
+    capture->start_ns = yurei_now_ns();
+    YUREI_LOG_INFO("Recording raw RPC traffic to %s", path);
+    return 0;
+}
+
+void yurei_capture_record(YureiCapture *capture,
+                          YureiCaptureSource source,
+                          const char *data,
+                          size_t len) {
+    if (!capture || !capture->file || !data || len > UINT32_MAX) {
+        return;
+    }
+    CaptureRecord record = {0};
+    record.length = (uint32_t)len;
+    record.source = (uint8_t)source;
+
+    pthread_mutex_lock(&capture->lock);
+    if (!capture->failed) {
+        // Taken under the lock so offsets never go backwards in the file
+        record.offset_ns = yurei_now_ns() - capture->start_ns;
+        if (fwrite(&record, sizeof(record), 1, capture->file) == 1 &&
+            fwrite(data, 1, len, capture->file) == len) {
+            capture->records++;
+            capture->bytes += len;
+        } else {
+            YUREI_LOG_ERROR("Capture write failed (%s); recording stopped", strerror(errno));
+            capture->failed = true;
+        }
+    }
+    pthread_mutex_unlock(&capture->lock);
+}
+
+void yurei_capture_close(YureiCapture *capture) {
+    if (!capture || !capture->file) {
+        return;
+    }
+    if (fclose(capture->file) != 0 && !capture->failed) {
+        YUREI_LOG_ERROR("Capture file flush failed: %s", strerror(errno));
+    }
+    capture->file = NULL;
+    pthread_mutex_destroy(&capture->lock);
+    YUREI_LOG_INFO("Capture closed: %" PRIu64 " messages, %" PRIu64 " bytes",
+                   capture->records, capture->bytes);
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+// Sleep until the monotonic deadline, in slices so *stop is honoured
+static void sleep_until(uint64_t deadline_ns, const volatile sig_atomic_t *stop) {
+    for (;;) {
+        uint64_t now = yurei_now_ns();
+        if (now >= deadline_ns || (stop && *stop)) {
+            return;
+        }
+        uint64_t wait = deadline_ns - now;
+        if (wait > REPLAY_SLEEP_MAX_NS) {
+            wait = REPLAY_SLEEP_MAX_NS;
+        }
+        struct timespec ts = {(time_t)(wait / 1000000000ULL), (long)(wait % 1000000000ULL)};
+        nanosleep(&ts, NULL);
+    }
+}
+
+static uint64_t replay_message(const char *json,
+                               size_t len,
+                               YureiCaptureSource source,
+                               const YureiConfig *config,
+                               const YureiPipeline *pipeline) {
+    if (source != YUREI_CAPTURE_HTTP) {
+        int processed = yurei_parser_handle_buffer(json, len, config, pipeline, NULL);
+        return processed > 0 ? (uint64_t)processed : 0;
+    }
+    // A batch reply: one parse per call, as the poller does
+    uint64_t events = 0;
+    YureiJsonScanner sc;
+    yurei_json_init(&sc, json, len);
+    if (yurei_json_peek(&sc) != YUREI_JSON_ARRAY || !yurei_json_array_begin(&sc)) {
+        return 0;
+    }
+    while (yurei_json_array_next(&sc) > 0) {
+        yurei_json_peek(&sc);
+        const char *element = sc.cur;
+        if (!yurei_json_skip_value(&sc)) {
+            break;
+        }
+        int processed = yurei_parser_handle_buffer(element, (size_t)(sc.cur - element),
+                                                   config, pipeline, NULL);
+        if (processed > 0) {
+            events += (uint64_t)processed;
+        }
+    }
+    return events;
+}
+
+int yurei_capture_replay(const char *path,
+                         const YureiConfig *config,
+                         const YureiPipeline *pipeline,
+                         bool paced,
+                         const volatile sig_atomic_t *stop,
+                         YureiReplayStats *stats) {
+    if (!path || !config || !pipeline) {
+        return -1;
+    }
+    YureiReplayStats local = {0};
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        YUREI_LOG_ERROR("Unable to open capture %s: %s", path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    const uint8_t *map = size >= sizeof(CaptureFileHeader)
+                             ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                             : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED || memcmp(map, CAPTURE_MAGIC, 8) != 0) {
+        YUREI_LOG_ERROR("%s is not a Yurei capture file", path);
+        if (map != MAP_FAILED) {
+            munmap((void *)map, size);
+        }
+        return -1;
+    }
+    madvise((void *)map, size, MADV_SEQUENTIAL);
+
+    YUREI_LOG_INFO("Replaying %s (%zu bytes, %s)", path, size, paced ? "original pacing" : "max speed");
+    uint64_t start = yurei_now_ns();
+    size_t offset = sizeof(CaptureFileHeader);
+    while (offset + sizeof(CaptureRecord) <= size && !(stop && *stop)) {
+        CaptureRecord record;
+        memcpy(&record, map + offset, sizeof(record));
+        offset += sizeof(record);
+        if (record.length > size - offset) {
+            YUREI_LOG_WARN("Capture truncated after %" PRIu64 " messages", local.messages);
+            break;
+        }
+        if (paced) {
+            sleep_until(start + record.offset_ns, stop);
+        }
+        local.events += replay_message((const char *)map + offset, record.length,
+                                       (YureiCaptureSource)record.source, config, pipeline);
+        local.messages++;
+        local.bytes += record.length;
+        offset += record.length;
+    }
+    local.elapsed_ns = yurei_now_ns() - start;
+    munmap((void *)map, size);
+
+    double seconds = (double)local.elapsed_ns / 1e9;
+    YUREI_LOG_INFO("Replay done: %" PRIu64 " messages, %" PRIu64 " events, %.2f MB in %.3f s "
+                   "(%.0f msg/s, %.0f events/s)",
+                   local.messages, local.events, (double)local.bytes / 1e6, seconds,
+                   seconds > 0 ? (double)local.messages / seconds : 0.0,
+                   seconds > 0 ? (double)local.events / seconds : 0.0);
+    if (stats) {
+        *stats = local;
+    }
+    return 0;
+}
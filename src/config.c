@@ -4,6 +4,7 @@
 #include "config.h"
 
 #include <ctype.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -49,11 +50,32 @@ static void apply_defaults(YureiConfig *config) {
     config->rpc_api_key[0] = '\0';  // No API key by default
     copy_string(config->rpc_mode, sizeof(config->rpc_mode), YUREI_RPC_MODE_WS);
     config->poll_interval_ms = 1000;
+    config->http_max_inflight = 4;  // Concurrent HTTP requests (each a JSON-RPC batch)
+    config->http_slot_span = 4;  // Slots covered by each getLogs call in a batch
+    config->http_start_slot = 0;  // 0 = start at the current tip
     config->ws_backoff_ms = 1000;
     config->ws_backoff_max_ms = 60000;
+    config->ws_hedge_window_ms = 5000;  // How long a signature counts as seen across endpoints
     config->queue_capacity = 1024;
     config->batch_size = 20;  // Optimized for JSON-RPC batch calls
+    config->db_linger_ms = 50;  // Max wait to fill a DB batch
+    copy_string(config->db_write_mode, sizeof(config->db_write_mode), YUREI_DB_MODE_INSERT);
+    config->db_merge_interval_ms = 1000;  // Staging -> target merge cadence (copy mode)
+    config->db_writers = 1;  // Writer threads, one connection each
+    config->db_received_at = false;  // Tables need a received_at column when enabled
+    config->spill_dir[0] = '\0';  // On-disk queue overflow off by default
+    config->spill_max_bytes = 4ULL * 1024 * 1024 * 1024;
+    config->parser_threads = 2;  // Workers parsing raw WebSocket messages
+    config->parser_buffer_bytes = 8u * 1024u * 1024u;  // Raw message backlog
+    config->parser_drop_when_full = false;  // Full backlog stalls the socket
+    config->dedup_entries = 262144;  // Recently enqueued (signature, log) keys; 0 disables
+    config->dedup_window_slots = 300;  // ~2 minutes of slots
     config->rate_limit_rps = 10;  // Default 10 requests/second
+    config->capture_file[0] = '\0';  // No traffic recording by default
+    config->replay_file[0] = '\0';
+    copy_string(config->replay_pace, sizeof(config->replay_pace), YUREI_REPLAY_PACE_ORIGINAL);
+    config->metrics_port = 0;  // OpenMetrics endpoint off by default
+    copy_string(config->metrics_bind, sizeof(config->metrics_bind), "127.0.0.1");
     config->log_color = true;  // ANSI colors enabled by default
     copy_string(config->pumpfun_program, sizeof(config->pumpfun_program),
                 "6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P");
@@ -111,11 +133,22 @@ static void set_numeric_size(size_t *field, const char *value) {
     }
 }
 
+static void set_numeric_uint64(uint64_t *field, const char *value) {
+    if (!field || !value || !*value) {
+        return;
+    }
+    char *end = NULL;
+    unsigned long long parsed = strtoull(value, &end, 10);
+    if (end && *end == '\0') {
+        *field = (uint64_t)parsed;
+    }
+}
+
 static void apply_key_value(YureiConfig *config, const char *key, const char *value) {
     if (!config || !key || !value) {
         return;
     }
-    char unquoted[512];
+    char unquoted[YUREI_CONFIG_LINE_MAX];
     const char *normalized = strip_quotes(value, unquoted, sizeof(unquoted));
 
     if (strcasecmp(key, "YUREI_RPC_ENDPOINT") == 0) {
@@ -126,18 +159,71 @@ static void apply_key_value(YureiConfig *config, const char *key, const char *va
         copy_string(config->rpc_mode, sizeof(config->rpc_mode), normalized);
     } else if (strcasecmp(key, "YUREI_POLL_INTERVAL_MS") == 0) {
         set_numeric_uint32(&config->poll_interval_ms, normalized);
+    } else if (strcasecmp(key, "YUREI_HTTP_MAX_INFLIGHT") == 0) {
+        set_numeric_uint32(&config->http_max_inflight, normalized);
+        if (config->http_max_inflight == 0) {
+            config->http_max_inflight = 1;
+        } else if (config->http_max_inflight > YUREI_HTTP_INFLIGHT_MAX) {
+            config->http_max_inflight = YUREI_HTTP_INFLIGHT_MAX;
+        }
+    } else if (strcasecmp(key, "YUREI_HTTP_SLOT_SPAN") == 0) {
+        set_numeric_uint32(&config->http_slot_span, normalized);
+        if (config->http_slot_span == 0) {
+            config->http_slot_span = 1;
+        }
+    } else if (strcasecmp(key, "YUREI_HTTP_START_SLOT") == 0) {
+        set_numeric_uint64(&config->http_start_slot, normalized);
     } else if (strcasecmp(key, "YUREI_WS_BACKOFF_MS") == 0) {
         set_numeric_uint32(&config->ws_backoff_ms, normalized);
     } else if (strcasecmp(key, "YUREI_WS_BACKOFF_MAX_MS") == 0) {
         set_numeric_uint32(&config->ws_backoff_max_ms, normalized);
+    } else if (strcasecmp(key, "YUREI_WS_HEDGE_WINDOW_MS") == 0) {
+        set_numeric_uint32(&config->ws_hedge_window_ms, normalized);
     } else if (strcasecmp(key, "YUREI_QUEUE_CAPACITY") == 0) {
         set_numeric_size(&config->queue_capacity, normalized);
     } else if (strcasecmp(key, "YUREI_BATCH_SIZE") == 0) {
         set_numeric_uint32(&config->batch_size, normalized);
+    } else if (strcasecmp(key, "YUREI_DB_LINGER_MS") == 0) {
+        set_numeric_uint32(&config->db_linger_ms, normalized);
+    } else if (strcasecmp(key, "YUREI_DB_WRITE_MODE") == 0) {
+        copy_string(config->db_write_mode, sizeof(config->db_write_mode), normalized);
+    } else if (strcasecmp(key, "YUREI_DB_MERGE_INTERVAL_MS") == 0) {
+        set_numeric_uint32(&config->db_merge_interval_ms, normalized);
+    } else if (strcasecmp(key, "YUREI_DB_RECEIVED_AT") == 0) {
+        config->db_received_at = (strcasecmp(normalized, "1") == 0 ||
+                                  strcasecmp(normalized, "true") == 0 ||
+                                  strcasecmp(normalized, "yes") == 0);
+    } else if (strcasecmp(key, "YUREI_PARSER_THREADS") == 0) {
+        set_numeric_uint32(&config->parser_threads, normalized);
+        if (config->parser_threads == 0) {
+            config->parser_threads = 1;
+        }
+    } else if (strcasecmp(key, "YUREI_PARSER_BUFFER_BYTES") == 0) {
+        set_numeric_size(&config->parser_buffer_bytes, normalized);
+    } else if (strcasecmp(key, "YUREI_PARSER_DROP_WHEN_FULL") == 0) {
+        config->parser_drop_when_full = (strcasecmp(normalized, "1") == 0 ||
+                                         strcasecmp(normalized, "true") == 0 ||
+                                         strcasecmp(normalized, "yes") == 0);
+    } else if (strcasecmp(key, "YUREI_DEDUP_ENTRIES") == 0) {
+        set_numeric_size(&config->dedup_entries, normalized);
+    } else if (strcasecmp(key, "YUREI_DEDUP_WINDOW_SLOTS") == 0) {
+        set_numeric_uint32(&config->dedup_window_slots, normalized);
+        if (config->dedup_window_slots == 0) {
+            config->dedup_window_slots = 1;
+        }
+    } else if (strcasecmp(key, "YUREI_DB_WRITERS") == 0) {
+        set_numeric_uint32(&config->db_writers, normalized);
+        if (config->db_writers == 0) {
+            config->db_writers = 1;
+        } else if (config->db_writers > YUREI_DB_WRITERS_MAX) {
+            config->db_writers = YUREI_DB_WRITERS_MAX;
+        }
     } else if (strcasecmp(key, "YUREI_PUMPFUN_PROGRAM") == 0) {
         copy_string(config->pumpfun_program, sizeof(config->pumpfun_program), normalized);
     } else if (strcasecmp(key, "YUREI_RAYDIUM_PROGRAM") == 0) {
         copy_string(config->raydium_program, sizeof(config->raydium_program), normalized);
+    } else if (strcasecmp(key, "YUREI_PROGRAMS") == 0) {
+        copy_string(config->programs_spec, sizeof(config->programs_spec), normalized);
     } else if (strcasecmp(key, "YUREI_PUMPFUN_TABLE") == 0) {
         copy_string(config->pumpfun_table, sizeof(config->pumpfun_table), normalized);
     } else if (strcasecmp(key, "YUREI_RAYDIUM_TABLE") == 0) {
@@ -151,6 +237,23 @@ static void apply_key_value(YureiConfig *config, const char *key, const char *va
         copy_string(config->rpc_api_key, sizeof(config->rpc_api_key), normalized);
     } else if (strcasecmp(key, "YUREI_RATE_LIMIT") == 0) {
         set_numeric_uint32(&config->rate_limit_rps, normalized);
+    } else if (strcasecmp(key, "YUREI_SPILL_DIR") == 0) {
+        copy_string(config->spill_dir, sizeof(config->spill_dir), normalized);
+    } else if (strcasecmp(key, "YUREI_SPILL_MAX_BYTES") == 0) {
+        set_numeric_uint64(&config->spill_max_bytes, normalized);
+    } else if (strcasecmp(key, "YUREI_CAPTURE_FILE") == 0) {
+        copy_string(config->capture_file, sizeof(config->capture_file), normalized);
+    } else if (strcasecmp(key, "YUREI_REPLAY_FILE") == 0) {
+        copy_string(config->replay_file, sizeof(config->replay_file), normalized);
+    } else if (strcasecmp(key, "YUREI_REPLAY_PACE") == 0) {
+        copy_string(config->replay_pace, sizeof(config->replay_pace), normalized);
+    } else if (strcasecmp(key, "YUREI_METRICS_PORT") == 0) {
+        set_numeric_uint32(&config->metrics_port, normalized);
+        if (config->metrics_port > 65535) {
+            config->metrics_port = 0;
+        }
+    } else if (strcasecmp(key, "YUREI_METRICS_BIND") == 0) {
+        copy_string(config->metrics_bind, sizeof(config->metrics_bind), normalized);
     } else if (strcasecmp(key, "YUREI_LOG_COLOR") == 0) {
         config->log_color = (strcasecmp(normalized, "1") == 0 ||
                              strcasecmp(normalized, "true") == 0 ||
@@ -165,14 +268,36 @@ static void apply_environment_overrides(YureiConfig *config) {
         "YUREI_RPC_API_KEY",
         "YUREI_RPC_MODE",
         "YUREI_POLL_INTERVAL_MS",
+        "YUREI_HTTP_MAX_INFLIGHT",
+        "YUREI_HTTP_SLOT_SPAN",
+        "YUREI_HTTP_START_SLOT",
         "YUREI_WS_BACKOFF_MS",
         "YUREI_WS_BACKOFF_MAX_MS",
+        "YUREI_WS_HEDGE_WINDOW_MS",
         "YUREI_QUEUE_CAPACITY",
         "YUREI_BATCH_SIZE",
+        "YUREI_DB_LINGER_MS",
+        "YUREI_DB_WRITE_MODE",
+        "YUREI_DB_MERGE_INTERVAL_MS",
+        "YUREI_DB_RECEIVED_AT",
+        "YUREI_DB_WRITERS",
+        "YUREI_SPILL_DIR",
+        "YUREI_SPILL_MAX_BYTES",
+        "YUREI_PARSER_THREADS",
+        "YUREI_PARSER_BUFFER_BYTES",
+        "YUREI_PARSER_DROP_WHEN_FULL",
+        "YUREI_DEDUP_ENTRIES",
+        "YUREI_DEDUP_WINDOW_SLOTS",
         "YUREI_RATE_LIMIT",
+        "YUREI_CAPTURE_FILE",
+        "YUREI_REPLAY_FILE",
+        "YUREI_REPLAY_PACE",
+        "YUREI_METRICS_PORT",
+        "YUREI_METRICS_BIND",
         "YUREI_LOG_COLOR",
         "YUREI_PUMPFUN_PROGRAM",
         "YUREI_RAYDIUM_PROGRAM",
+        "YUREI_PROGRAMS",
         "YUREI_PG_CONN",
         "YUREI_PG_CONNINFO",
         "YUREI_PUMPFUN_TABLE",
@@ -199,8 +324,8 @@ static void load_env_file(const char *path, YureiConfig *config) {
         return;
     }
 
-    char line[512];
-    char trimmed[512];
+    char line[YUREI_CONFIG_LINE_MAX];
+    char trimmed[YUREI_CONFIG_LINE_MAX];
     while (fgets(line, sizeof(line), fp)) {
         const char *clean = trim(line, trimmed, sizeof(trimmed));
         if (!clean || clean[0] == '\0' || clean[0] == '#') {
@@ -239,6 +364,46 @@ static void configure_log_level(const YureiConfig *config) {
     } else {
         yurei_log_set_level(YUREI_LOG_ERROR);
     }
+    if ((int)yurei_log_threshold < YUREI_LOG_COMPILE_LEVEL) {
+        YUREI_LOG_WARN("YUREI_LOG_LEVEL=%s is below the level compiled in; rebuild with "
+                       "-DYUREI_LOG_COMPILE_LEVEL=%s to see those lines",
+                       config->log_level, config->log_level);
+    }
+}
+
+static int build_program_registry(YureiConfig *config) {
+    YureiProgramRegistry *registry = &config->programs;
+    yurei_program_registry_init(registry);
+    if (config->programs_spec[0]) {
+        if (yurei_program_registry_parse(registry, config->programs_spec) != 0) {
+            return -1;
+        }
+    } else {
+        // Legacy two-program configuration. An empty table has always meant
+        // "do not write this program", so such a program is left out rather
+        // than given a default table.
+        if (config->pumpfun_program[0] && !config->pumpfun_table[0]) {
+            YUREI_LOG_INFO("YUREI_PUMPFUN_TABLE is empty; PumpFun events are not recorded");
+        } else if (config->pumpfun_program[0] &&
+                   yurei_program_registry_add(registry, "pumpfun", config->pumpfun_program,
+                                              config->pumpfun_table) != 0) {
+            YUREI_LOG_ERROR("Invalid PumpFun program or table");
+            return -1;
+        }
+        if (config->raydium_program[0] && !config->raydium_table[0]) {
+            YUREI_LOG_INFO("YUREI_RAYDIUM_TABLE is empty; Raydium events are not recorded");
+        } else if (config->raydium_program[0] &&
+                   yurei_program_registry_add(registry, "raydium", config->raydium_program,
+                                              config->raydium_table) != 0) {
+            YUREI_LOG_ERROR("Invalid Raydium program or table");
+            return -1;
+        }
+    }
+    if (registry->count == 0) {
+        YUREI_LOG_ERROR("No programs configured");
+        return -1;
+    }
+    return yurei_program_registry_build(registry);
 }
 
 int yurei_config_load(const char *path, YureiConfig *config) {
@@ -255,6 +420,9 @@ int yurei_config_load(const char *path, YureiConfig *config) {
 
     apply_environment_overrides(config);
     configure_log_level(config);
+    if (build_program_registry(config) != 0) {
+        return -1;
+    }
     yurei_config_print(config);
     return 0;
 }
@@ -266,10 +434,38 @@ void yurei_config_print(const YureiConfig *config) {
     YUREI_LOG_INFO("RPC endpoint: %s", config->rpc_endpoint);
     YUREI_LOG_INFO("WSS endpoint: %s", config->wss_endpoint);
     YUREI_LOG_INFO("Mode: %s", config->rpc_mode);
-    YUREI_LOG_INFO("Poll interval: %u ms", config->poll_interval_ms);
+    YUREI_LOG_INFO("Poll interval: %u ms | HTTP in flight: %u | Slot span: %u",
+                   config->poll_interval_ms, config->http_max_inflight, config->http_slot_span);
     YUREI_LOG_INFO("Queue capacity: %zu", config->queue_capacity);
-    YUREI_LOG_INFO("Batch size: %u", config->batch_size);
-    YUREI_LOG_INFO("DB tables: pumpfun=%s raydium=%s",
-                   config->pumpfun_table,
-                   config->raydium_table);
+    YUREI_LOG_INFO("Parser threads: %u | Parser buffer: %zu bytes | When full: %s",
+                   config->parser_threads, config->parser_buffer_bytes,
+                   config->parser_drop_when_full ? "drop" : "wait");
+    YUREI_LOG_INFO("Dedup entries: %zu | Dedup window: %u slots",
+                   config->dedup_entries, config->dedup_window_slots);
+    YUREI_LOG_INFO("Batch size: %u | DB linger: %u ms",
+                   config->batch_size, config->db_linger_ms);
+    YUREI_LOG_INFO("DB write mode: %s | DB writers: %u | received_at: %s",
+                   config->db_write_mode, config->db_writers,
+                   config->db_received_at ? "on" : "off");
+    if (config->spill_dir[0]) {
+        YUREI_LOG_INFO("Spill dir: %s | Spill cap: %" PRIu64 " MiB",
+                       config->spill_dir, config->spill_max_bytes >> 20);
+    }
+    if (config->capture_file[0]) {
+        YUREI_LOG_INFO("Capture file: %s", config->capture_file);
+    }
+    if (strcasecmp(config->rpc_mode, YUREI_RPC_MODE_REPLAY) == 0) {
+        YUREI_LOG_INFO("Replay file: %s | Pace: %s", config->replay_file, config->replay_pace);
+    }
+    if (config->metrics_port) {
+        YUREI_LOG_INFO("Metrics endpoint: http://%s:%u/metrics",
+                       config->metrics_bind, config->metrics_port);
+    }
+    for (size_t i = 0; i < config->programs.count; ++i) {
+        const YureiProgram *program = &config->programs.programs[i];
+        YUREI_LOG_INFO("Program %s: %s -> %s",
+                       program->name,
+                       program->program_id,
+                       config->programs.tables[program->table]);
+    }
 }
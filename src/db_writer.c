@@ -6,77 +6,493 @@
 #include <libpq-fe.h>
 
 #include <inttypes.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "logging.h"
 
-static const char *table_for_event(YureiEventKind kind, const YureiConfig *config) {
-    if (!config) {
-        return NULL;
-    }
-    switch (kind) {
-        case YUREI_EVENT_KIND_PUMPFUN:
-            return config->pumpfun_table[0] ? config->pumpfun_table : NULL;
-        case YUREI_EVENT_KIND_RAYDIUM:
-            return config->raydium_table[0] ? config->raydium_table : NULL;
-        default:
-            return NULL;
+// Target table index of an event, or -1 if its program is not registered or
+// its table is not among those present on the connection (one bit per index)
+static int table_for_event(YureiEventKind kind, const YureiConfig *config, uint64_t tables) {
+    const YureiProgram *program = yurei_program_get(&config->programs, kind);
+    if (!program || !(tables & (1ULL << program->table))) {
+        return -1;
     }
+    return (int)program->table;
 }
 
-static bool insert_event(PGconn *conn, const YureiEvent *event, const YureiConfig *config) {
-    const char *table = table_for_event(event->kind, config);
-    if (!table) {
-        return true;
+// One prepared INSERT per target table, named by the table's registry index
+static void statement_name(size_t table, char *out, size_t len) {
+    snprintf(out, len, "yurei_insert_%zu", table);
+}
+
+// Upper bound on events per batch; bounds what one pipeline sync or COPY holds in flight
+#define DB_BATCH_MAX 1000
+// Attempts at a spilled batch the server keeps rejecting, the first retry
+// delay (doubled each time), before its records are tried one by one
+#define DB_REPLAY_RETRIES 5
+#define DB_REPLAY_BACKOFF_MS 100u
+// Seconds from the Unix epoch to PostgreSQL's (2000-01-01 UTC)
+#define PG_EPOCH_OFFSET_S 946684800LL
+
+// Wall clock minus monotonic clock, to turn event timestamps into times of day
+static int64_t wall_offset_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    int64_t wall = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    return wall - (int64_t)yurei_now_ns();
+}
+
+// Binary timestamptz: microseconds since the PostgreSQL epoch
+static int64_t pg_timestamp(uint64_t monotonic_ns, int64_t offset_ns) {
+    return ((int64_t)monotonic_ns + offset_ns) / 1000 - PG_EPOCH_OFFSET_S * 1000000LL;
+}
+
+static bool exec_command(PGconn *conn, const char *sql) {
+    PGresult *res = PQexec(conn, sql);
+    bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok) {
+        YUREI_LOG_WARN_LIMITED("DB command '%s' failed: %s", sql, PQerrorMessage(conn));
     }
+    PQclear(res);
+    return ok;
+}
+
+static bool prepare_insert(PGconn *conn, size_t table_index, const YureiConfig *config) {
+    const char *table = config->programs.tables[table_index];
+    char statement[32];
+    statement_name(table_index, statement, sizeof(statement));
     char query[256];
+    bool received_at = config->db_received_at;
     snprintf(query,
              sizeof(query),
-             "INSERT INTO %s (slot, signature, raw_log) VALUES ($1, $2, $3)"
+             "INSERT INTO %s (slot, signature, program_id, raw_log%s) VALUES ($1, $2, $3, $4%s)"
              " ON CONFLICT DO NOTHING",
-             table);
-
-    char slot_buf[32];
-    snprintf(slot_buf, sizeof(slot_buf), "%" PRIu64, event->slot);
-
-    const char *paramValues[3] = {slot_buf, event->signature, (const char *)event->data};
-    int paramLengths[3] = {(int)strlen(slot_buf), (int)strlen(event->signature),
-                           (int)event->data_len};
-    int paramFormats[3] = {0, 0, 1};
-
-    PGresult *res = PQexecParams(conn,
-                                 query,
-                                 3,
-                                 NULL,
-                                 paramValues,
-                                 paramLengths,
-                                 paramFormats,
-                                 0);
-    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        YUREI_LOG_WARN("DB insert failed: %s", PQerrorMessage(conn));
+             table,
+             received_at ? ", received_at" : "",
+             received_at ? ", $5" : "");
+    // int8, text, text, bytea, timestamptz
+    const Oid types[5] = {20, 25, 25, 17, 1184};
+    PGresult *res = PQprepare(conn, statement, query, received_at ? 5 : 4, types);
+    bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok) {
+        YUREI_LOG_WARN("DB prepare of %s failed: %s", statement, PQerrorMessage(conn));
+    }
+    PQclear(res);
+    return ok;
+}
+
+static void encode_be64(uint64_t value, uint8_t out[8]) {
+    for (int i = 7; i >= 0; --i) {
+        out[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+// Send every event of the batch as a pipelined prepared INSERT followed by a
+// single sync. Statements up to a sync run as one implicit transaction, so the
+// batch commits or aborts as a unit. Per-row results are a few bytes each, so
+// reading them only after the sync cannot fill the server's send buffer.
+static bool flush_batch(PGconn *conn,
+                        const YureiEvent *events,
+                        size_t count,
+                        const YureiConfig *config,
+                        uint64_t tables) {
+    size_t sent = 0;
+    int params = config->db_received_at ? 5 : 4;
+    int64_t offset_ns = config->db_received_at ? wall_offset_ns() : 0;
+    for (size_t i = 0; i < count; ++i) {
+        const YureiEvent *event = &events[i];
+        int table = table_for_event(event->kind, config, tables);
+        if (table < 0) {
+            continue;
+        }
+        char statement[32];
+        statement_name((size_t)table, statement, sizeof(statement));
+        uint8_t slot_be[8];
+        encode_be64(event->slot, slot_be);
+        uint8_t received_be[8];
+        encode_be64((uint64_t)pg_timestamp(event->received_ns, offset_ns), received_be);
+        // Events whose receive time was lost in a spill: NULL
+        const char *values[5] = {(const char *)slot_be, event->signature, event->program_id,
+                                 (const char *)event->data,
+                                 event->received_ns ? (const char *)received_be : NULL};
+        const int lengths[5] = {8, (int)strlen(event->signature), (int)strlen(event->program_id),
+                                (int)event->data_len, 8};
+        const int formats[5] = {1, 1, 1, 1, 1};
+        if (!PQsendQueryPrepared(conn, statement, params, values, lengths, formats, 0)) {
+            YUREI_LOG_WARN_LIMITED("DB pipeline send failed: %s", PQerrorMessage(conn));
+            return false;
+        }
+        sent++;
+    }
+    if (sent == 0) {
+        return true;
+    }
+    if (PQpipelineSync(conn) != 1) {
+        YUREI_LOG_WARN_LIMITED("DB pipeline sync failed: %s", PQerrorMessage(conn));
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < sent; ++i) {
+        PGresult *res = PQgetResult(conn);
+        if (!res) {
+            YUREI_LOG_WARN_LIMITED("DB pipeline ended early: %s", PQerrorMessage(conn));
+            return false;
+        }
+        ExecStatusType status = PQresultStatus(res);
+        if (status == PGRES_FATAL_ERROR) {
+            YUREI_LOG_WARN_LIMITED("DB insert failed: %s", PQresultErrorMessage(res));
+            ok = false;
+        } else if (status != PGRES_COMMAND_OK) {
+            ok = false;
+        }
+        PQclear(res);
+        // Each pipelined query's results are terminated by a NULL
+        while ((res = PQgetResult(conn)) != NULL) {
+            PQclear(res);
+        }
+    }
+
+    PGresult *sync = PQgetResult(conn);
+    if (PQresultStatus(sync) != PGRES_PIPELINE_SYNC) {
+        ok = false;
+    }
+    PQclear(sync);
+    return ok;
+}
+
+static bool copy_mode(const YureiConfig *config) {
+    return strcasecmp(config->db_write_mode, YUREI_DB_MODE_COPY) == 0;
+}
+
+static bool discard_mode(const YureiConfig *config) {
+    return strcasecmp(config->db_write_mode, YUREI_DB_MODE_DISCARD) == 0;
+}
+
+static void staging_table_name(const char *table, char *out, size_t len) {
+    snprintf(out, len, "%s_staging", table);
+}
+
+// Growable byte buffer holding one binary COPY stream
+typedef struct {
+    uint8_t *data;
+    size_t length;
+    size_t capacity;
+} CopyBuffer;
+
+static bool copy_reserve(CopyBuffer *buf, size_t extra) {
+    if (buf->length + extra <= buf->capacity) {
+        return true;
+    }
+    size_t capacity = buf->capacity ? buf->capacity : 16384;
+    while (capacity < buf->length + extra) {
+        capacity *= 2;
+    }
+    uint8_t *data = realloc(buf->data, capacity);
+    if (!data) {
+        return false;
+    }
+    buf->data = data;
+    buf->capacity = capacity;
+    return true;
+}
+
+static void copy_put_u16(CopyBuffer *buf, uint16_t value) {
+    buf->data[buf->length++] = (uint8_t)(value >> 8);
+    buf->data[buf->length++] = (uint8_t)value;
+}
+
+static void copy_put_u32(CopyBuffer *buf, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        buf->data[buf->length++] = (uint8_t)(value >> shift);
+    }
+}
+
+static void copy_put_u64(CopyBuffer *buf, uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        buf->data[buf->length++] = (uint8_t)(value >> shift);
+    }
+}
+
+static void copy_put_bytes(CopyBuffer *buf, const void *data, size_t len) {
+    copy_put_u32(buf, (uint32_t)len);
+    memcpy(buf->data + buf->length, data, len);
+    buf->length += len;
+}
+
+// Encode all events bound for one table in PostgreSQL binary COPY format:
+// signature header, (slot int8, signature text, program_id text, raw_log
+// bytea[, received_at timestamptz]) tuples, trailer.
+static bool encode_copy_rows(CopyBuffer *buf,
+                             const YureiEvent *events,
+                             size_t count,
+                             int table,
+                             const YureiConfig *config,
+                             size_t *out_rows) {
+    static const uint8_t header[11] = {'P', 'G', 'C', 'O', 'P', 'Y', '\n', 0xFF, '\r', '\n', 0};
+    buf->length = 0;
+    *out_rows = 0;
+    if (!copy_reserve(buf, sizeof(header) + 8 + 2)) {
+        return false;
+    }
+    memcpy(buf->data, header, sizeof(header));
+    buf->length = sizeof(header);
+    copy_put_u32(buf, 0);  // flags
+    copy_put_u32(buf, 0);  // header extension length
+
+    bool received_at = config->db_received_at;
+    int64_t offset_ns = received_at ? wall_offset_ns() : 0;
+    for (size_t i = 0; i < count; ++i) {
+        const YureiEvent *event = &events[i];
+        if (table_for_event(event->kind, config, UINT64_MAX) != table) {
+            continue;
+        }
+        size_t sig_len = strlen(event->signature);
+        size_t id_len = strlen(event->program_id);
+        if (!copy_reserve(buf, 2 + (4 + 8) + (4 + sig_len) + (4 + id_len) + (4 + event->data_len) +
+                                   (4 + 8) + 2)) {
+            return false;
+        }
+        copy_put_u16(buf, received_at ? 5 : 4);
+        copy_put_u32(buf, 8);
+        copy_put_u64(buf, event->slot);
+        copy_put_bytes(buf, event->signature, sig_len);
+        copy_put_bytes(buf, event->program_id, id_len);
+        copy_put_bytes(buf, event->data, event->data_len);
+        if (received_at && event->received_ns) {
+            copy_put_u32(buf, 8);
+            copy_put_u64(buf, (uint64_t)pg_timestamp(event->received_ns, offset_ns));
+        } else if (received_at) {
+            copy_put_u32(buf, UINT32_MAX);  // -1: NULL
+        }
+        (*out_rows)++;
+    }
+    copy_put_u16(buf, 0xFFFF);  // trailer
+    return true;
+}
+
+static bool copy_rows(PGconn *conn,
+                      CopyBuffer *buf,
+                      const YureiEvent *events,
+                      size_t count,
+                      size_t table_index,
+                      const YureiConfig *config) {
+    const char *table = config->programs.tables[table_index];
+    size_t rows = 0;
+    if (!encode_copy_rows(buf, events, count, (int)table_index, config, &rows)) {
+        YUREI_LOG_ERROR("Out of memory encoding COPY batch");
+        return false;
+    }
+    if (rows == 0) {
+        return true;
+    }
+
+    char staging[96];
+    char query[224];
+    staging_table_name(table, staging, sizeof(staging));
+    snprintf(query,
+             sizeof(query),
+             "COPY %s (slot, signature, program_id, raw_log%s) FROM STDIN (FORMAT binary)",
+             staging,
+             config->db_received_at ? ", received_at" : "");
+
+    PGresult *res = PQexec(conn, query);
+    if (PQresultStatus(res) != PGRES_COPY_IN) {
+        YUREI_LOG_WARN_LIMITED("DB COPY failed to start: %s", PQerrorMessage(conn));
         PQclear(res);
         return false;
     }
     PQclear(res);
+
+    bool ok = PQputCopyData(conn, (const char *)buf->data, (int)buf->length) == 1;
+    if (PQputCopyEnd(conn, ok ? NULL : "client encode failure") != 1) {
+        ok = false;
+    }
+    while ((res = PQgetResult(conn)) != NULL) {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+            ok = false;
+        }
+        PQclear(res);
+    }
+    if (!ok) {
+        YUREI_LOG_WARN_LIMITED("DB COPY failed: %s", PQerrorMessage(conn));
+    }
+    return ok;
+}
+
+static bool copy_batch(PGconn *conn,
+                       CopyBuffer *buf,
+                       const YureiEvent *events,
+                       size_t count,
+                       const YureiConfig *config,
+                       uint64_t tables) {
+    // One COPY per table present in the batch (at most YUREI_PROGRAMS_MAX = 64)
+    uint64_t present = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int table = table_for_event(events[i].kind, config, tables);
+        if (table >= 0) {
+            present |= 1ULL << table;
+        }
+    }
+    for (size_t t = 0; present != 0; ++t, present >>= 1) {
+        if ((present & 1) && !copy_rows(conn, buf, events, count, t, config)) {
+            return false;
+        }
+    }
     return true;
 }
 
-static PGconn *wait_for_connection(const char *conninfo) {
+// Move staged rows into the target table. DELETE ... RETURNING only removes the
+// rows this statement saw, so concurrent COPYs into staging are never lost.
+static bool merge_staging(PGconn *conn, const char *table, const YureiConfig *config) {
+    const char *columns = config->db_received_at
+                              ? "observed_at, slot, signature, program_id, raw_log, received_at"
+                              : "observed_at, slot, signature, program_id, raw_log";
+    char staging[96];
+    char query[640];
+    staging_table_name(table, staging, sizeof(staging));
+    snprintf(query,
+             sizeof(query),
+             "WITH moved AS (DELETE FROM %s RETURNING %s)"
+             " INSERT INTO %s (%s) SELECT %s FROM moved"
+             " ON CONFLICT DO NOTHING",
+             staging,
+             columns,
+             table,
+             columns,
+             columns);
+    return exec_command(conn, query);
+}
+
+static bool merge_all_staging(PGconn *conn, const YureiConfig *config, uint64_t tables) {
+    for (size_t t = 0; t < config->programs.table_count; ++t) {
+        if ((tables & (1ULL << t)) && !merge_staging(conn, config->programs.tables[t], config)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Create the staging tables in one implicit transaction under an advisory
+// lock, so writer shards connecting at the same time don't race on the DDL.
+static bool ensure_staging(PGconn *conn, const YureiConfig *config, uint64_t tables) {
+    const YureiProgramRegistry *registry = &config->programs;
+    if (tables == 0) {
+        return true;
+    }
+    size_t cap = 96 + registry->table_count * (160 + 4 * YUREI_TABLE_NAME_MAX);
+    char *query = malloc(cap);
+    if (!query) {
+        return false;
+    }
+    size_t len = (size_t)snprintf(query, cap,
+                                  "SELECT pg_advisory_xact_lock(hashtext('yurei_staging_ddl'))");
+    for (size_t t = 0; t < registry->table_count; ++t) {
+        if (!(tables & (1ULL << t))) {
+            continue;
+        }
+        char staging[96];
+        staging_table_name(registry->tables[t], staging, sizeof(staging));
+        len += (size_t)snprintf(query + len,
+                                cap - len,
+                                "; CREATE UNLOGGED TABLE IF NOT EXISTS %s (LIKE %s INCLUDING DEFAULTS)",
+                                staging,
+                                registry->tables[t]);
+        if (config->db_received_at) {
+            // Staging tables created before the target gained the column
+            len += (size_t)snprintf(query + len,
+                                    cap - len,
+                                    "; ALTER TABLE %s ADD COLUMN IF NOT EXISTS received_at TIMESTAMPTZ",
+                                    staging);
+        }
+    }
+    bool ok = exec_command(conn, query);
+    free(query);
+    return ok;
+}
+
+// Which registry tables exist, one bit per index. A missing one (such as the
+// <name>_events default of a program listed without a table) has its events
+// dropped instead of failing every connect, which would stall all tables.
+static bool find_tables(PGconn *conn, YureiDbShard *shard) {
+    const YureiProgramRegistry *registry = &shard->config->programs;
+    shard->tables = 0;
+    for (size_t t = 0; t < registry->table_count; ++t) {
+        const char *values[1] = {registry->tables[t]};
+        PGresult *res = PQexecParams(conn, "SELECT to_regclass($1) IS NOT NULL",
+                                     1, NULL, values, NULL, NULL, 0);
+        bool ok = PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) == 1;
+        bool exists = ok && PQgetvalue(res, 0, 0)[0] == 't';
+        PQclear(res);
+        if (!ok) {
+            YUREI_LOG_WARN_LIMITED("DB writer %zu table lookup failed: %s",
+                                   shard->index, PQerrorMessage(conn));
+            return false;
+        }
+        if (exists) {
+            shard->tables |= 1ULL << t;
+        } else if (shard->index == 0) {
+            YUREI_LOG_ERROR("DB table %s does not exist; its events are dropped until it is "
+                            "created (see schema.sql) and the writers reconnect",
+                            registry->tables[t]);
+        }
+    }
+    return true;
+}
+
+// Per-connection setup, run on every (re)connect. COPY cannot run inside a
+// pipeline, so only insert mode prepares statements and enters pipeline mode.
+static bool setup_connection(PGconn *conn, YureiDbShard *shard) {
+    const YureiConfig *config = shard->config;
+    if (!find_tables(conn, shard)) {
+        return false;
+    }
+    if (copy_mode(config)) {
+        return ensure_staging(conn, config, shard->tables);
+    }
+    for (size_t t = 0; t < config->programs.table_count; ++t) {
+        if ((shard->tables & (1ULL << t)) && !prepare_insert(conn, t, config)) {
+            return false;
+        }
+    }
+    if (PQenterPipelineMode(conn) != 1) {
+        YUREI_LOG_WARN("DB pipeline mode unavailable: %s", PQerrorMessage(conn));
+        return false;
+    }
+    return true;
+}
+
+// Each shard reconnects on its own schedule. Gives up (returns NULL) once the
+// shard's queue is closed, so shutdown never blocks on a dead server.
+static PGconn *wait_for_connection(YureiDbShard *shard) {
+    const YureiConfig *config = shard->config;
     PGconn *conn = NULL;
     uint32_t backoff_ms = 1000;
     const uint32_t max_backoff = 30000;
     while (1) {
-        conn = PQconnectdb(conninfo);
+        conn = PQconnectdb(config->pg_conninfo);
         if (PQstatus(conn) == CONNECTION_OK) {
-            return conn;
+            if (setup_connection(conn, shard)) {
+                return conn;
+            }
+        } else {
+            YUREI_LOG_WARN_LIMITED("DB writer %zu connection failed: %s",
+                                   shard->index, PQerrorMessage(conn));
         }
-        YUREI_LOG_WARN("DB connection failed: %s", PQerrorMessage(conn));
         PQfinish(conn);
         conn = NULL;
+        if (atomic_load(&shard->queue->closed)) {
+            return NULL;
+        }
         usleep(backoff_ms * 1000);
         if (backoff_ms < max_backoff) {
             backoff_ms *= 2;
@@ -87,49 +503,358 @@ static PGconn *wait_for_connection(const char *conninfo) {
     }
 }
 
-static void *writer_thread(void *arg) {
-    YureiDbWriter *writer = (YureiDbWriter *)arg;
-    PGconn *conn = wait_for_connection(writer->config->pg_conninfo);
-    YUREI_LOG_INFO("Connected to PostgreSQL");
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
 
-    while (writer->running) {
-        YureiEvent event;
-        if (yurei_queue_pop(writer->queue, &event) != 0) {
+// Stamp events just popped and record how long each sat in the queue
+static void mark_dequeued(YureiMetrics *metrics, YureiEvent *events, size_t count) {
+    if (!metrics) {
+        return;
+    }
+    uint64_t now = yurei_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        events[i].dequeued_ns = now;
+        if (events[i].enqueued_ns) {
+            yurei_metrics_record(metrics, YUREI_STAGE_QUEUE_WAIT, now - events[i].enqueued_ns);
+        }
+    }
+}
+
+// Per-event stages that end when the event's batch is committed (or dropped,
+// in discard mode)
+static void record_committed(YureiMetrics *metrics, const YureiEvent *events, size_t count) {
+    if (!metrics) {
+        return;
+    }
+    uint64_t now = yurei_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        if (events[i].dequeued_ns) {
+            yurei_metrics_record(metrics, YUREI_STAGE_DEQUEUE_TO_COMMIT, now - events[i].dequeued_ns);
+        }
+        if (events[i].received_ns) {
+            yurei_metrics_record(metrics, YUREI_STAGE_END_TO_END, now - events[i].received_ns);
+        }
+    }
+}
+
+// Wait up to first_wait_ms for the first events, then keep draining in
+// contiguous runs until the batch is full or the linger window has elapsed.
+// Returns the number of events collected; sets *closed once the queue is drained.
+static size_t collect_batch(YureiDbShard *shard,
+                            YureiEvent *events,
+                            size_t max,
+                            uint32_t first_wait_ms,
+                            uint32_t linger_ms,
+                            bool *closed) {
+    int rc = yurei_queue_pop_batch(shard->queue, events, max, first_wait_ms);
+    if (rc <= 0) {
+        *closed = rc < 0;
+        return 0;
+    }
+    mark_dequeued(shard->metrics, events, (size_t)rc);
+    size_t count = (size_t)rc;
+    uint64_t deadline = monotonic_ms() + linger_ms;
+    while (count < max) {
+        uint64_t now = monotonic_ms();
+        if (now >= deadline) {
             break;
         }
-        if (!insert_event(conn, &event, writer->config)) {
-            YUREI_LOG_WARN("Insert failed; reconnecting");
+        rc = yurei_queue_pop_batch(shard->queue,
+                                   events + count,
+                                   max - count,
+                                   (uint32_t)(deadline - now));
+        if (rc <= 0) {
+            *closed = rc < 0;
+            break;
+        }
+        mark_dequeued(shard->metrics, events + count, (size_t)rc);
+        count += (size_t)rc;
+    }
+    return count;
+}
+
+static bool write_batch(const YureiDbShard *shard,
+                        PGconn *conn,
+                        CopyBuffer *copy_buf,
+                        const YureiEvent *events,
+                        size_t count) {
+    if (copy_mode(shard->config)) {
+        return copy_batch(conn, copy_buf, events, count, shard->config, shard->tables);
+    }
+    return flush_batch(conn, events, count, shard->config, shard->tables);
+}
+
+static void release_batch(YureiEventQueue *queue, YureiEvent *events, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        yurei_event_release(queue, &events[i]);
+    }
+}
+
+// Park a batch the database refused in the shard's spill so a reconnect does
+// not lose it. Returns false if any event did not fit.
+static bool spill_batch(YureiDbShard *shard, const YureiEvent *events, size_t count) {
+    size_t lost = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (yurei_spill_append(shard->spill, &events[i]) != 0) {
+            lost++;
+        }
+    }
+    if (lost > 0) {
+        YUREI_LOG_ERROR_LIMITED("DB writer %zu dropping %zu of %zu events: spill is full",
+                                shard->index, lost, count);
+    }
+    return lost == 0;
+}
+
+// The server, still connected, refused spilled records just read. Retry the
+// batch with doubling delays, then each of its records on its own; a record
+// refused alone is moved to the dead-letter file so replay can advance.
+static void replay_rejected(YureiDbShard *shard, size_t read) {
+    uint32_t retries = shard->replay_isolating ? 1 : DB_REPLAY_RETRIES;
+    if (++shard->replay_failures < retries) {
+        uint32_t backoff_ms = DB_REPLAY_BACKOFF_MS << (shard->replay_failures - 1);
+        shard->replay_at_ms = monotonic_ms() + backoff_ms;
+        YUREI_LOG_WARN_LIMITED("DB writer %zu spill replay of %zu events rejected; retry %u in %ums",
+                               shard->index, read, shard->replay_failures, backoff_ms);
+        yurei_spill_rewind(shard->spill);
+        return;
+    }
+    shard->replay_failures = 0;
+    if (read > 1) {
+        YUREI_LOG_WARN("DB writer %zu spill replay of %zu events still rejected; retrying them one at a time",
+                       shard->index, read);
+        shard->replay_isolating = read;
+        yurei_spill_rewind(shard->spill);
+        return;
+    }
+    yurei_spill_dead_letter(shard->spill);
+    if (shard->replay_isolating) {
+        shard->replay_isolating--;
+    }
+}
+
+// Write one batch of spilled events. Kinds are resolved against the current
+// program list; events of programs no longer configured are skipped.
+// Returns false if the connection needs to be re-established.
+static bool replay_spill(YureiDbShard *shard,
+                         PGconn *conn,
+                         CopyBuffer *copy_buf,
+                         YureiEvent *events,
+                         size_t max) {
+    const YureiConfig *config = shard->config;
+    size_t read = yurei_spill_read(shard->spill, events, shard->replay_isolating ? 1 : max);
+    size_t count = 0;
+    for (size_t i = 0; i < read; ++i) {
+        YureiEvent *event = &events[i];
+        event->kind = yurei_program_lookup(&config->programs, event->program_id,
+                                           strlen(event->program_id));
+        if (event->kind != YUREI_EVENT_KIND_UNKNOWN) {
+            events[count++] = *event;
+        }
+    }
+    if (read == 0) {
+        return true;
+    }
+    uint64_t write_start = shard->metrics ? yurei_now_ns() : 0;
+    if (count > 0 && !write_batch(shard, conn, copy_buf, events, count)) {
+        if (PQstatus(conn) != CONNECTION_OK) {
+            // Lost the server: not the records' fault, so no attempt is counted
+            yurei_spill_rewind(shard->spill);
+            return false;
+        }
+        replay_rejected(shard, read);
+        return true;
+    }
+    if (count > 0 && shard->metrics) {
+        yurei_metrics_record(shard->metrics, YUREI_STAGE_DB_COMMIT, yurei_now_ns() - write_start);
+        record_committed(shard->metrics, events, count);
+    }
+    yurei_spill_commit(shard->spill);
+    shard->replay_failures = 0;
+    if (shard->replay_isolating) {
+        shard->replay_isolating -= read < shard->replay_isolating ? read : shard->replay_isolating;
+    }
+    return true;
+}
+
+// Discard mode: drain the shard (and its spill) without a database, so
+// replays and load tests measure everything up to the writer
+static void discard_events(YureiDbShard *shard, YureiEvent *batch, size_t batch_max) {
+    bool closed = false;
+    while (!closed) {
+        bool backlog = yurei_spill_pending(shard->spill);
+        size_t count = collect_batch(shard, batch, batch_max,
+                                     backlog ? 0 : YUREI_QUEUE_WAIT_FOREVER,
+                                     backlog ? 0 : shard->config->db_linger_ms, &closed);
+        record_committed(shard->metrics, batch, count);
+        release_batch(shard->queue, batch, count);
+        size_t replayed = backlog ? yurei_spill_read(shard->spill, batch, batch_max) : 0;
+        if (replayed > 0) {
+            record_committed(shard->metrics, batch, replayed);
+            yurei_spill_commit(shard->spill);
+        }
+    }
+}
+
+static void *writer_thread(void *arg) {
+    YureiDbShard *shard = (YureiDbShard *)arg;
+    const YureiConfig *config = shard->config;
+    bool use_copy = copy_mode(config);
+    // Shard 0 owns the periodic staging merge; concurrent merges would only
+    // queue up behind each other's row locks
+    bool merges = use_copy && shard->index == 0;
+    size_t batch_max = config->batch_size ? config->batch_size : 1;
+    if (batch_max > DB_BATCH_MAX) {
+        batch_max = DB_BATCH_MAX;
+    }
+    YureiEvent *batch = calloc(batch_max, sizeof(YureiEvent));
+    if (!batch) {
+        YUREI_LOG_ERROR("Unable to allocate DB batch of %zu events", batch_max);
+        return NULL;
+    }
+    if (discard_mode(config)) {
+        discard_events(shard, batch, batch_max);
+        free(batch);
+        return NULL;
+    }
+    CopyBuffer copy_buf = {0};
+
+    PGconn *conn = wait_for_connection(shard);
+    if (conn) {
+        YUREI_LOG_INFO("DB writer %zu connected (mode=%s, batch=%zu, linger=%ums)",
+                       shard->index,
+                       use_copy ? YUREI_DB_MODE_COPY : YUREI_DB_MODE_INSERT,
+                       batch_max, config->db_linger_ms);
+    }
+
+    uint64_t next_merge = monotonic_ms() + config->db_merge_interval_ms;
+    bool closed = false;
+    while (conn && !closed) {
+        // With a spill backlog, take whatever the ring holds right away and
+        // spend the rest of the iteration replaying from disk. A rejected
+        // replay waits out its backoff without holding up live events.
+        bool backlog = yurei_spill_pending(shard->spill);
+        uint64_t now = monotonic_ms();
+        bool replay_due = backlog && now >= shard->replay_at_ms;
+        uint32_t first_wait = YUREI_QUEUE_WAIT_FOREVER;
+        if (replay_due) {
+            first_wait = 0;
+        } else if (backlog) {
+            first_wait = (uint32_t)(shard->replay_at_ms - now);
+        }
+        if (merges && !replay_due) {
+            uint32_t until_merge = now < next_merge ? (uint32_t)(next_merge - now) : 0;
+            first_wait = until_merge < first_wait ? until_merge : first_wait;
+        }
+
+        size_t count = collect_batch(shard, batch, batch_max, first_wait,
+                                     replay_due ? 0 : config->db_linger_ms, &closed);
+        uint64_t write_start = shard->metrics ? yurei_now_ns() : 0;
+        bool written = count == 0 || write_batch(shard, conn, &copy_buf, batch, count);
+        if (count > 0 && written && shard->metrics) {
+            yurei_metrics_record(shard->metrics, YUREI_STAGE_DB_COMMIT, yurei_now_ns() - write_start);
+            record_committed(shard->metrics, batch, count);
+        }
+        if (!written && shard->spill) {
+            // Park the batch on disk; it is replayed once the server is back
+            YUREI_LOG_WARN_LIMITED("DB writer %zu batch of %zu events failed; spilling and reconnecting",
+                                   shard->index, count);
+            spill_batch(shard, batch, count);
+            PQfinish(conn);
+            conn = wait_for_connection(shard);
+        } else if (!written) {
+            YUREI_LOG_WARN_LIMITED("DB writer %zu batch of %zu events failed; reconnecting",
+                                   shard->index, count);
+            PQfinish(conn);
+            conn = wait_for_connection(shard);
+            if (!conn || !write_batch(shard, conn, &copy_buf, batch, count)) {
+                YUREI_LOG_ERROR_LIMITED("DB writer %zu dropping batch of %zu events after retry",
+                                        shard->index, count);
+            } else {
+                record_committed(shard->metrics, batch, count);
+            }
+        }
+        release_batch(shard->queue, batch, count);
+
+        if (conn && !closed && replay_due && yurei_spill_pending(shard->spill) &&
+            !replay_spill(shard, conn, &copy_buf, batch, batch_max)) {
+            YUREI_LOG_WARN_LIMITED("DB writer %zu spill replay failed; reconnecting", shard->index);
             PQfinish(conn);
-            conn = wait_for_connection(writer->config->pg_conninfo);
+            conn = wait_for_connection(shard);
+        }
+
+        if (conn && merges && monotonic_ms() >= next_merge) {
+            merge_all_staging(conn, config, shard->tables);
+            next_merge = monotonic_ms() + config->db_merge_interval_ms;
         }
     }
 
+    // Every shard merges what it staged last, so nothing is left behind
+    if (conn && use_copy) {
+        merge_all_staging(conn, config, shard->tables);
+    }
+    if (!conn) {
+        // Shutting down without a server: keep what is still queued in the
+        // spill when there is one, and hand the payloads back
+        size_t count;
+        while ((count = yurei_queue_try_pop_batch(shard->queue, batch, batch_max)) > 0) {
+            if (shard->spill) {
+                spill_batch(shard, batch, count);
+            }
+            release_batch(shard->queue, batch, count);
+        }
+    }
     PQfinish(conn);
+    free(copy_buf.data);
+    free(batch);
     return NULL;
 }
 
 int yurei_db_writer_start(YureiDbWriter *writer,
                           const YureiConfig *config,
-                          YureiEventQueue *queue) {
-    if (!writer || !config || !queue) {
+                          const YureiPipeline *pipeline) {
+    YureiShardedQueue *queue = pipeline ? pipeline->queue : NULL;
+    if (!writer || !config || !queue || queue->count == 0) {
         return -1;
     }
     memset(writer, 0, sizeof(*writer));
-    writer->config = config;
-    writer->queue = queue;
-    writer->running = true;
-
-    if (pthread_create(&writer->thread, NULL, writer_thread, writer) != 0) {
-        writer->running = false;
+    writer->shards = calloc(queue->count, sizeof(YureiDbShard));
+    if (!writer->shards) {
         return -1;
     }
+
+    for (size_t i = 0; i < queue->count; ++i) {
+        YureiDbShard *shard = &writer->shards[i];
+        shard->index = i;
+        shard->config = config;
+        shard->queue = &queue->shards[i];
+        shard->metrics = pipeline->metrics;
+        shard->spill = pipeline->spills ? &pipeline->spills[i] : NULL;
+        if (pthread_create(&shard->thread, NULL, writer_thread, shard) != 0) {
+            YUREI_LOG_ERROR("Unable to start DB writer %zu", i);
+            // Closing lets the writers already running drain and exit
+            yurei_sharded_queue_close(queue);
+            yurei_db_writer_stop(writer);
+            return -1;
+        }
+        writer->shard_count = i + 1;
+    }
+    writer->running = true;
     return 0;
 }
 
 void yurei_db_writer_stop(YureiDbWriter *writer) {
-    if (!writer) {
+    if (!writer || !writer->shards) {
         return;
     }
+    for (size_t i = 0; i < writer->shard_count; ++i) {
+        pthread_join(writer->shards[i].thread, NULL);
+    }
+    free(writer->shards);
+    writer->shards = NULL;
+    writer->shard_count = 0;
     writer->running = false;
-    pthread_join(writer->thread, NULL);
 }
@@ -0,0 +1,196 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "dedup_cache.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "logging.h"
+
+#define DEDUP_MIN_ENTRIES 1024u
+// Entries probed per lookup: one cache line of 64-bit words
+#define DEDUP_PROBE 8u
+#define DEDUP_EPOCH_BITS 16u
+#define DEDUP_EPOCH_MASK ((1u << DEDUP_EPOCH_BITS) - 1u)
+// Target slot time; the configured window is counted in slots
+#define DEDUP_SLOT_NS 400000000ULL
+// Attempts to claim an entry before giving up and leaving the key unrecorded
+#define DEDUP_INSERT_RETRIES 2
+
+int yurei_dedup_init(YureiDedupCache *cache, size_t entries, uint64_t window_slots) {
+    if (!cache) {
+        return -1;
+    }
+    memset(cache, 0, sizeof(*cache));
+    size_t rounded = DEDUP_MIN_ENTRIES;
+    while (rounded < entries) {
+        rounded <<= 1;
+    }
+    cache->entries = aligned_alloc(YUREI_CACHE_LINE, rounded * sizeof(uint64_t));
+    if (!cache->entries) {
+        return -1;
+    }
+    for (size_t i = 0; i < rounded; ++i) {
+        atomic_init(&cache->entries[i], 0);
+    }
+    cache->mask = rounded - 1;
+    cache->window_ns = (window_slots ? window_slots : 1) * DEDUP_SLOT_NS;
+    return 0;
+}
+
+void yurei_dedup_destroy(YureiDedupCache *cache) {
+    if (!cache) {
+        return;
+    }
+    free(cache->entries);
+    cache->entries = NULL;
+}
+
+static uint64_t mix_key(uint64_t sig_hash, uint32_t log_index) {
+    // Spread lines of the same transaction across the table
+    uint64_t key = sig_hash ^ (((uint64_t)log_index + 1) * 0x9e3779b97f4a7c15ULL);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+// Current epoch; the coarse clock is a vDSO read with tick resolution, far
+// finer than any window
+static uint32_t current_epoch(const YureiDedupCache *cache) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return (uint32_t)(now / cache->window_ns);
+}
+
+// Epochs behind the current one; entries more than one behind are expired
+static uint32_t entry_age(uint64_t entry, uint32_t now) {
+    uint32_t age = (now - (uint32_t)(entry & DEDUP_EPOCH_MASK)) & DEDUP_EPOCH_MASK;
+    // Written by a thread whose clock read already crossed into the next epoch
+    return age > DEDUP_EPOCH_MASK / 2 ? 0 : age;
+}
+
+typedef struct {
+    uint64_t key;
+    uint64_t fingerprint;
+    uint64_t record;  // fingerprint and epoch, as stored
+    uint32_t newest;
+} DedupKey;
+
+static DedupKey make_key(const YureiDedupCache *cache, uint64_t sig_hash, uint32_t log_index) {
+    DedupKey k;
+    k.key = mix_key(sig_hash, log_index);
+    k.newest = current_epoch(cache);
+    // Fingerprint from the high bits (never zero, so 0 marks an empty entry)
+    k.fingerprint = (k.key >> DEDUP_EPOCH_BITS) | 1u;
+    k.record = (k.fingerprint << DEDUP_EPOCH_BITS) | (k.newest & DEDUP_EPOCH_MASK);
+    return k;
+}
+
+// True if the key is live in its probe run. Otherwise *victim is the entry
+// to claim for it: the first expired one, else the oldest live one.
+static bool probe(YureiDedupCache *cache,
+                  const DedupKey *k,
+                  _Atomic uint64_t **victim,
+                  uint64_t *victim_value,
+                  bool *victim_free) {
+    uint32_t victim_age = 0;
+    *victim = NULL;
+    *victim_value = 0;
+    *victim_free = false;
+    for (size_t i = 0; i < DEDUP_PROBE; ++i) {
+        _Atomic uint64_t *cell = &cache->entries[(k->key + i) & cache->mask];
+        uint64_t value = atomic_load_explicit(cell, memory_order_acquire);
+        uint32_t age = entry_age(value, k->newest);
+        bool live = value != 0 && age <= 1;
+        if (live && (value >> DEDUP_EPOCH_BITS) == k->fingerprint) {
+            return true;
+        }
+        if (!live) {
+            if (!*victim_free) {
+                *victim = cell;
+                *victim_value = value;
+                *victim_free = true;
+            }
+            if (value == 0) {
+                // Entries are never cleared back to zero, so the key
+                // cannot sit further along the probe
+                break;
+            }
+        } else if (!*victim_free && (!*victim || age > victim_age)) {
+            *victim = cell;
+            *victim_value = value;
+            victim_age = age;
+        }
+    }
+    return false;
+}
+
+bool yurei_dedup_contains(YureiDedupCache *cache, uint64_t sig_hash, uint32_t log_index) {
+    if (!cache || !cache->entries) {
+        return false;
+    }
+    DedupKey k = make_key(cache, sig_hash, log_index);
+    _Atomic uint64_t *victim;
+    uint64_t victim_value;
+    bool victim_free;
+    if (probe(cache, &k, &victim, &victim_value, &victim_free)) {
+        atomic_fetch_add_explicit(&cache->hits, 1, memory_order_relaxed);
+        return true;
+    }
+    atomic_fetch_add_explicit(&cache->misses, 1, memory_order_relaxed);
+    return false;
+}
+
+void yurei_dedup_insert(YureiDedupCache *cache, uint64_t sig_hash, uint32_t log_index) {
+    if (!cache || !cache->entries) {
+        return;
+    }
+    DedupKey k = make_key(cache, sig_hash, log_index);
+    for (int attempt = 0; attempt < DEDUP_INSERT_RETRIES; ++attempt) {
+        _Atomic uint64_t *victim;
+        uint64_t victim_value;
+        bool victim_free;
+        if (probe(cache, &k, &victim, &victim_value, &victim_free)) {
+            return;  // recorded by a concurrent copy
+        }
+        if (atomic_compare_exchange_strong_explicit(victim, &victim_value, k.record,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            if (!victim_free) {
+                atomic_fetch_add_explicit(&cache->evictions, 1, memory_order_relaxed);
+            }
+            return;
+        }
+        // Lost a race for the entry; probe again in case it was this key
+    }
+}
+
+void yurei_dedup_stats(const YureiDedupCache *cache, YureiDedupStats *out) {
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!cache) {
+        return;
+    }
+    out->hits = atomic_load_explicit(&cache->hits, memory_order_relaxed);
+    out->misses = atomic_load_explicit(&cache->misses, memory_order_relaxed);
+    out->evictions = atomic_load_explicit(&cache->evictions, memory_order_relaxed);
+}
+
+void yurei_dedup_log(const YureiDedupCache *cache) {
+    if (!cache || !cache->entries) {
+        return;
+    }
+    YureiDedupStats stats;
+    yurei_dedup_stats(cache, &stats);
+    uint64_t total = stats.hits + stats.misses;
+    double hit_rate = total > 0 ? (double)stats.hits / (double)total * 100.0 : 0.0;
+    YUREI_LOG_INFO("Dedup: hits=%" PRIu64 " misses=%" PRIu64 " (%.1f%% duplicates) evictions=%" PRIu64,
+                   stats.hits, stats.misses, hit_rate, stats.evictions);
+}
@@ -3,22 +3,154 @@
 // https://x.com/yureiai  PRD: yurei-jsonrpc-client
 #include "event_queue.h"
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include "futex.h"
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Claim up to max contiguous cells in [cursor, cursor + max) whose sequence
+// equals position + offset, with a single CAS on the cursor. Returns the
+// number claimed and the first claimed position.
+static size_t claim_range(YureiEventQueue *queue,
+                          _Atomic size_t *cursor,
+                          size_t offset,
+                          size_t max,
+                          size_t *out_pos) {
+    size_t pos = atomic_load_explicit(cursor, memory_order_relaxed);
+    for (;;) {
+        size_t n = 0;
+        while (n < max) {
+            YureiQueueCell *cell = &queue->cells[(pos + n) & queue->mask];
+            size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+            if (seq != pos + n + offset) {
+                break;
+            }
+            n++;
+        }
+        if (n == 0) {
+            size_t current = atomic_load_explicit(cursor, memory_order_relaxed);
+            if (current == pos) {
+                return 0;
+            }
+            pos = current;
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(cursor, &pos, pos + n,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            *out_pos = pos;
+            return n;
+        }
+    }
+}
+
+static size_t try_push_n(YureiEventQueue *queue, const YureiEvent *events, size_t count) {
+    size_t pos = 0;
+    size_t n = claim_range(queue, &queue->tail, 0, count, &pos);
+    uint64_t now = 0;
+    for (size_t i = 0; i < n; ++i) {
+        YureiQueueCell *cell = &queue->cells[(pos + i) & queue->mask];
+        cell->event = events[i];
+        // A traced event's enqueue time is when it is published, so time
+        // spent blocked on a full ring is not counted as queue wait
+        if (cell->event.enqueued_ns) {
+            now = now ? now : monotonic_ns();
+            cell->event.enqueued_ns = now;
+        }
+        atomic_store_explicit(&cell->sequence, pos + i + 1, memory_order_release);
+    }
+    if (n > 0) {
+        yurei_futex_notify(&queue->not_empty, &queue->pop_waiters);
+    }
+    return n;
+}
+
+static size_t try_pop_n(YureiEventQueue *queue, YureiEvent *events, size_t max) {
+    size_t pos = 0;
+    size_t n = claim_range(queue, &queue->head, 1, max, &pos);
+    for (size_t i = 0; i < n; ++i) {
+        YureiQueueCell *cell = &queue->cells[(pos + i) & queue->mask];
+        events[i] = cell->event;
+        atomic_store_explicit(&cell->sequence, pos + i + queue->capacity,
+                              memory_order_release);
+    }
+    if (n > 0) {
+        yurei_futex_notify(&queue->not_full, &queue->push_waiters);
+    }
+    return n;
+}
+
+// Sleep on word until notified, closed or the deadline (0 = none) passes.
+// The caller re-checks the ring after registering as a waiter so a publish
+// racing with the sleep is never missed.
+static void wait_on(YureiEventQueue *queue,
+                    _Atomic uint32_t *word,
+                    _Atomic uint32_t *waiters,
+                    bool (*ready)(YureiEventQueue *),
+                    uint64_t deadline_ns) {
+    atomic_fetch_add_explicit(waiters, 1, memory_order_seq_cst);
+    uint32_t observed = atomic_load_explicit(word, memory_order_acquire);
+    if (!ready(queue) && !atomic_load(&queue->closed)) {
+        if (deadline_ns == 0) {
+            yurei_futex_wait(word, observed, NULL);
+        } else {
+            uint64_t now = monotonic_ns();
+            if (now < deadline_ns) {
+                uint64_t remaining = deadline_ns - now;
+                struct timespec ts = {
+                    .tv_sec = (time_t)(remaining / 1000000000ULL),
+                    .tv_nsec = (long)(remaining % 1000000000ULL)
+                };
+                yurei_futex_wait(word, observed, &ts);
+            }
+        }
+    }
+    atomic_fetch_sub_explicit(waiters, 1, memory_order_relaxed);
+}
+
+static bool has_published(YureiEventQueue *queue) {
+    size_t pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    YureiQueueCell *cell = &queue->cells[pos & queue->mask];
+    return atomic_load_explicit(&cell->sequence, memory_order_acquire) == pos + 1;
+}
+
+static bool has_free(YureiEventQueue *queue) {
+    size_t pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    YureiQueueCell *cell = &queue->cells[pos & queue->mask];
+    return atomic_load_explicit(&cell->sequence, memory_order_acquire) == pos;
+}
 
 int yurei_queue_init(YureiEventQueue *queue, size_t capacity) {
     if (!queue || capacity == 0) {
         return -1;
     }
     memset(queue, 0, sizeof(*queue));
-    queue->buffer = calloc(capacity, sizeof(YureiEvent));
-    if (!queue->buffer) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    queue->cells = calloc(rounded, sizeof(YureiQueueCell));
+    if (!queue->cells) {
+        return -1;
+    }
+    if (yurei_slab_init(&queue->slab) != 0) {
+        free(queue->cells);
+        queue->cells = NULL;
         return -1;
     }
-    queue->capacity = capacity;
-    pthread_mutex_init(&queue->mutex, NULL);
-    pthread_cond_init(&queue->cond_push, NULL);
-    pthread_cond_init(&queue->cond_pop, NULL);
+    queue->capacity = rounded;
+    queue->mask = rounded - 1;
+    for (size_t i = 0; i < rounded; ++i) {
+        atomic_init(&queue->cells[i].sequence, i);
+    }
     return 0;
 }
 
@@ -26,60 +158,132 @@ void yurei_queue_destroy(YureiEventQueue *queue) {
     if (!queue) {
         return;
     }
-    free(queue->buffer);
-    queue->buffer = NULL;
-    pthread_mutex_destroy(&queue->mutex);
-    pthread_cond_destroy(&queue->cond_push);
-    pthread_cond_destroy(&queue->cond_pop);
+    free(queue->cells);
+    queue->cells = NULL;
+    yurei_slab_destroy(&queue->slab);
+}
+
+size_t yurei_queue_push_batch(YureiEventQueue *queue, const YureiEvent *events, size_t count) {
+    if (!queue || !events) {
+        return 0;
+    }
+    size_t pushed = 0;
+    while (pushed < count) {
+        if (atomic_load(&queue->closed)) {
+            break;
+        }
+        size_t n = try_push_n(queue, events + pushed, count - pushed);
+        if (n > 0) {
+            pushed += n;
+            continue;
+        }
+        wait_on(queue, &queue->not_full, &queue->push_waiters, has_free, 0);
+    }
+    return pushed;
 }
 
 int yurei_queue_push(YureiEventQueue *queue, const YureiEvent *event) {
     if (!queue || !event) {
         return -1;
     }
-    pthread_mutex_lock(&queue->mutex);
-    while (queue->size == queue->capacity && !queue->closed) {
-        pthread_cond_wait(&queue->cond_push, &queue->mutex);
-    }
-    if (queue->closed) {
-        pthread_mutex_unlock(&queue->mutex);
+    return yurei_queue_push_batch(queue, event, 1) == 1 ? 0 : -1;
+}
+
+int yurei_queue_try_push(YureiEventQueue *queue, const YureiEvent *event) {
+    if (!queue || !event || atomic_load(&queue->closed)) {
         return -1;
     }
-    queue->buffer[queue->tail] = *event;
-    queue->tail = (queue->tail + 1) % queue->capacity;
-    queue->size++;
-    pthread_cond_signal(&queue->cond_pop);
-    pthread_mutex_unlock(&queue->mutex);
-    return 0;
+    return try_push_n(queue, event, 1) == 1 ? 0 : -1;
 }
 
-int yurei_queue_pop(YureiEventQueue *queue, YureiEvent *event) {
-    if (!queue || !event) {
-        return -1;
+size_t yurei_queue_try_pop_batch(YureiEventQueue *queue, YureiEvent *events, size_t max) {
+    if (!queue || !events || max == 0) {
+        return 0;
     }
-    pthread_mutex_lock(&queue->mutex);
-    while (queue->size == 0 && !queue->closed) {
-        pthread_cond_wait(&queue->cond_pop, &queue->mutex);
+    return try_pop_n(queue, events, max);
+}
+
+// Returns the number popped (0 on timeout), or -1 once closed and drained
+static int pop_batch_until(YureiEventQueue *queue,
+                           YureiEvent *events,
+                           size_t max,
+                           uint64_t deadline_ns) {
+    for (;;) {
+        size_t n = try_pop_n(queue, events, max);
+        if (n > 0) {
+            return (int)n;
+        }
+        if (atomic_load(&queue->closed)) {
+            // Producers may have published just before close
+            n = try_pop_n(queue, events, max);
+            return n > 0 ? (int)n : -1;
+        }
+        if (deadline_ns != 0 && monotonic_ns() >= deadline_ns) {
+            return 0;
+        }
+        wait_on(queue, &queue->not_empty, &queue->pop_waiters, has_published, deadline_ns);
     }
-    if (queue->size == 0 && queue->closed) {
-        pthread_mutex_unlock(&queue->mutex);
+}
+
+static uint64_t deadline_after(uint32_t timeout_ms) {
+    if (timeout_ms == YUREI_QUEUE_WAIT_FOREVER) {
+        return 0;
+    }
+    // Keep a zero timeout distinct from "no deadline"
+    return monotonic_ns() + (uint64_t)timeout_ms * 1000000ULL + 1;
+}
+
+int yurei_queue_pop_batch(YureiEventQueue *queue,
+                          YureiEvent *events,
+                          size_t max,
+                          uint32_t timeout_ms) {
+    if (!queue || !events || max == 0) {
         return -1;
     }
-    *event = queue->buffer[queue->head];
-    queue->head = (queue->head + 1) % queue->capacity;
-    queue->size--;
-    pthread_cond_signal(&queue->cond_push);
-    pthread_mutex_unlock(&queue->mutex);
-    return 0;
+    return pop_batch_until(queue, events, max, deadline_after(timeout_ms));
 }
 
 void yurei_queue_close(YureiEventQueue *queue) {
     if (!queue) {
         return;
     }
-    pthread_mutex_lock(&queue->mutex);
-    queue->closed = true;
-    pthread_cond_broadcast(&queue->cond_pop);
-    pthread_cond_broadcast(&queue->cond_push);
-    pthread_mutex_unlock(&queue->mutex);
+    atomic_store(&queue->closed, true);
+    atomic_fetch_add(&queue->not_empty, 1);
+    atomic_fetch_add(&queue->not_full, 1);
+    yurei_futex_wake_all(&queue->not_empty);
+    yurei_futex_wake_all(&queue->not_full);
+}
+
+size_t yurei_queue_depth(YureiEventQueue *queue) {
+    if (!queue) {
+        return 0;
+    }
+    // head first: a push and pop landing between the loads can only
+    // overstate the depth, never wrap it below zero
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t depth = tail > head ? tail - head : 0;
+    return depth < queue->capacity ? depth : queue->capacity;
+}
+
+int yurei_event_payload_alloc(YureiEventQueue *queue, YureiEvent *event, size_t len) {
+    if (!queue || !event || len > YUREI_EVENT_PAYLOAD_MAX) {
+        return -1;
+    }
+    event->data = yurei_slab_alloc(&queue->slab, len ? len : 1, &event->data_cap);
+    event->data_len = 0;
+    return event->data ? 0 : -1;
+}
+
+void yurei_event_release(YureiEventQueue *queue, YureiEvent *event) {
+    if (!queue || !event || !event->data) {
+        return;
+    }
+    // Payloads that are not slab blocks (replayed from a spill) have no capacity
+    if (event->data_cap > 0) {
+        yurei_slab_free(&queue->slab, event->data, event->data_cap);
+    }
+    event->data = NULL;
+    event->data_cap = 0;
+    event->data_len = 0;
 }
@@ -10,170 +10,622 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h>
+#include <strings.h>
+#include <time.h>
 
+#include "capture.h"
+#include "json_scan.h"
 #include "logging.h"
 #include "metrics.h"
 #include "parser.h"
 #include "rate_limiter.h"
 
+// Entries per getLogs call; a full page is re-requested from its last slot
+#define POLL_LOG_LIMIT 50
+// getLogs has no cursor within a slot: a full page that never got past its
+// first slot is fetched again for that slot alone, with the limit raised
+// fourfold each time up to this cap (what the in-place parser takes in one
+// message before falling back to cJSON)
+#define POLL_LOG_LIMIT_MAX 256
+// getLogs calls packed into one request (a getSlot call rides along)
+#define POLL_BATCH_MAX 100
+// Longest the multi loop sleeps, bounding shutdown latency
+#define POLL_WAIT_MAX_MS 100
+#define POLL_REQUEST_TIMEOUT_S 30L
+// Bytes reserved per call in a request body, on top of the mentions array
+#define POLL_CALL_BYTES 256
+// Quoted program ID plus separator in the mentions array
+#define POLL_MENTION_BYTES (YUREI_PROGRAM_ID_MAX + 4)
+// JSON-RPC id of the getSlot call; getLogs calls use 1..n
+#define POLL_TIP_ID 0
+// Response buffers start here and double as needed
+#define RESPONSE_MIN_CAPACITY (64u * 1024u)
+// A buffer grown past this by an outlier response is released afterwards
+#define RESPONSE_KEEP_MAX (16u * 1024u * 1024u)
+
+// Per-handle response body, reused across requests. Always NUL-terminated.
 typedef struct {
     char *data;
     size_t length;
+    size_t capacity;
 } CurlBuffer;
 
+// Inclusive slot range covered by one getLogs call, and its page size
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint32_t limit;
+} SlotWindow;
+
+typedef struct {
+    CURL *easy;
+    bool busy;
+    CurlBuffer response;
+    char *payload;
+    size_t payload_cap;
+    SlotWindow windows[POLL_BATCH_MAX];
+    size_t window_count;
+    struct timespec started;
+} PollRequest;
+
+typedef struct {
+    YureiHttpPoller *poller;
+    CURLM *multi;
+    struct curl_slist *headers;
+    PollRequest *requests;
+    size_t request_count;
+    size_t inflight;
+    size_t calls_per_request;
+    char mentions[YUREI_PROGRAMS_MAX * POLL_MENTION_BYTES + 4];
+    uint64_t next_slot;  // first slot not yet dispatched
+    // Windows to fetch again (failed requests, truncated pages)
+    SlotWindow *retry;
+    size_t retry_count;
+    size_t retry_cap;
+    struct timespec next_probe;
+    struct timespec resume_at;  // failure backoff
+} PollState;
+
+// Make room for at least needed bytes plus the terminator, growing geometrically
+static bool buffer_reserve(CurlBuffer *buffer, size_t needed) {
+    if (needed < buffer->capacity) {
+        return true;
+    }
+    size_t capacity = buffer->capacity ? buffer->capacity : RESPONSE_MIN_CAPACITY;
+    while (capacity <= needed) {
+        capacity *= 2;
+    }
+    char *grown = realloc(buffer->data, capacity);
+    if (!grown) {
+        return false;
+    }
+    buffer->data = grown;
+    buffer->capacity = capacity;
+    return true;
+}
+
+static void buffer_reset(CurlBuffer *buffer) {
+    if (buffer->capacity > RESPONSE_KEEP_MAX) {
+        free(buffer->data);
+        buffer->data = NULL;
+        buffer->capacity = 0;
+    }
+    buffer->length = 0;
+}
+
+static size_t header_callback(char *ptr, size_t size, size_t nitems, void *userdata) {
+    size_t total = size * nitems;
+    CurlBuffer *buffer = (CurlBuffer *)userdata;
+    static const char content_length[] = "content-length:";
+    size_t prefix = sizeof(content_length) - 1;
+    if (total > prefix && strncasecmp(ptr, content_length, prefix) == 0) {
+        // Size the buffer for the whole body up front; a bogus value only
+        // costs one oversized allocation, bounded by RESPONSE_KEEP_MAX
+        unsigned long long length = strtoull(ptr + prefix, NULL, 10);
+        if (length > 0 && length <= RESPONSE_KEEP_MAX) {
+            buffer_reserve(buffer, buffer->length + (size_t)length);
+        }
+    }
+    return total;
+}
+
 static size_t write_callback(char *ptr, size_t size, size_t nmemb, void *userdata) {
     size_t total = size * nmemb;
     CurlBuffer *buffer = (CurlBuffer *)userdata;
-    char *new_data = realloc(buffer->data, buffer->length + total + 1);
-    if (!new_data) {
+    if (!buffer_reserve(buffer, buffer->length + total)) {
         return 0;
     }
-    buffer->data = new_data;
     memcpy(buffer->data + buffer->length, ptr, total);
     buffer->length += total;
     buffer->data[buffer->length] = '\0';
     return total;
 }
 
-static void build_mentions_array(const YureiConfig *config, char *out, size_t len) {
-    bool first = true;
-    size_t offset = 0;
-    if (len == 0) {
-        return;
+static void build_mentions_array(const YureiProgramRegistry *programs, char *out, size_t len) {
+    size_t offset = (size_t)snprintf(out, len, "[");
+    for (size_t i = 0; i < programs->count && offset < len; ++i) {
+        offset += (size_t)snprintf(out + offset,
+                                   len - offset,
+                                   "%s\"%s\"",
+                                   i == 0 ? "" : ",",
+                                   programs->programs[i].program_id);
     }
-    offset += snprintf(out + offset, len - offset, "[");
-    if (config->pumpfun_program[0]) {
-        offset += snprintf(out + offset,
-                           len - offset,
-                           "%s\"%s\"",
-                           first ? "" : ",",
-                           config->pumpfun_program);
-        first = false;
+    if (offset < len) {
+        snprintf(out + offset, len - offset, "]");
     }
-    if (config->raydium_program[0]) {
-        offset += snprintf(out + offset,
-                           len - offset,
-                           "%s\"%s\"",
-                           first ? "" : ",",
-                           config->raydium_program);
-        first = false;
+}
+
+static uint64_t elapsed_us(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - start->tv_sec) * 1000000 +
+           (uint64_t)((now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+static bool time_reached(const struct timespec *deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec ||
+           (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+static void deadline_in(struct timespec *deadline, uint32_t delay_ms) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += delay_ms / 1000;
+    deadline->tv_nsec += (long)(delay_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
     }
-    if (first) {
-        offset += snprintf(out + offset,
-                           len - offset,
-                           "\"%s\"",
-                           config->pumpfun_program);
+}
+
+static bool push_retry(PollState *state, SlotWindow window) {
+    if (state->retry_count == state->retry_cap) {
+        size_t cap = state->retry_cap ? state->retry_cap * 2 : 64;
+        SlotWindow *grown = realloc(state->retry, cap * sizeof(SlotWindow));
+        if (!grown) {
+            YUREI_LOG_WARN_LIMITED("Dropping slot window %" PRIu64 "-%" PRIu64 " (out of memory)",
+                                   window.start, window.end);
+            return false;
+        }
+        state->retry = grown;
+        state->retry_cap = cap;
     }
-    snprintf(out + offset, len - offset, "]");
+    state->retry[state->retry_count++] = window;
+    return true;
 }
 
-static void *poller_thread(void *arg) {
-    YureiHttpPoller *poller = (YureiHttpPoller *)arg;
-    CURL *curl = curl_easy_init();
-    if (!curl) {
-        YUREI_LOG_ERROR("Failed to initialize libcurl");
-        poller->running = false;
-        return NULL;
+static bool next_window(PollState *state, SlotWindow *out) {
+    if (state->retry_count > 0) {
+        *out = state->retry[--state->retry_count];
+        return true;
     }
+    uint64_t tip = state->poller->tip_slot;
+    if (tip == 0) {
+        return false;
+    }
+    if (state->next_slot == 0) {
+        // No start slot configured: follow from the current tip
+        state->next_slot = tip;
+    }
+    if (state->next_slot > tip) {
+        return false;
+    }
+    out->start = state->next_slot;
+    out->end = state->next_slot + state->poller->config->http_slot_span - 1;
+    if (out->end > tip) {
+        out->end = tip;
+    }
+    out->limit = POLL_LOG_LIMIT;
+    state->next_slot = out->end + 1;
+    return true;
+}
 
-    struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_URL, poller->config->rpc_endpoint);
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+static bool has_window(const PollState *state) {
+    uint64_t tip = state->poller->tip_slot;
+    return state->retry_count > 0 || (tip > 0 && state->next_slot <= tip);
+}
 
-    while (poller->running) {
-        // Apply rate limiting before making request
-        if (poller->rate_limiter) {
-            yurei_rate_limiter_wait(poller->rate_limiter);
-        }
-
-        char payload[512];
-        char mentions[256];
-        build_mentions_array(poller->config, mentions, sizeof(mentions));
-
-        if (poller->last_slot > 0) {
-            snprintf(payload,
-                     sizeof(payload),
-                     "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"getLogs\","
-                     "\"params\":[{\"mentions\":%s,\"startSlot\":%" PRIu64 ",\"limit\":50},"
-                     "{\"commitment\":\"confirmed\"}]}",
-                     mentions,
-                     poller->last_slot);
+// Body: [getSlot, getLogs(window 1), ..., getLogs(window n)]
+static void build_payload(PollState *state, PollRequest *request) {
+    size_t offset = (size_t)snprintf(request->payload,
+                                     request->payload_cap,
+                                     "[{\"jsonrpc\":\"2.0\",\"id\":%d,\"method\":\"getSlot\","
+                                     "\"params\":[{\"commitment\":\"confirmed\"}]}",
+                                     POLL_TIP_ID);
+    for (size_t i = 0; i < request->window_count; ++i) {
+        offset += (size_t)snprintf(request->payload + offset,
+                                   request->payload_cap - offset,
+                                   ",{\"jsonrpc\":\"2.0\",\"id\":%zu,\"method\":\"getLogs\","
+                                   "\"params\":[{\"mentions\":%s,\"startSlot\":%" PRIu64
+                                   ",\"endSlot\":%" PRIu64 ",\"limit\":%" PRIu32 "},"
+                                   "{\"commitment\":\"confirmed\"}]}",
+                                   i + 1,
+                                   state->mentions,
+                                   request->windows[i].start,
+                                   request->windows[i].end,
+                                   request->windows[i].limit);
+    }
+    snprintf(request->payload + offset, request->payload_cap - offset, "]");
+}
+
+static bool dispatch(PollState *state, PollRequest *request) {
+    request->window_count = 0;
+    SlotWindow window;
+    while (request->window_count < state->calls_per_request && next_window(state, &window)) {
+        request->windows[request->window_count++] = window;
+    }
+    build_payload(state, request);
+    YUREI_LOG_TRACE("HTTP request: %s", request->payload);
+
+    buffer_reset(&request->response);
+    curl_easy_setopt(request->easy, CURLOPT_POSTFIELDS, request->payload);
+    clock_gettime(CLOCK_MONOTONIC, &request->started);
+    if (curl_multi_add_handle(state->multi, request->easy) != CURLM_OK) {
+        for (size_t i = 0; i < request->window_count; ++i) {
+            push_retry(state, request->windows[i]);
+        }
+        return false;
+    }
+    request->busy = true;
+    state->inflight++;
+    return true;
+}
+
+static PollRequest *idle_request(PollState *state) {
+    for (size_t i = 0; i < state->request_count; ++i) {
+        if (!state->requests[i].busy) {
+            return &state->requests[i];
+        }
+    }
+    return NULL;
+}
+
+// Fill idle request slots while there are windows to fetch; otherwise keep
+// one getSlot probe per poll interval to learn when the tip moves.
+static void dispatch_ready(PollState *state) {
+    YureiHttpPoller *poller = state->poller;
+    PollRequest *request;
+    if (!time_reached(&state->resume_at)) {
+        return;
+    }
+    while ((request = idle_request(state)) != NULL) {
+        bool probe = !has_window(state);
+        if (probe && (state->inflight > 0 || !time_reached(&state->next_probe))) {
+            return;
+        }
+        if (poller->rate_limiter && !yurei_rate_limiter_try_acquire(poller->rate_limiter)) {
+            return;
+        }
+        if (!dispatch(state, request)) {
+            return;
+        }
+        if (probe) {
+            deadline_in(&state->next_probe, poller->config->poll_interval_ms);
+        }
+    }
+}
+
+typedef struct {
+    bool has_id;
+    uint64_t id;
+    bool has_error;
+    bool has_slot;
+    uint64_t slot;          // getSlot result
+    size_t entries;         // getLogs result length
+    uint64_t highest_slot;  // highest entry slot in a getLogs result
+} CallSummary;
+
+static bool scan_entry_slot(YureiJsonScanner *sc, uint64_t *highest) {
+    if (yurei_json_peek(sc) != YUREI_JSON_OBJECT) {
+        return yurei_json_skip_value(sc);
+    }
+    yurei_json_object_begin(sc);
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(sc, &key)) > 0) {
+        uint64_t slot;
+        if (yurei_json_slice_equals(&key, "slot") && yurei_json_peek(sc) == YUREI_JSON_NUMBER) {
+            ok = yurei_json_uint64(sc, &slot);
+            if (ok && slot > *highest) {
+                *highest = slot;
+            }
         } else {
-            snprintf(payload,
-                     sizeof(payload),
-                     "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"getLogs\","
-                     "\"params\":[{\"mentions\":%s,\"limit\":50},{\"commitment\":\"confirmed\"}]}",
-                     mentions);
-        }
-
-        YUREI_LOG_TRACE("HTTP request: %s", payload);
-
-        CurlBuffer buffer = {.data = NULL, .length = 0};
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-
-        // Measure request latency
-        struct timespec start, end;
-        clock_gettime(CLOCK_MONOTONIC, &start);
-        
-        CURLcode rc = curl_easy_perform(curl);
-        
-        clock_gettime(CLOCK_MONOTONIC, &end);
-        uint64_t latency_us = (end.tv_sec - start.tv_sec) * 1000000 +
-                              (end.tv_nsec - start.tv_nsec) / 1000;
-
-        if (rc == CURLE_OK && buffer.data) {
-            // Track metrics
-            if (poller->metrics) {
-                yurei_metrics_request(poller->metrics, true, latency_us);
-                yurei_metrics_bytes(poller->metrics, buffer.length);
+            ok = yurei_json_skip_value(sc);
+        }
+    }
+    return ok && rc == 0;
+}
+
+// id, error and the shape of result for one batch element
+static bool summarize_call(const char *json, size_t len, CallSummary *out) {
+    YureiJsonScanner sc;
+    yurei_json_init(&sc, json, len);
+    memset(out, 0, sizeof(*out));
+    if (!yurei_json_object_begin(&sc)) {
+        return false;
+    }
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(&sc, &key)) > 0) {
+        YureiJsonType type = yurei_json_peek(&sc);
+        if (yurei_json_slice_equals(&key, "id") && type == YUREI_JSON_NUMBER) {
+            ok = out->has_id = yurei_json_uint64(&sc, &out->id);
+        } else if (yurei_json_slice_equals(&key, "error")) {
+            out->has_error = true;
+            ok = yurei_json_skip_value(&sc);
+        } else if (yurei_json_slice_equals(&key, "result") && type == YUREI_JSON_NUMBER) {
+            ok = out->has_slot = yurei_json_uint64(&sc, &out->slot);
+        } else if (yurei_json_slice_equals(&key, "result") && type == YUREI_JSON_ARRAY) {
+            ok = yurei_json_array_begin(&sc);
+            int next = 0;
+            while (ok && (next = yurei_json_array_next(&sc)) > 0) {
+                out->entries++;
+                ok = scan_entry_slot(&sc, &out->highest_slot);
             }
-            
-            uint64_t highest_slot = poller->last_slot;
-            int processed = yurei_parser_handle_message(
-                buffer.data, poller->config, poller->queue, &highest_slot);
-            
-            if (processed > 0) {
-                YUREI_LOG_DEBUG("HTTP poll: processed %d events, latency=%" PRIu64 "us", 
-                               processed, latency_us);
-                if (poller->metrics) {
-                    for (int i = 0; i < processed; i++) {
-                        yurei_metrics_event(poller->metrics);
-                    }
-                }
+            ok = ok && next == 0;
+        } else {
+            ok = yurei_json_skip_value(&sc);
+        }
+    }
+    return ok && rc == 0;
+}
+
+static void handle_call(PollState *state,
+                        const PollRequest *request,
+                        const char *json,
+                        size_t len,
+                        uint64_t received_ns,
+                        bool *answered) {
+    YureiHttpPoller *poller = state->poller;
+    CallSummary call;
+    if (!summarize_call(json, len, &call) || !call.has_id) {
+        return;
+    }
+    if (call.id == POLL_TIP_ID) {
+        if (call.has_slot && call.slot > poller->tip_slot) {
+            poller->tip_slot = call.slot;
+        }
+        return;
+    }
+    if (call.id > request->window_count) {
+        return;
+    }
+    size_t index = (size_t)(call.id - 1);
+    SlotWindow window = request->windows[index];
+    if (call.has_error) {
+        return;  // left unanswered, so it is retried
+    }
+    answered[index] = true;
+
+    uint64_t highest_slot = 0;
+    int processed = yurei_parser_handle_received(json, len, received_ns, poller->config,
+                                                 poller->pipeline, &highest_slot);
+    if (processed > 0) {
+        if (poller->metrics) {
+            for (int i = 0; i < processed; i++) {
+                yurei_metrics_event(poller->metrics);
             }
-            
-            if (processed > 0 && highest_slot > poller->last_slot) {
-                poller->last_slot = highest_slot;
+        }
+        if (highest_slot > poller->last_slot) {
+            poller->last_slot = highest_slot;
+        }
+    }
+    if (call.entries < window.limit) {
+        return;
+    }
+    // Full page: slots below the highest one seen are complete, that one may
+    // not be. Its repeats are dropped by the dedup set, or failing that by
+    // the writers' ON CONFLICT.
+    if (call.highest_slot > window.start) {
+        SlotWindow rest = {call.highest_slot, window.end, POLL_LOG_LIMIT};
+        push_retry(state, rest);
+        return;
+    }
+    // The whole page is the first slot
+    if (window.limit < POLL_LOG_LIMIT_MAX) {
+        uint32_t limit = window.limit * 4;
+        SlotWindow dense = {window.start, window.start,
+                            limit < POLL_LOG_LIMIT_MAX ? limit : POLL_LOG_LIMIT_MAX};
+        push_retry(state, dense);
+    } else {
+        yurei_metrics_truncated_slot(poller->metrics);
+        YUREI_LOG_WARN_LIMITED("HTTP poll: slot %" PRIu64 " has more than %" PRIu32
+                               " matching log entries; the rest are not fetched",
+                               window.start, window.limit);
+    }
+    if (window.start < window.end) {
+        SlotWindow rest = {window.start + 1, window.end, POLL_LOG_LIMIT};
+        push_retry(state, rest);
+    }
+}
+
+static void handle_response(PollState *state, PollRequest *request, uint64_t received_ns) {
+    bool answered[POLL_BATCH_MAX] = {false};
+    const char *json = request->response.data;
+    size_t len = request->response.length;
+
+    YureiJsonScanner sc;
+    yurei_json_init(&sc, json, len);
+    if (yurei_json_peek(&sc) == YUREI_JSON_ARRAY && yurei_json_array_begin(&sc)) {
+        while (yurei_json_array_next(&sc) > 0) {
+            yurei_json_peek(&sc);
+            const char *element = sc.cur;
+            if (!yurei_json_skip_value(&sc)) {
+                break;
             }
+            handle_call(state, request, element, (size_t)(sc.cur - element), received_ns,
+                        answered);
+        }
+    } else {
+        // Not a batch reply, typically a single rate-limit or error object
+        YUREI_LOG_WARN_LIMITED("HTTP poll: unexpected response: %.200s", json);
+    }
+
+    for (size_t i = 0; i < request->window_count; ++i) {
+        if (!answered[i]) {
+            push_retry(state, request->windows[i]);
+        }
+    }
+}
+
+static void complete(PollState *state, CURLMsg *msg) {
+    YureiHttpPoller *poller = state->poller;
+    char *private_data = NULL;
+    curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &private_data);
+    curl_multi_remove_handle(state->multi, msg->easy_handle);
+    PollRequest *request = (PollRequest *)private_data;
+    if (!request) {
+        return;
+    }
+    request->busy = false;
+    state->inflight--;
+
+    uint64_t received_ns = yurei_now_ns();
+    uint64_t latency_us = elapsed_us(&request->started);
+    long status = 0;
+    curl_easy_getinfo(request->easy, CURLINFO_RESPONSE_CODE, &status);
+    CURLcode rc = msg->data.result;
+    if (rc == CURLE_OK && status == 200 && request->response.length > 0) {
+        if (poller->metrics) {
+            yurei_metrics_request(poller->metrics, true, latency_us);
+            yurei_metrics_bytes(poller->metrics, request->response.length);
+        }
+        if (poller->pipeline->capture) {
+            yurei_capture_record(poller->pipeline->capture, YUREI_CAPTURE_HTTP,
+                                 request->response.data, request->response.length);
+        }
+        handle_response(state, request, received_ns);
+        YUREI_LOG_DEBUG("HTTP poll: %zu windows, tip=%" PRIu64 ", latency=%" PRIu64 "us",
+                        request->window_count, poller->tip_slot, latency_us);
+    } else {
+        if (rc == CURLE_OK) {
+            YUREI_LOG_WARN_LIMITED("HTTP poll failed: status %ld (latency=%" PRIu64 "us)",
+                                   status, latency_us);
         } else {
-            YUREI_LOG_WARN("HTTP poll failed: %s (latency=%" PRIu64 "us)", 
-                          curl_easy_strerror(rc), latency_us);
-            if (poller->metrics) {
-                yurei_metrics_request(poller->metrics, false, latency_us);
+            YUREI_LOG_WARN_LIMITED("HTTP poll failed: %s (latency=%" PRIu64 "us)",
+                                   curl_easy_strerror(rc), latency_us);
+        }
+        if (poller->metrics) {
+            yurei_metrics_request(poller->metrics, false, latency_us);
+        }
+        for (size_t i = 0; i < request->window_count; ++i) {
+            push_retry(state, request->windows[i]);
+        }
+        // Back off instead of hammering a failing endpoint
+        deadline_in(&state->resume_at, poller->config->poll_interval_ms);
+    }
+}
+
+static void state_destroy(PollState *state) {
+    for (size_t i = 0; i < state->request_count; ++i) {
+        PollRequest *request = &state->requests[i];
+        if (request->easy) {
+            if (request->busy) {
+                curl_multi_remove_handle(state->multi, request->easy);
             }
+            curl_easy_cleanup(request->easy);
+        }
+        free(request->response.data);
+        free(request->payload);
+    }
+    free(state->requests);
+    free(state->retry);
+    if (state->multi) {
+        curl_multi_cleanup(state->multi);
+    }
+    curl_slist_free_all(state->headers);
+}
+
+static int state_init(PollState *state, YureiHttpPoller *poller) {
+    const YureiConfig *config = poller->config;
+    memset(state, 0, sizeof(*state));
+    state->poller = poller;
+    state->next_slot = config->http_start_slot;
+    state->calls_per_request = config->batch_size;
+    if (state->calls_per_request == 0) {
+        state->calls_per_request = 1;
+    } else if (state->calls_per_request > POLL_BATCH_MAX) {
+        state->calls_per_request = POLL_BATCH_MAX;
+    }
+    build_mentions_array(&config->programs, state->mentions, sizeof(state->mentions));
+    size_t mentions_len = strlen(state->mentions);
+
+    state->multi = curl_multi_init();
+    state->headers = curl_slist_append(NULL, "Content-Type: application/json");
+    // Batch bodies exceed libcurl's Expect: 100-continue threshold; skip the extra round trip
+    state->headers = curl_slist_append(state->headers, "Expect:");
+    state->request_count = config->http_max_inflight ? config->http_max_inflight : 1;
+    state->requests = calloc(state->request_count, sizeof(PollRequest));
+    if (!state->multi || !state->headers || !state->requests) {
+        return -1;
+    }
+    curl_multi_setopt(state->multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)state->request_count);
+
+    for (size_t i = 0; i < state->request_count; ++i) {
+        PollRequest *request = &state->requests[i];
+        request->payload_cap = (state->calls_per_request + 1) * (POLL_CALL_BYTES + mentions_len);
+        request->payload = malloc(request->payload_cap);
+        request->easy = curl_easy_init();
+        if (!request->payload || !request->easy) {
+            return -1;
         }
+        curl_easy_setopt(request->easy, CURLOPT_HTTPHEADER, state->headers);
+        curl_easy_setopt(request->easy, CURLOPT_URL, config->rpc_endpoint);
+        curl_easy_setopt(request->easy, CURLOPT_POST, 1L);
+        curl_easy_setopt(request->easy, CURLOPT_CONNECTTIMEOUT, 10L);
+        curl_easy_setopt(request->easy, CURLOPT_TIMEOUT, POLL_REQUEST_TIMEOUT_S);
+        curl_easy_setopt(request->easy, CURLOPT_WRITEFUNCTION, write_callback);
+        curl_easy_setopt(request->easy, CURLOPT_WRITEDATA, &request->response);
+        curl_easy_setopt(request->easy, CURLOPT_HEADERFUNCTION, header_callback);
+        curl_easy_setopt(request->easy, CURLOPT_HEADERDATA, &request->response);
+        curl_easy_setopt(request->easy, CURLOPT_PRIVATE, request);
+    }
+    return 0;
+}
+
+static void *poller_thread(void *arg) {
+    YureiHttpPoller *poller = (YureiHttpPoller *)arg;
+    PollState state;
+    if (state_init(&state, poller) != 0) {
+        YUREI_LOG_ERROR("Failed to initialize libcurl");
+        state_destroy(&state);
+        poller->running = false;
+        return NULL;
+    }
 
-        free(buffer.data);
-        usleep(poller->config->poll_interval_ms * 1000);
+    while (poller->running) {
+        dispatch_ready(&state);
+
+        int still_running = 0;
+        curl_multi_perform(state.multi, &still_running);
+        CURLMsg *msg;
+        int queued;
+        bool completed = false;
+        while ((msg = curl_multi_info_read(state.multi, &queued)) != NULL) {
+            if (msg->msg == CURLMSG_DONE) {
+                complete(&state, msg);
+                completed = true;
+            }
+        }
+        if (!completed) {
+            // Wakes on socket activity; the cap bounds rate-limit retries,
+            // probe scheduling and shutdown
+            curl_multi_poll(state.multi, NULL, 0, POLL_WAIT_MAX_MS, NULL);
+        }
     }
 
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+    state_destroy(&state);
     return NULL;
 }
 
 int yurei_http_poller_start(YureiHttpPoller *poller,
                             const YureiConfig *config,
-                            YureiEventQueue *queue,
-                            YureiMetrics *metrics,
+                            const YureiPipeline *pipeline,
                             YureiRateLimiter *rate_limiter) {
-    if (!poller || !config || !queue) {
+    if (!poller || !config || !pipeline || !pipeline->queue) {
         return -1;
     }
     if (curl_global_init(CURL_GLOBAL_DEFAULT) != 0) {
@@ -182,8 +634,8 @@ int yurei_http_poller_start(YureiHttpPoller *poller,
     }
     memset(poller, 0, sizeof(*poller));
     poller->config = config;
-    poller->queue = queue;
-    poller->metrics = metrics;
+    poller->pipeline = pipeline;
+    poller->metrics = pipeline->metrics;
     poller->rate_limiter = rate_limiter;
     poller->running = true;
 
@@ -0,0 +1,242 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "json_scan.h"
+
+#include <string.h>
+
+// Bound recursion in skip_value for hostile inputs
+#define JSON_SCAN_MAX_DEPTH 64
+
+static void skip_ws(YureiJsonScanner *sc) {
+    while (sc->cur < sc->end) {
+        char c = *sc->cur;
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            break;
+        }
+        sc->cur++;
+    }
+}
+
+static bool consume(YureiJsonScanner *sc, char expected) {
+    skip_ws(sc);
+    if (sc->cur < sc->end && *sc->cur == expected) {
+        sc->cur++;
+        return true;
+    }
+    return false;
+}
+
+void yurei_json_init(YureiJsonScanner *sc, const char *json, size_t len) {
+    sc->begin = json;
+    sc->cur = json;
+    sc->end = json + len;
+}
+
+YureiJsonType yurei_json_peek(YureiJsonScanner *sc) {
+    skip_ws(sc);
+    if (sc->cur >= sc->end) {
+        return YUREI_JSON_NONE;
+    }
+    switch (*sc->cur) {
+        case '{':
+            return YUREI_JSON_OBJECT;
+        case '[':
+            return YUREI_JSON_ARRAY;
+        case '"':
+            return YUREI_JSON_STRING;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return YUREI_JSON_NUMBER;
+        case 't':
+        case 'f':
+        case 'n':
+            return YUREI_JSON_LITERAL;
+        default:
+            return YUREI_JSON_NONE;
+    }
+}
+
+bool yurei_json_string(YureiJsonScanner *sc, YureiJsonSlice *out) {
+    if (!consume(sc, '"')) {
+        return false;
+    }
+    const char *start = sc->cur;
+    bool escaped = false;
+    for (;;) {
+        const char *quote = memchr(sc->cur, '"', (size_t)(sc->end - sc->cur));
+        if (!quote) {
+            return false;
+        }
+        // A quote preceded by an odd run of backslashes is escaped
+        size_t backslashes = 0;
+        for (const char *p = quote; p > start && p[-1] == '\\'; --p) {
+            backslashes++;
+        }
+        if (!escaped && memchr(sc->cur, '\\', (size_t)(quote - sc->cur))) {
+            escaped = true;
+        }
+        sc->cur = quote + 1;
+        if ((backslashes & 1) == 0) {
+            if (out) {
+                out->ptr = start;
+                out->len = (size_t)(quote - start);
+                out->escaped = escaped;
+            }
+            return true;
+        }
+    }
+}
+
+bool yurei_json_uint64(YureiJsonScanner *sc, uint64_t *out) {
+    skip_ws(sc);
+    const char *p = sc->cur;
+    if (p < sc->end && *p == '-') {
+        return false;
+    }
+    uint64_t value = 0;
+    const char *digits = p;
+    while (p < sc->end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    if (p == digits) {
+        return false;
+    }
+    while (p < sc->end && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' ||
+                           *p == 'E' || *p == '+' || *p == '-')) {
+        p++;
+    }
+    sc->cur = p;
+    if (out) {
+        *out = value;
+    }
+    return true;
+}
+
+static bool skip_literal(YureiJsonScanner *sc) {
+    static const char *literals[] = {"true", "false", "null"};
+    for (size_t i = 0; i < sizeof(literals) / sizeof(literals[0]); ++i) {
+        size_t len = strlen(literals[i]);
+        if ((size_t)(sc->end - sc->cur) >= len && memcmp(sc->cur, literals[i], len) == 0) {
+            sc->cur += len;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool skip_value_depth(YureiJsonScanner *sc, int depth) {
+    if (depth > JSON_SCAN_MAX_DEPTH) {
+        return false;
+    }
+    int rc;
+    switch (yurei_json_peek(sc)) {
+        case YUREI_JSON_OBJECT:
+            if (!yurei_json_object_begin(sc)) {
+                return false;
+            }
+            while ((rc = yurei_json_object_next(sc, NULL)) > 0) {
+                if (!skip_value_depth(sc, depth + 1)) {
+                    return false;
+                }
+            }
+            return rc == 0;
+        case YUREI_JSON_ARRAY:
+            if (!yurei_json_array_begin(sc)) {
+                return false;
+            }
+            while ((rc = yurei_json_array_next(sc)) > 0) {
+                if (!skip_value_depth(sc, depth + 1)) {
+                    return false;
+                }
+            }
+            return rc == 0;
+        case YUREI_JSON_STRING:
+            return yurei_json_string(sc, NULL);
+        case YUREI_JSON_NUMBER:
+            if (*sc->cur == '-') {
+                sc->cur++;
+            }
+            return yurei_json_uint64(sc, NULL);
+        case YUREI_JSON_LITERAL:
+            return skip_literal(sc);
+        default:
+            return false;
+    }
+}
+
+bool yurei_json_skip_value(YureiJsonScanner *sc) {
+    return skip_value_depth(sc, 0);
+}
+
+// Containers are stateless: the first element is the one whose preceding
+// non-whitespace byte is the opening bracket, otherwise a separator is due.
+// (No complete value ends in '{' or '[', so the lookback is unambiguous.)
+static bool after_open(const YureiJsonScanner *sc, char open) {
+    const char *p = sc->cur;
+    while (p > sc->begin) {
+        char c = p[-1];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            return c == open;
+        }
+        p--;
+    }
+    return false;
+}
+
+bool yurei_json_object_begin(YureiJsonScanner *sc) {
+    return consume(sc, '{');
+}
+
+int yurei_json_object_next(YureiJsonScanner *sc, YureiJsonSlice *key) {
+    skip_ws(sc);
+    if (sc->cur >= sc->end) {
+        return -1;
+    }
+    if (*sc->cur == '}') {
+        sc->cur++;
+        return 0;
+    }
+    if (!after_open(sc, '{') &&
+        !consume(sc, ',')) {
+        return -1;
+    }
+    if (!yurei_json_string(sc, key) || !consume(sc, ':')) {
+        return -1;
+    }
+    skip_ws(sc);
+    return 1;
+}
+
+bool yurei_json_array_begin(YureiJsonScanner *sc) {
+    return consume(sc, '[');
+}
+
+int yurei_json_array_next(YureiJsonScanner *sc) {
+    skip_ws(sc);
+    if (sc->cur >= sc->end) {
+        return -1;
+    }
+    if (*sc->cur == ']') {
+        sc->cur++;
+        return 0;
+    }
+    if (!after_open(sc, '[') &&
+        !consume(sc, ',')) {
+        return -1;
+    }
+    skip_ws(sc);
+    return 1;
+}
+
+bool yurei_json_slice_equals(const YureiJsonSlice *slice, const char *literal) {
+    size_t len = strlen(literal);
+    return slice && slice->len == len && memcmp(slice->ptr, literal, len) == 0;
+}
+
+bool yurei_json_at_end(YureiJsonScanner *sc) {
+    skip_ws(sc);
+    return sc->cur >= sc->end;
+}
@@ -4,14 +4,23 @@
 #include "logging.h"
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <inttypes.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
 #include <time.h>
+#include <unistd.h>
+#include <errno.h>
 
-static YureiLogLevel g_level = YUREI_LOG_INFO;
+#include "futex.h"
+
+YureiLogLevel yurei_log_threshold = YUREI_LOG_INFO;
 static bool g_color_enabled = true;
-static pthread_mutex_t g_log_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 // ANSI color codes
 #define ANSI_RESET   "\033[0m"
@@ -22,8 +31,69 @@ static pthread_mutex_t g_log_mutex = PTHREAD_MUTEX_INITIALIZER;
 #define ANSI_RED     "\033[31m"
 #define ANSI_BOLD    "\033[1m"
 
+// Per-thread ring of formatted lines (power of two)
+#define LOG_RING_BYTES (64u * 1024u)
+// Longest message kept; longer ones are cut and end in "..."
+#define LOG_LINE_MAX 2048u
+// Lines per writev; three iovecs each, within IOV_MAX
+#define LOG_FLUSH_BATCH 256
+// The flusher wakes at least this often even without a notification
+#define LOG_FLUSH_IDLE_NS 100000000L
+#define LOG_PREFIX_MAX 64
+#define LOG_RECORD_ALIGN 16u
+// Record level marking padding up to the end of the ring
+#define LOG_PAD_LEVEL 0xFF
+
+typedef struct {
+    uint32_t size;  // bytes to the next record, header included
+    uint16_t text_len;
+    uint8_t level;
+    uint8_t reserved;
+    uint64_t realtime_ns;
+    // text follows
+} LogRecord;
+
+_Static_assert(sizeof(LogRecord) == LOG_RECORD_ALIGN, "log record header is one alignment unit");
+
+enum { RING_OWNED, RING_ABANDONED, RING_FREE };
+
+// Single-producer single-consumer byte ring. The owning thread formats into
+// it; only the flusher (or a synchronous drain once it is gone) consumes.
+typedef struct LogRing {
+    _Alignas(64) _Atomic uint64_t tail;  // producer position
+    _Alignas(64) _Atomic uint64_t head;  // consumer position
+    _Atomic int state;
+    struct LogRing *next;
+    uint8_t data[LOG_RING_BYTES];
+} LogRing;
+
+// Seconds are formatted once and reused for every line within them
+typedef struct {
+    time_t second;
+    char text[32];
+} TimestampCache;
+
+static _Atomic(LogRing *) g_rings;
+static _Thread_local LogRing *tls_ring;
+static pthread_key_t g_ring_key;
+static pthread_once_t g_ring_key_once = PTHREAD_ONCE_INIT;
+
+static _Atomic bool g_async;
+static _Atomic bool g_flusher_stop;
+static pthread_t g_flusher;
+static _Atomic uint32_t g_wake;
+static _Atomic uint32_t g_wake_waiters;
+static _Atomic uint64_t g_dropped;
+static _Atomic uint64_t g_suppressed;
+static _Atomic(YureiLogSite *) g_sites;  // rate-limited sites that have suppressed a line
+static uint64_t g_dropped_reported;  // flusher-only
+
+// Synchronous path: before the flusher starts and after it stops
+static pthread_mutex_t g_log_mutex = PTHREAD_MUTEX_INITIALIZER;
+static TimestampCache g_sync_timestamp;
+
 void yurei_log_set_level(YureiLogLevel level) {
-    g_level = level;
+    yurei_log_threshold = level;
 }
 
 void yurei_log_set_color(bool enabled) {
@@ -65,34 +135,448 @@ static const char *level_to_color(YureiLogLevel level) {
     }
 }
 
-void yurei_log(YureiLogLevel level, const char *fmt, ...) {
-    if (level < g_level) {
+static uint64_t realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// "<color>YYYY-mm-dd HH:MM:SS.uuuuuu [LEVEL]<reset> " with microsecond precision
+static size_t format_prefix(TimestampCache *cache,
+                            uint64_t when_ns,
+                            YureiLogLevel level,
+                            char *out,
+                            size_t out_len) {
+    time_t second = (time_t)(when_ns / 1000000000ULL);
+    if (second != cache->second || !cache->text[0]) {
+        struct tm tm_info;
+        localtime_r(&second, &tm_info);
+        strftime(cache->text, sizeof(cache->text), "%Y-%m-%d %H:%M:%S", &tm_info);
+        cache->second = second;
+    }
+    int n = snprintf(out, out_len, "%s%s.%06lu [%s]%s ",
+                     level_to_color(level), cache->text,
+                     (unsigned long)(when_ns % 1000000000ULL / 1000ULL),
+                     level_to_string(level), g_color_enabled ? ANSI_RESET : "");
+    return n < 0 ? 0 : ((size_t)n < out_len ? (size_t)n : out_len - 1);
+}
+
+static size_t format_message(char *out, const char *fmt, va_list args) {
+    int n = vsnprintf(out, LOG_LINE_MAX, fmt, args);
+    if (n < 0) {
+        return 0;
+    }
+    if ((size_t)n >= LOG_LINE_MAX) {
+        memcpy(out + LOG_LINE_MAX - 4, "...", 3);
+        return LOG_LINE_MAX - 1;
+    }
+    return (size_t)n;
+}
+
+// writev every byte, resuming after partial writes
+static void write_all(struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t written = writev(STDERR_FILENO, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        while (count > 0 && (size_t)written >= iov->iov_len) {
+            written -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + written;
+            iov->iov_len -= (size_t)written;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Per-thread rings
+// ---------------------------------------------------------------------------
+
+static void release_ring(void *arg) {
+    LogRing *ring = (LogRing *)arg;
+    atomic_store_explicit(&ring->state, RING_ABANDONED, memory_order_release);
+}
+
+static void create_ring_key(void) {
+    pthread_key_create(&g_ring_key, release_ring);
+}
+
+// The calling thread's ring: a recycled one left by an exited thread, or a
+// new one pushed on the list. NULL if memory is short.
+static LogRing *thread_ring(void) {
+    if (tls_ring) {
+        return tls_ring;
+    }
+    pthread_once(&g_ring_key_once, create_ring_key);
+    LogRing *ring = NULL;
+    for (LogRing *r = atomic_load_explicit(&g_rings, memory_order_acquire); r; r = r->next) {
+        int expected = RING_FREE;
+        if (atomic_compare_exchange_strong(&r->state, &expected, RING_OWNED)) {
+            ring = r;
+            break;
+        }
+    }
+    if (!ring) {
+        if (posix_memalign((void **)&ring, 64, sizeof(LogRing)) != 0) {
+            return NULL;
+        }
+        atomic_init(&ring->tail, 0);
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->state, RING_OWNED);
+        LogRing *top = atomic_load_explicit(&g_rings, memory_order_relaxed);
+        do {
+            ring->next = top;
+        } while (!atomic_compare_exchange_weak_explicit(&g_rings, &top, ring,
+                                                        memory_order_release,
+                                                        memory_order_relaxed));
+    }
+    pthread_setspecific(g_ring_key, ring);
+    tls_ring = ring;
+    return ring;
+}
+
+// Copy one line into the ring without ever waiting; false if it is full
+static bool ring_put(LogRing *ring, YureiLogLevel level, uint64_t when_ns, const char *text, size_t len) {
+    uint32_t need = (uint32_t)((sizeof(LogRecord) + len + LOG_RECORD_ALIGN - 1) & ~(LOG_RECORD_ALIGN - 1));
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t offset = (size_t)(tail & (LOG_RING_BYTES - 1));
+    size_t contiguous = LOG_RING_BYTES - offset;
+    size_t pad = contiguous < need ? contiguous : 0;
+    if (tail + pad + need - head > LOG_RING_BYTES) {
+        return false;
+    }
+    if (pad) {
+        LogRecord *filler = (LogRecord *)(ring->data + offset);
+        filler->size = (uint32_t)pad;
+        filler->level = LOG_PAD_LEVEL;
+        tail += pad;
+        offset = 0;
+    }
+    LogRecord *record = (LogRecord *)(ring->data + offset);
+    record->size = need;
+    record->text_len = (uint16_t)len;
+    record->level = (uint8_t)level;
+    record->realtime_ns = when_ns;
+    memcpy(record + 1, text, len);
+    atomic_store_explicit(&ring->tail, tail + need, memory_order_release);
+    return true;
+}
+
+// Next real record at or after *head, skipping padding; NULL if none
+static const LogRecord *ring_peek(LogRing *ring, uint64_t *head, uint64_t tail) {
+    while (*head < tail) {
+        const LogRecord *record = (const LogRecord *)(ring->data + (*head & (LOG_RING_BYTES - 1)));
+        if (record->level != LOG_PAD_LEVEL) {
+            return record;
+        }
+        *head += record->size;
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Flushing
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    LogRing *ring;
+    uint64_t head;
+    uint64_t tail;
+} RingCursor;
+
+// Write out up to one batch of lines from every ring, merged by timestamp so
+// threads interleave in order. Returns the number of lines written.
+static size_t flush_batch(TimestampCache *cache) {
+    static RingCursor cursors[LOG_FLUSH_BATCH];
+    static struct iovec iov[LOG_FLUSH_BATCH * 3];
+    static char prefixes[LOG_FLUSH_BATCH][LOG_PREFIX_MAX];
+    static const char newline = '\n';
+
+    size_t ring_count = 0;
+    for (LogRing *r = atomic_load_explicit(&g_rings, memory_order_acquire);
+         r && ring_count < LOG_FLUSH_BATCH; r = r->next) {
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+        uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (head != tail) {
+            cursors[ring_count++] = (RingCursor){r, head, tail};
+        }
+    }
+
+    size_t lines = 0;
+    while (lines < LOG_FLUSH_BATCH) {
+        RingCursor *oldest = NULL;
+        const LogRecord *oldest_record = NULL;
+        for (size_t i = 0; i < ring_count; ++i) {
+            const LogRecord *record = ring_peek(cursors[i].ring, &cursors[i].head, cursors[i].tail);
+            if (record && (!oldest_record || record->realtime_ns < oldest_record->realtime_ns)) {
+                oldest = &cursors[i];
+                oldest_record = record;
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        size_t prefix_len = format_prefix(cache, oldest_record->realtime_ns,
+                                          (YureiLogLevel)oldest_record->level,
+                                          prefixes[lines], LOG_PREFIX_MAX);
+        iov[lines * 3] = (struct iovec){prefixes[lines], prefix_len};
+        iov[lines * 3 + 1] = (struct iovec){(void *)(oldest_record + 1), oldest_record->text_len};
+        iov[lines * 3 + 2] = (struct iovec){(void *)&newline, 1};
+        oldest->head += oldest_record->size;
+        lines++;
+    }
+    if (lines > 0) {
+        write_all(iov, (int)(lines * 3));
+    }
+    // The text lives in the rings until written; only now hand the space back
+    for (size_t i = 0; i < ring_count; ++i) {
+        atomic_store_explicit(&cursors[i].ring->head, cursors[i].head, memory_order_release);
+    }
+    return lines;
+}
+
+static void report_drops(TimestampCache *cache) {
+    uint64_t dropped = atomic_load_explicit(&g_dropped, memory_order_relaxed);
+    if (dropped == g_dropped_reported) {
         return;
     }
+    char prefix[LOG_PREFIX_MAX];
+    char text[96];
+    size_t prefix_len = format_prefix(cache, realtime_ns(), YUREI_LOG_WARN, prefix, sizeof(prefix));
+    int len = snprintf(text, sizeof(text), "Log rings full: %" PRIu64 " lines dropped\n",
+                       dropped - g_dropped_reported);
+    struct iovec iov[2] = {{prefix, prefix_len}, {text, (size_t)len}};
+    write_all(iov, 2);
+    g_dropped_reported = dropped;
+}
 
-    pthread_mutex_lock(&g_log_mutex);
-    
+static uint64_t coarse_ns(void) {
+    // The coarse clock is a vDSO read with no syscall; tick-level accuracy
+    // is plenty for a one-second window
     struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    struct tm tm_info;
-    localtime_r(&ts.tv_sec, &tm_info);
-    
-    char buffer[64];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm_info);
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// A site only reports its tally when it fires again, so the end of a storm
+// would go unreported. Report sites whose interval ran out quietly, taking
+// the window as yurei_log_site_admit would; all reports every tally (stop).
+static void report_suppressed(TimestampCache *cache, bool all) {
+    const uint64_t interval = (uint64_t)YUREI_LOG_SITE_INTERVAL_MS * 1000000ULL;
+    uint64_t now = coarse_ns();
+    for (YureiLogSite *site = atomic_load_explicit(&g_sites, memory_order_acquire); site;
+         site = site->next) {
+        if (atomic_load_explicit(&site->suppressed, memory_order_relaxed) == 0) {
+            continue;
+        }
+        if (!all) {
+            uint64_t window = atomic_load_explicit(&site->window_ns, memory_order_relaxed);
+            if (now - window < interval ||
+                !atomic_compare_exchange_strong_explicit(&site->window_ns, &window, now,
+                                                         memory_order_relaxed, memory_order_relaxed)) {
+                continue;
+            }
+            atomic_store_explicit(&site->emitted, 0, memory_order_relaxed);
+        }
+        uint64_t suppressed = atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed);
+        if (suppressed == 0) {
+            continue;
+        }
+        const char *file = strrchr(site->file, '/');
+        char prefix[LOG_PREFIX_MAX];
+        char text[LOG_LINE_MAX];
+        size_t prefix_len = format_prefix(cache, realtime_ns(), site->severity, prefix, sizeof(prefix));
+        int len = snprintf(text, sizeof(text), "Suppressed %" PRIu64 " similar messages (%s:%d: %s)\n",
+                           suppressed, file ? file + 1 : site->file, site->line, site->format);
+        if (len <= 0) {
+            continue;
+        }
+        size_t text_len = (size_t)len < sizeof(text) ? (size_t)len : sizeof(text) - 1;
+        struct iovec iov[2] = {{prefix, prefix_len}, {text, text_len}};
+        write_all(iov, 2);
+    }
+}
+
+static bool rings_pending(void) {
+    for (LogRing *r = atomic_load_explicit(&g_rings, memory_order_acquire); r; r = r->next) {
+        if (atomic_load_explicit(&r->head, memory_order_relaxed) !=
+            atomic_load_explicit(&r->tail, memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Rings of exited threads become reusable once drained
+static void recycle_rings(void) {
+    for (LogRing *r = atomic_load_explicit(&g_rings, memory_order_acquire); r; r = r->next) {
+        if (atomic_load_explicit(&r->state, memory_order_acquire) == RING_ABANDONED &&
+            atomic_load_explicit(&r->head, memory_order_relaxed) ==
+                atomic_load_explicit(&r->tail, memory_order_acquire)) {
+            atomic_store_explicit(&r->state, RING_FREE, memory_order_release);
+        }
+    }
+}
+
+static void *flusher_thread(void *arg) {
+    (void)arg;
+    TimestampCache cache = {0};
+    const struct timespec idle = {0, LOG_FLUSH_IDLE_NS};
+    for (;;) {
+        uint32_t observed = atomic_load_explicit(&g_wake, memory_order_acquire);
+        size_t lines = flush_batch(&cache);
+        report_drops(&cache);
+        if (lines > 0) {
+            continue;
+        }
+        recycle_rings();
+        if (atomic_load_explicit(&g_flusher_stop, memory_order_acquire)) {
+            report_suppressed(&cache, true);
+            break;
+        }
+        report_suppressed(&cache, false);
+        atomic_fetch_add_explicit(&g_wake_waiters, 1, memory_order_seq_cst);
+        if (!rings_pending()) {
+            yurei_futex_wait(&g_wake, observed, &idle);
+        }
+        atomic_fetch_sub_explicit(&g_wake_waiters, 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+int yurei_log_start(void) {
+    if (atomic_load(&g_async)) {
+        return 0;
+    }
+    atomic_store(&g_flusher_stop, false);
+    if (pthread_create(&g_flusher, NULL, flusher_thread, NULL) != 0) {
+        return -1;
+    }
+    atomic_store_explicit(&g_async, true, memory_order_release);
+    // Error paths that return from main still get their last lines out
+    static bool exit_hook;
+    if (!exit_hook) {
+        exit_hook = atexit(yurei_log_stop) == 0;
+    }
+    return 0;
+}
+
+void yurei_log_stop(void) {
+    if (!atomic_load(&g_async)) {
+        return;
+    }
+    atomic_store_explicit(&g_async, false, memory_order_release);
+    atomic_store_explicit(&g_flusher_stop, true, memory_order_release);
+    atomic_fetch_add_explicit(&g_wake, 1, memory_order_release);
+    yurei_futex_wake_all(&g_wake);
+    pthread_join(g_flusher, NULL);
+    // Lines that raced with the switch back to synchronous writes
+    pthread_mutex_lock(&g_log_mutex);
+    while (flush_batch(&g_sync_timestamp) > 0) {
+    }
+    pthread_mutex_unlock(&g_log_mutex);
+}
+
+uint64_t yurei_log_dropped(void) {
+    return atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
 
-    const char *color = level_to_color(level);
-    const char *reset = g_color_enabled ? ANSI_RESET : "";
+// Queue (or, without a flusher, write) one formatted line
+static void emit(YureiLogLevel level, uint64_t when_ns, const char *text, size_t len) {
+    if (atomic_load_explicit(&g_async, memory_order_acquire)) {
+        LogRing *ring = thread_ring();
+        if (ring && ring_put(ring, level, when_ns, text, len)) {
+            yurei_futex_notify(&g_wake, &g_wake_waiters);
+        } else {
+            atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        }
+        return;
+    }
 
-    // Microsecond precision timestamp
-    fprintf(stderr, "%s%s.%06ld [%s]%s ",
-            color, buffer, ts.tv_nsec / 1000L,
-            level_to_string(level), reset);
+    pthread_mutex_lock(&g_log_mutex);
+    char prefix[LOG_PREFIX_MAX];
+    size_t prefix_len = format_prefix(&g_sync_timestamp, when_ns, level, prefix, sizeof(prefix));
+    struct iovec iov[3] = {{prefix, prefix_len}, {(void *)text, len}, {(void *)"\n", 1}};
+    write_all(iov, 3);
+    pthread_mutex_unlock(&g_log_mutex);
+}
+
+void yurei_log(YureiLogLevel level, const char *fmt, ...) {
+    if (level < yurei_log_threshold) {
+        return;
+    }
 
+    uint64_t when_ns = realtime_ns();
+    char text[LOG_LINE_MAX];
     va_list args;
     va_start(args, fmt);
-    vfprintf(stderr, fmt, args);
+    size_t len = format_message(text, fmt, args);
     va_end(args);
-    fprintf(stderr, "\n");
-    
-    pthread_mutex_unlock(&g_log_mutex);
+    emit(level, when_ns, text, len);
+}
+
+// Put a site on the flusher's list the first time it suppresses a line
+static void register_site(YureiLogSite *site) {
+    if (atomic_exchange_explicit(&site->registered, true, memory_order_relaxed)) {
+        return;
+    }
+    YureiLogSite *head = atomic_load_explicit(&g_sites, memory_order_relaxed);
+    do {
+        site->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_sites, &head, site,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+uint64_t yurei_log_site_admit(YureiLogSite *site) {
+    uint64_t now = coarse_ns();
+    const uint64_t interval = (uint64_t)YUREI_LOG_SITE_INTERVAL_MS * 1000000ULL;
+
+    uint64_t suppressed = 0;
+    uint64_t window = atomic_load_explicit(&site->window_ns, memory_order_relaxed);
+    if (now - window >= interval &&
+        atomic_compare_exchange_strong_explicit(&site->window_ns, &window, now,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        // This thread opened the window; it carries the previous one's tally
+        atomic_store_explicit(&site->emitted, 0, memory_order_relaxed);
+        suppressed = atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed);
+    }
+    if (atomic_fetch_add_explicit(&site->emitted, 1, memory_order_relaxed) < YUREI_LOG_SITE_BURST) {
+        return suppressed + 1;
+    }
+    // Over budget; a tally taken by a racing reset goes back for the next line
+    if (!atomic_load_explicit(&site->registered, memory_order_relaxed)) {
+        register_site(site);
+    }
+    atomic_fetch_add_explicit(&site->suppressed, suppressed + 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_suppressed, 1, memory_order_relaxed);
+    return 0;
+}
+
+void yurei_log_site(YureiLogLevel level, uint64_t suppressed, const char *fmt, ...) {
+    uint64_t when_ns = realtime_ns();
+    char text[LOG_LINE_MAX];
+    va_list args;
+    va_start(args, fmt);
+    size_t len = format_message(text, fmt, args);
+    va_end(args);
+    if (suppressed > 0) {
+        int n = snprintf(text + len, LOG_LINE_MAX - len,
+                         " (suppressed %" PRIu64 " similar messages)", suppressed);
+        if (n > 0) {
+            len += (size_t)n < LOG_LINE_MAX - len ? (size_t)n : LOG_LINE_MAX - len - 1;
+        }
+    }
+    emit(level, when_ns, text, len);
+}
+
+uint64_t yurei_log_suppressed(void) {
+    return atomic_load_explicit(&g_suppressed, memory_order_relaxed);
 }
@@ -10,13 +10,19 @@
 #include <time.h>
 #include <unistd.h>
 
+#include "base64.h"
+#include "capture.h"
 #include "config.h"
 #include "db_writer.h"
-#include "event_queue.h"
 #include "http_poller.h"
 #include "logging.h"
 #include "metrics.h"
+#include "metrics_server.h"
+#include "parser_pool.h"
+#include "pipeline.h"
 #include "rate_limiter.h"
+#include "sharded_queue.h"
+#include "spill_queue.h"
 #include "websocket_client.h"
 
 #define YUREI_VERSION "1.1.0"
@@ -44,10 +50,46 @@ static void print_startup_banner(const YureiConfig *config) {
     YUREI_LOG_INFO("╚════════════════════════════════════════════════════════════╝");
     YUREI_LOG_INFO("RPC endpoint: %s", config->rpc_endpoint);
     YUREI_LOG_INFO("WSS endpoint: %s", config->wss_endpoint);
-    YUREI_LOG_INFO("Mode: %s | Batch size: %u | Rate limit: %u rps",
-                   config->rpc_mode, config->batch_size, config->rate_limit_rps);
-    YUREI_LOG_INFO("Queue capacity: %zu | Log color: %s",
-                   config->queue_capacity, config->log_color ? "enabled" : "disabled");
+    YUREI_LOG_INFO("Mode: %s | Batch size: %u | Rate limit: %u rps | DB writers: %u",
+                   config->rpc_mode, config->batch_size, config->rate_limit_rps,
+                   config->db_writers);
+    YUREI_LOG_INFO("Queue capacity: %zu | Log color: %s | Base64: %s",
+                   config->queue_capacity, config->log_color ? "enabled" : "disabled",
+                   yurei_base64_impl_name(yurei_base64_active_impl()));
+}
+
+// One spill per writer shard, each with an equal share of the size cap.
+// Returns NULL when spilling is off or unavailable.
+static YureiSpillQueue *open_spills(const YureiConfig *config, size_t count) {
+    if (!config->spill_dir[0]) {
+        return NULL;
+    }
+    YureiSpillQueue *spills = calloc(count, sizeof(YureiSpillQueue));
+    if (!spills) {
+        return NULL;
+    }
+    uint64_t per_shard = config->spill_max_bytes / count;
+    for (size_t i = 0; i < count; ++i) {
+        if (yurei_spill_init(&spills[i], config->spill_dir, i, per_shard) != 0) {
+            YUREI_LOG_WARN("Unable to open spill in %s; full queues will block", config->spill_dir);
+            for (size_t j = 0; j < i; ++j) {
+                yurei_spill_destroy(&spills[j]);
+            }
+            free(spills);
+            return NULL;
+        }
+    }
+    return spills;
+}
+
+static void close_spills(YureiSpillQueue *spills, size_t count) {
+    if (!spills) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        yurei_spill_destroy(&spills[i]);
+    }
+    free(spills);
 }
 
 static void usage(const char *prog) {
@@ -78,6 +120,11 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    // Hot-path threads log into per-thread rings from here on
+    if (yurei_log_start() != 0) {
+        YUREI_LOG_WARN("Failed to start log flusher; logging synchronously");
+    }
+
     print_startup_banner(&config);
 
     // Initialize metrics
@@ -93,30 +140,66 @@ int main(int argc, char **argv) {
     }
     YUREI_LOG_DEBUG("Rate limiter initialized: %u rps", config.rate_limit_rps);
 
-    YureiEventQueue queue;
-    if (yurei_queue_init(&queue, config.queue_capacity) != 0) {
+    YureiShardedQueue queue;
+    if (yurei_sharded_queue_init(&queue, config.db_writers, config.queue_capacity) != 0) {
         YUREI_LOG_ERROR("Unable to initialize event queue");
         yurei_rate_limiter_destroy(&rate_limiter);
         return 1;
     }
+    // Shared by the parsers, poller and writers; the optional parts are
+    // filled in as they come up
+    YureiPipeline pipeline;
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.queue = &queue;
+    pipeline.metrics = &metrics;
+    YureiSpillQueue *spills = open_spills(&config, queue.count);
+    pipeline.spills = spills;
+
+    YureiDedupCache dedup;
+    memset(&dedup, 0, sizeof(dedup));
+    if (config.dedup_entries > 0) {
+        if (yurei_dedup_init(&dedup, config.dedup_entries, config.dedup_window_slots) == 0) {
+            pipeline.dedup = &dedup;
+        } else {
+            YUREI_LOG_WARN("Unable to allocate dedup cache; duplicates will reach the DB");
+        }
+    }
 
     YureiDbWriter writer;
-    if (yurei_db_writer_start(&writer, &config, &queue) != 0) {
-        YUREI_LOG_ERROR("Unable to start DB writer thread");
-        yurei_queue_destroy(&queue);
+    if (yurei_db_writer_start(&writer, &config, &pipeline) != 0) {
+        YUREI_LOG_ERROR("Unable to start DB writer threads");
+        yurei_dedup_destroy(&dedup);
+        close_spills(spills, queue.count);
+        yurei_sharded_queue_destroy(&queue);
         yurei_rate_limiter_destroy(&rate_limiter);
+        yurei_metrics_destroy(&metrics);
         return 1;
     }
 
-    bool use_ws = strcasecmp(config.rpc_mode, YUREI_RPC_MODE_HTTP) != 0;
+    bool replay = strcasecmp(config.rpc_mode, YUREI_RPC_MODE_REPLAY) == 0;
+    bool use_ws = !replay && strcasecmp(config.rpc_mode, YUREI_RPC_MODE_HTTP) != 0;
     bool use_http = strcasecmp(config.rpc_mode, YUREI_RPC_MODE_HTTP) == 0 ||
                     strcasecmp(config.rpc_mode, YUREI_RPC_MODE_DUAL) == 0;
 
+    YureiCapture capture;
+    memset(&capture, 0, sizeof(capture));
+    if (!replay && config.capture_file[0]) {
+        if (yurei_capture_open(&capture, config.capture_file) == 0) {
+            pipeline.capture = &capture;
+        } else {
+            YUREI_LOG_WARN("Traffic recording disabled");
+        }
+    }
+
+    YureiParserPool parsers;
+    memset(&parsers, 0, sizeof(parsers));
     YureiWebsocketClient ws_client;
     memset(&ws_client, 0, sizeof(ws_client));
     if (use_ws) {
-        if (yurei_ws_client_start(&ws_client, &config, &queue) != 0) {
+        if (yurei_parser_pool_start(&parsers, &config, &pipeline) != 0 ||
+            yurei_ws_client_start(&ws_client, &config, &parsers) != 0) {
             YUREI_LOG_WARN("Failed to start WebSocket client; falling back to HTTP");
+            yurei_parser_pool_stop(&parsers);
             use_ws = false;
             use_http = true;
         }
@@ -125,14 +208,29 @@ int main(int argc, char **argv) {
     YureiHttpPoller http_poller;
     memset(&http_poller, 0, sizeof(http_poller));
     if (use_http) {
-        if (yurei_http_poller_start(&http_poller, &config, &queue, &metrics, &rate_limiter) != 0) {
+        if (yurei_http_poller_start(&http_poller, &config, &pipeline, &rate_limiter) != 0) {
             YUREI_LOG_ERROR("Failed to start HTTP poller");
         }
     }
 
+    YureiMetricsServer metrics_server;
+    if (yurei_metrics_server_start(&metrics_server, &config, &pipeline,
+                                   use_ws ? &parsers : NULL, use_ws ? &ws_client : NULL) != 0) {
+        YUREI_LOG_WARN("Metrics endpoint unavailable; metrics are still logged");
+    }
+
     install_signal_handlers();
     YUREI_LOG_INFO("Yurei JSON-RPC client started successfully (mode=%s)", config.rpc_mode);
 
+    if (replay) {
+        bool paced = strcasecmp(config.replay_pace, YUREI_REPLAY_PACE_MAX) != 0;
+        if (yurei_capture_replay(config.replay_file, &config, &pipeline, paced,
+                                 &g_should_exit, NULL) != 0) {
+            YUREI_LOG_ERROR("Replay of %s failed", config.replay_file);
+        }
+        g_should_exit = 1;
+    }
+
     // Main loop with periodic metrics logging
     time_t last_metrics_log = time(NULL);
     while (!g_should_exit) {
@@ -141,6 +239,8 @@ int main(int argc, char **argv) {
         time_t now = time(NULL);
         if (now - last_metrics_log >= METRICS_LOG_INTERVAL_SEC) {
             yurei_metrics_log(&metrics);
+            yurei_dedup_log(pipeline.dedup);
+            yurei_ws_client_log(&ws_client);
             last_metrics_log = now;
         }
     }
@@ -150,20 +250,31 @@ int main(int argc, char **argv) {
     // Final metrics log
     YUREI_LOG_INFO("Final metrics before shutdown:");
     yurei_metrics_log(&metrics);
+    yurei_dedup_log(pipeline.dedup);
+    yurei_ws_client_log(&ws_client);
     
+    yurei_metrics_server_stop(&metrics_server);
     if (use_ws) {
         yurei_ws_client_stop(&ws_client);
+        yurei_parser_pool_stop(&parsers);
     }
     if (use_http && http_poller.running) {
         yurei_http_poller_stop(&http_poller);
     }
+    // Producers are stopped; nothing records past this point
+    pipeline.capture = NULL;
+    yurei_capture_close(&capture);
 
-    yurei_queue_close(&queue);
+    yurei_sharded_queue_close(&queue);
     yurei_db_writer_stop(&writer);
-    yurei_queue_destroy(&queue);
+    close_spills(spills, queue.count);
+    yurei_sharded_queue_destroy(&queue);
+    yurei_dedup_destroy(&dedup);
     yurei_rate_limiter_destroy(&rate_limiter);
+    yurei_metrics_destroy(&metrics);
     
     YUREI_LOG_INFO("Shutdown complete.");
+    yurei_log_stop();
     return 0;
 }
 
@@ -0,0 +1,220 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "message_ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "futex.h"
+
+#define MESSAGE_RING_MIN_CAPACITY (64u * 1024u)
+// One descriptor per this many buffer bytes; notifications average 1-3 KiB
+#define MESSAGE_RING_BYTES_PER_SLOT 256u
+// Record alignment inside the byte buffer
+#define MESSAGE_RING_ALIGN 16u
+
+static uint64_t align_up(uint64_t value) {
+    return (value + MESSAGE_RING_ALIGN - 1) & ~(uint64_t)(MESSAGE_RING_ALIGN - 1);
+}
+
+int yurei_message_ring_init(YureiMessageRing *ring, size_t capacity) {
+    if (!ring) {
+        return -1;
+    }
+    memset(ring, 0, sizeof(*ring));
+    size_t rounded = MESSAGE_RING_MIN_CAPACITY;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    size_t slots = rounded / MESSAGE_RING_BYTES_PER_SLOT;
+    ring->buffer = aligned_alloc(YUREI_CACHE_LINE, rounded);
+    ring->slots = calloc(slots, sizeof(YureiMessage));
+    if (!ring->buffer || !ring->slots) {
+        yurei_message_ring_destroy(ring);
+        return -1;
+    }
+    ring->capacity = rounded;
+    ring->mask = rounded - 1;
+    ring->slot_mask = slots - 1;
+    return 0;
+}
+
+void yurei_message_ring_destroy(YureiMessageRing *ring) {
+    if (!ring) {
+        return;
+    }
+    // Oversized copies of messages nobody took
+    for (size_t i = 0; ring->slots && i <= ring->slot_mask; ++i) {
+        if (ring->slots[i].heap) {
+            free((char *)ring->slots[i].data);
+        }
+    }
+    free(ring->buffer);
+    free(ring->slots);
+    ring->buffer = NULL;
+    ring->slots = NULL;
+    ring->capacity = 0;
+}
+
+size_t yurei_message_ring_max_message(const YureiMessageRing *ring) {
+    // Half the buffer guarantees a message fits, even after skipping the
+    // tail to wrap, once the ring has drained
+    return ring->capacity / 2;
+}
+
+// Advance reclaim over the prefix of claimed slots that are done
+static void reclaim_done(YureiMessageRing *ring) {
+    uint64_t read = atomic_load_explicit(&ring->read, memory_order_acquire);
+    while (ring->reclaim < read) {
+        YureiMessage *slot = &ring->slots[ring->reclaim & ring->slot_mask];
+        if (!atomic_load_explicit(&slot->done, memory_order_acquire)) {
+            break;
+        }
+        ring->reclaim_pos = slot->end;
+        ring->reclaim++;
+    }
+}
+
+static bool has_room(const YureiMessageRing *ring, uint64_t seq, uint64_t end) {
+    return seq - ring->reclaim <= ring->slot_mask && end - ring->reclaim_pos <= ring->capacity;
+}
+
+typedef enum {
+    PUT_OK,
+    PUT_FULL,
+    PUT_FAILED,
+} PutResult;
+
+static PutResult try_put(YureiMessageRing *ring, const void *data, size_t len, uint64_t received_ns) {
+    if (atomic_load_explicit(&ring->closed, memory_order_relaxed)) {
+        return PUT_FAILED;
+    }
+    bool heap = len > yurei_message_ring_max_message(ring);
+    uint64_t start = ring->write_pos;
+    uint64_t end = start;
+    if (!heap) {
+        // Messages are contiguous: skip the tail if this one would straddle the wrap
+        size_t room = ring->capacity - (start & ring->mask);
+        if (len > room) {
+            start += room;
+        }
+        end = align_up(start + len);
+    }
+    uint64_t seq = atomic_load_explicit(&ring->write, memory_order_relaxed);
+    if (!has_room(ring, seq, end)) {
+        reclaim_done(ring);
+        if (!has_room(ring, seq, end)) {
+            return PUT_FULL;
+        }
+    }
+
+    char *dst = heap ? malloc(len) : ring->buffer + (start & ring->mask);
+    if (!dst) {
+        return PUT_FAILED;
+    }
+    memcpy(dst, data, len);
+    YureiMessage *slot = &ring->slots[seq & ring->slot_mask];
+    slot->data = dst;
+    slot->len = len;
+    slot->end = end;
+    slot->received_ns = received_ns;
+    slot->heap = heap;
+    atomic_store_explicit(&slot->done, 0, memory_order_relaxed);
+    ring->write_pos = end;
+    // Publishing write releases the bytes and the descriptor to consumers
+    atomic_store_explicit(&ring->write, seq + 1, memory_order_release);
+    yurei_futex_notify(&ring->not_empty, &ring->waiters);
+    return PUT_OK;
+}
+
+int yurei_message_ring_put(YureiMessageRing *ring, const void *data, size_t len, uint64_t received_ns) {
+    if (!ring || !data) {
+        return -1;
+    }
+    return try_put(ring, data, len, received_ns) == PUT_OK ? 0 : -1;
+}
+
+int yurei_message_ring_put_wait(YureiMessageRing *ring, const void *data, size_t len, uint64_t received_ns) {
+    if (!ring || !data) {
+        return -1;
+    }
+    PutResult rc;
+    while ((rc = try_put(ring, data, len, received_ns)) == PUT_FULL) {
+        atomic_fetch_add_explicit(&ring->full_waiters, 1, memory_order_seq_cst);
+        uint32_t observed = atomic_load_explicit(&ring->not_full, memory_order_acquire);
+        // Retry once registered, so a slot finished in between is not missed
+        rc = try_put(ring, data, len, received_ns);
+        if (rc == PUT_FULL) {
+            yurei_futex_wait(&ring->not_full, observed, NULL);
+        }
+        atomic_fetch_sub_explicit(&ring->full_waiters, 1, memory_order_relaxed);
+        if (rc != PUT_FULL) {
+            break;
+        }
+    }
+    return rc == PUT_OK ? 0 : -1;
+}
+
+static void wait_for_message(YureiMessageRing *ring, uint64_t read) {
+    atomic_fetch_add_explicit(&ring->waiters, 1, memory_order_seq_cst);
+    uint32_t observed = atomic_load_explicit(&ring->not_empty, memory_order_acquire);
+    if (atomic_load_explicit(&ring->write, memory_order_acquire) == read &&
+        !atomic_load(&ring->closed)) {
+        yurei_futex_wait(&ring->not_empty, observed, NULL);
+    }
+    atomic_fetch_sub_explicit(&ring->waiters, 1, memory_order_relaxed);
+}
+
+YureiMessage *yurei_message_ring_take(YureiMessageRing *ring) {
+    if (!ring) {
+        return NULL;
+    }
+    uint64_t read = atomic_load_explicit(&ring->read, memory_order_relaxed);
+    for (;;) {
+        uint64_t write = atomic_load_explicit(&ring->write, memory_order_acquire);
+        if (read == write) {
+            if (atomic_load(&ring->closed)) {
+                // A put may have been published just before close
+                if (atomic_load_explicit(&ring->write, memory_order_acquire) == read) {
+                    return NULL;
+                }
+                continue;
+            }
+            wait_for_message(ring, read);
+            read = atomic_load_explicit(&ring->read, memory_order_relaxed);
+            continue;
+        }
+        // The descriptor is only read after the claim succeeds; until it is
+        // marked done the producer cannot reuse it or its bytes
+        if (atomic_compare_exchange_weak_explicit(&ring->read, &read, read + 1,
+                                                  memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            return &ring->slots[read & ring->slot_mask];
+        }
+    }
+}
+
+void yurei_message_ring_done(YureiMessageRing *ring, YureiMessage *message) {
+    if (!ring || !message) {
+        return;
+    }
+    if (message->heap) {
+        free((char *)message->data);
+        message->data = NULL;
+    }
+    atomic_store_explicit(&message->done, 1, memory_order_release);
+    yurei_futex_notify(&ring->not_full, &ring->full_waiters);
+}
+
+void yurei_message_ring_close(YureiMessageRing *ring) {
+    if (!ring) {
+        return;
+    }
+    atomic_store(&ring->closed, true);
+    // Bumped so a sleeper that sampled the word before the store still wakes
+    atomic_fetch_add(&ring->not_empty, 1);
+    atomic_fetch_add(&ring->not_full, 1);
+    yurei_futex_wake_all(&ring->not_empty);
+    yurei_futex_wake_all(&ring->not_full);
+}
@@ -5,48 +5,221 @@
 
 #include <inttypes.h>
 #include <stdatomic.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "logging.h"
 
+#define HIST_SUB_COUNT (1u << YUREI_HIST_SUB_BITS)
+#define HIST_VALUE_MAX ((1ULL << YUREI_HIST_MAX_BITS) - 1)
+
+struct YureiMetricsShard {
+    YureiHistogram stages[YUREI_STAGE_COUNT];
+    _Atomic uint64_t program_events[YUREI_PROGRAMS_MAX];
+    const void *thread;  // address of the owner's thread-local tag
+    YureiMetricsShard *next;
+};
+
+static const char *const STAGE_NAMES[YUREI_STAGE_COUNT] = {
+    "receive_to_parse",
+    "parse",
+    "parse_to_enqueue",
+    "queue_wait",
+    "dequeue_to_commit",
+    "db_commit",
+    "end_to_end",
+    "rpc_request",
+};
+
+// The calling thread's identity and its most recently used shard
+static _Thread_local char tls_thread_tag;
+static _Thread_local YureiMetricsShard *tls_shard;
+static _Thread_local const YureiMetrics *tls_shard_owner;
+
 void yurei_metrics_init(YureiMetrics *m) {
     if (!m) {
         return;
     }
     memset(m, 0, sizeof(*m));
-    atomic_store(&m->latency_min_us, UINT64_MAX);
+    atomic_init(&m->shards, NULL);
+}
+
+void yurei_metrics_destroy(YureiMetrics *m) {
+    if (!m) {
+        return;
+    }
+    YureiMetricsShard *shard = atomic_exchange(&m->shards, NULL);
+    while (shard) {
+        YureiMetricsShard *next = shard->next;
+        free(shard);
+        shard = next;
+    }
+    // Threads that outlive this object must not reuse a cached pointer
+    tls_shard = NULL;
+    tls_shard_owner = NULL;
+}
+
+static YureiMetricsShard *thread_shard(YureiMetrics *m) {
+    if (tls_shard && tls_shard_owner == m) {
+        return tls_shard;
+    }
+    // A thread alternating between metrics objects, or one reusing the
+    // thread-local address of an exited thread, finds its shard again
+    YureiMetricsShard *shard = atomic_load_explicit(&m->shards, memory_order_acquire);
+    while (shard && shard->thread != &tls_thread_tag) {
+        shard = shard->next;
+    }
+    if (!shard) {
+        shard = calloc(1, sizeof(*shard));
+        if (!shard) {
+            return NULL;
+        }
+        shard->thread = &tls_thread_tag;
+        YureiMetricsShard *head = atomic_load_explicit(&m->shards, memory_order_relaxed);
+        do {
+            shard->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&m->shards, &head, shard,
+                                                        memory_order_release,
+                                                        memory_order_relaxed));
+    }
+    tls_shard = shard;
+    tls_shard_owner = m;
+    return shard;
+}
+
+// Single writer: a relaxed load/store pair cannot lose an update
+static void counter_add(_Atomic uint64_t *counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+static size_t bucket_for(uint64_t value) {
+    if (value > HIST_VALUE_MAX) {
+        value = HIST_VALUE_MAX;
+    }
+    if (value < HIST_SUB_COUNT) {
+        return (size_t)value;
+    }
+    unsigned msb = 63u - (unsigned)__builtin_clzll(value);
+    unsigned shift = msb - YUREI_HIST_SUB_BITS;
+    return ((size_t)(shift + 1) << YUREI_HIST_SUB_BITS) +
+           (size_t)((value >> shift) & (HIST_SUB_COUNT - 1));
+}
+
+uint64_t yurei_histogram_bucket_limit(size_t bucket) {
+    if (bucket < HIST_SUB_COUNT) {
+        return bucket;
+    }
+    unsigned shift = (unsigned)(bucket >> YUREI_HIST_SUB_BITS) - 1u;
+    uint64_t sub = bucket & (HIST_SUB_COUNT - 1);
+    return ((HIST_SUB_COUNT + sub) << shift) + ((1ULL << shift) - 1);
+}
+
+void yurei_histogram_record(YureiHistogram *hist, uint64_t value_ns) {
+    counter_add(&hist->counts[bucket_for(value_ns)], 1);
+    counter_add(&hist->sum_ns, value_ns);
+    if (value_ns > atomic_load_explicit(&hist->max_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&hist->max_ns, value_ns, memory_order_relaxed);
+    }
+}
+
+void yurei_metrics_record(YureiMetrics *m, YureiStage stage, uint64_t latency_ns) {
+    if (!m || stage >= YUREI_STAGE_COUNT) {
+        return;
+    }
+    YureiMetricsShard *shard = thread_shard(m);
+    if (!shard) {
+        return;
+    }
+    yurei_histogram_record(&shard->stages[stage], latency_ns);
+}
+
+void yurei_metrics_program_event(YureiMetrics *m, YureiEventKind kind) {
+    if (!m || kind >= YUREI_PROGRAMS_MAX) {
+        return;
+    }
+    YureiMetricsShard *shard = thread_shard(m);
+    if (shard) {
+        counter_add(&shard->program_events[kind], 1);
+    }
+}
+
+uint64_t yurei_metrics_program_events(const YureiMetrics *m, YureiEventKind kind) {
+    if (!m || kind >= YUREI_PROGRAMS_MAX) {
+        return 0;
+    }
+    uint64_t total = 0;
+    const YureiMetricsShard *shard = atomic_load_explicit(&m->shards, memory_order_acquire);
+    for (; shard; shard = shard->next) {
+        total += atomic_load_explicit(&shard->program_events[kind], memory_order_relaxed);
+    }
+    return total;
+}
+
+void yurei_metrics_snapshot(const YureiMetrics *m, YureiStage stage, YureiHistogramSnapshot *out) {
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!m || stage >= YUREI_STAGE_COUNT) {
+        return;
+    }
+    const YureiMetricsShard *shard = atomic_load_explicit(&m->shards, memory_order_acquire);
+    for (; shard; shard = shard->next) {
+        yurei_histogram_merge(out, &shard->stages[stage]);
+    }
+}
+
+void yurei_histogram_merge(YureiHistogramSnapshot *out, const YureiHistogram *hist) {
+    for (size_t i = 0; i < YUREI_HIST_BUCKETS; ++i) {
+        uint64_t n = atomic_load_explicit(&hist->counts[i], memory_order_relaxed);
+        out->counts[i] += n;
+        out->count += n;
+    }
+    out->sum_ns += atomic_load_explicit(&hist->sum_ns, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+    if (max > out->max_ns) {
+        out->max_ns = max;
+    }
+}
+
+uint64_t yurei_histogram_quantile(const YureiHistogramSnapshot *snapshot, double q) {
+    if (!snapshot || snapshot->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(q * (double)snapshot->count);
+    if (rank >= snapshot->count) {
+        rank = snapshot->count - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < YUREI_HIST_BUCKETS; ++i) {
+        seen += snapshot->counts[i];
+        if (seen > rank) {
+            uint64_t limit = yurei_histogram_bucket_limit(i);
+            return limit < snapshot->max_ns ? limit : snapshot->max_ns;
+        }
+    }
+    return snapshot->max_ns;
+}
+
+const char *yurei_stage_name(YureiStage stage) {
+    return stage < YUREI_STAGE_COUNT ? STAGE_NAMES[stage] : "unknown";
 }
 
 void yurei_metrics_request(YureiMetrics *m, bool success, uint64_t latency_us) {
     if (!m) {
         return;
     }
-    
+
     atomic_fetch_add(&m->requests_total, 1);
-    
+
     if (success) {
         atomic_fetch_add(&m->requests_success, 1);
     } else {
         atomic_fetch_add(&m->requests_failed, 1);
     }
-    
-    atomic_fetch_add(&m->latency_sum_us, latency_us);
-    atomic_fetch_add(&m->latency_count, 1);
-    
-    // Update min/max latency (relaxed atomics for performance)
-    uint64_t current_min = atomic_load(&m->latency_min_us);
-    while (latency_us < current_min) {
-        if (atomic_compare_exchange_weak(&m->latency_min_us, &current_min, latency_us)) {
-            break;
-        }
-    }
-    
-    uint64_t current_max = atomic_load(&m->latency_max_us);
-    while (latency_us > current_max) {
-        if (atomic_compare_exchange_weak(&m->latency_max_us, &current_max, latency_us)) {
-            break;
-        }
-    }
+
+    yurei_metrics_record(m, YUREI_STAGE_RPC_REQUEST, latency_us * 1000);
 }
 
 void yurei_metrics_bytes(YureiMetrics *m, uint64_t bytes) {
@@ -70,45 +243,69 @@ void yurei_metrics_ws_reconnect(YureiMetrics *m) {
     atomic_fetch_add(&m->ws_reconnects, 1);
 }
 
+void yurei_metrics_truncated_slot(YureiMetrics *m) {
+    if (!m) {
+        return;
+    }
+    atomic_fetch_add(&m->truncated_slots, 1);
+}
+
 uint64_t yurei_metrics_avg_latency_us(const YureiMetrics *m) {
     if (!m) {
         return 0;
     }
-    uint64_t count = atomic_load(&m->latency_count);
-    if (count == 0) {
+    YureiHistogramSnapshot snapshot;
+    yurei_metrics_snapshot(m, YUREI_STAGE_RPC_REQUEST, &snapshot);
+    if (snapshot.count == 0) {
         return 0;
     }
-    return atomic_load(&m->latency_sum_us) / count;
+    return snapshot.sum_ns / snapshot.count / 1000;
+}
+
+static void log_stage(const YureiMetrics *m, YureiStage stage, YureiHistogramSnapshot *snapshot) {
+    yurei_metrics_snapshot(m, stage, snapshot);
+    if (snapshot->count == 0) {
+        return;
+    }
+    YUREI_LOG_INFO("Latency %-17s n=%" PRIu64 " avg=%.1fus p50=%.1fus p90=%.1fus p99=%.1fus "
+                   "p99.9=%.1fus max=%.1fus",
+                   yurei_stage_name(stage),
+                   snapshot->count,
+                   (double)snapshot->sum_ns / (double)snapshot->count / 1000.0,
+                   (double)yurei_histogram_quantile(snapshot, 0.50) / 1000.0,
+                   (double)yurei_histogram_quantile(snapshot, 0.90) / 1000.0,
+                   (double)yurei_histogram_quantile(snapshot, 0.99) / 1000.0,
+                   (double)yurei_histogram_quantile(snapshot, 0.999) / 1000.0,
+                   (double)snapshot->max_ns / 1000.0);
 }
 
 void yurei_metrics_log(const YureiMetrics *m) {
     if (!m) {
         return;
     }
-    
+
     uint64_t total = atomic_load(&m->requests_total);
     uint64_t success = atomic_load(&m->requests_success);
     uint64_t failed = atomic_load(&m->requests_failed);
     uint64_t events = atomic_load(&m->events_processed);
     uint64_t bytes = atomic_load(&m->bytes_received);
     uint64_t ws_reconn = atomic_load(&m->ws_reconnects);
-    uint64_t avg_lat = yurei_metrics_avg_latency_us(m);
-    uint64_t min_lat = atomic_load(&m->latency_min_us);
-    uint64_t max_lat = atomic_load(&m->latency_max_us);
-    
-    // Handle case where no requests have been made
-    if (min_lat == UINT64_MAX) {
-        min_lat = 0;
-    }
-    
+
     double success_rate = total > 0 ? (double)success / total * 100.0 : 0.0;
     double bytes_kb = (double)bytes / 1024.0;
-    
+
     YUREI_LOG_INFO("=== METRICS ===");
     YUREI_LOG_INFO("Requests: total=%" PRIu64 " success=%" PRIu64 " failed=%" PRIu64 " (%.1f%% success)",
                    total, success, failed, success_rate);
-    YUREI_LOG_INFO("Latency: avg=%" PRIu64 "us min=%" PRIu64 "us max=%" PRIu64 "us",
-                   avg_lat, min_lat, max_lat);
     YUREI_LOG_INFO("Events processed: %" PRIu64 " | Bytes received: %.2f KB | WS reconnects: %" PRIu64,
                    events, bytes_kb, ws_reconn);
+    // One snapshot buffer for all stages; it is several KiB
+    YureiHistogramSnapshot *snapshot = malloc(sizeof(*snapshot));
+    if (!snapshot) {
+        return;
+    }
+    for (int stage = 0; stage < YUREI_STAGE_COUNT; ++stage) {
+        log_stage(m, (YureiStage)stage, snapshot);
+    }
+    free(snapshot);
 }
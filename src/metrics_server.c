@@ -0,0 +1,420 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "metrics_server.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "dedup_cache.h"
+#include "logging.h"
+
+// Longest accept wait, bounding shutdown latency
+#define SERVER_POLL_MS 200
+// Per-connection socket timeout, so a stalled scraper is cut off
+#define SERVER_IO_TIMEOUT_S 2
+#define SERVER_REQUEST_MAX 4096
+#define SERVER_BODY_MIN_CAPACITY (16u * 1024u)
+// Histogram buckets exported at every power of two from 2^10 ns (~1 us)
+// to 2^36 ns (~69 s); the in-process histogram is finer
+#define EXPORT_BUCKET_FIRST_BITS 10
+#define EXPORT_BUCKET_LAST_BITS 36
+
+#define OPENMETRICS_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+static bool body_reserve(YureiMetricsServer *server, size_t extra) {
+    size_t needed = server->body_len + extra + 1;
+    if (needed <= server->body_cap) {
+        return true;
+    }
+    size_t capacity = server->body_cap ? server->body_cap : SERVER_BODY_MIN_CAPACITY;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    char *grown = realloc(server->body, capacity);
+    if (!grown) {
+        return false;
+    }
+    server->body = grown;
+    server->body_cap = capacity;
+    return true;
+}
+
+__attribute__((format(printf, 2, 3)))
+static bool body_append(YureiMetricsServer *server, const char *fmt, ...) {
+    for (;;) {
+        size_t room = server->body_cap - server->body_len;
+        va_list args;
+        va_start(args, fmt);
+        int written = server->body ? vsnprintf(server->body + server->body_len, room, fmt, args) : -1;
+        va_end(args);
+        if (written >= 0 && (size_t)written < room) {
+            server->body_len += (size_t)written;
+            return true;
+        }
+        if (!body_reserve(server, written > 0 ? (size_t)written : 256)) {
+            return false;
+        }
+    }
+}
+
+static void append_counter(YureiMetricsServer *server,
+                           const char *name,
+                           const char *help,
+                           uint64_t value) {
+    body_append(server, "# TYPE %s counter\n# HELP %s %s\n%s_total %" PRIu64 "\n",
+                name, name, help, name, value);
+}
+
+static void append_gauge(YureiMetricsServer *server,
+                         const char *name,
+                         const char *help,
+                         uint64_t value) {
+    body_append(server, "# TYPE %s gauge\n# HELP %s %s\n%s %" PRIu64 "\n",
+                name, name, help, name, value);
+}
+
+// One labelled series of a histogram family, in power-of-two buckets
+static void append_histogram_series(YureiMetricsServer *server,
+                                    const char *name,
+                                    const char *labels,
+                                    const YureiHistogramSnapshot *snapshot) {
+    uint64_t cumulative = 0;
+    size_t bucket = 0;
+    for (unsigned bits = EXPORT_BUCKET_FIRST_BITS; bits <= EXPORT_BUCKET_LAST_BITS; ++bits) {
+        // Internal buckets below 2^bits hold values that are all < 2^bits
+        size_t end = (size_t)(bits - YUREI_HIST_SUB_BITS + 1) << YUREI_HIST_SUB_BITS;
+        for (; bucket < end && bucket < YUREI_HIST_BUCKETS; ++bucket) {
+            cumulative += snapshot->counts[bucket];
+        }
+        body_append(server, "%s_bucket{%s,le=\"%.9g\"} %" PRIu64 "\n",
+                    name, labels, (double)(1ULL << bits) / 1e9, cumulative);
+    }
+    body_append(server, "%s_bucket{%s,le=\"+Inf\"} %" PRIu64 "\n", name, labels, snapshot->count);
+    body_append(server, "%s_count{%s} %" PRIu64 "\n", name, labels, snapshot->count);
+    body_append(server, "%s_sum{%s} %.9f\n", name, labels, (double)snapshot->sum_ns / 1e9);
+}
+
+static void append_stage_histograms(YureiMetricsServer *server, YureiHistogramSnapshot *snapshot) {
+    const char *name = "yurei_stage_latency_seconds";
+    body_append(server, "# TYPE %s histogram\n# UNIT %s seconds\n"
+                        "# HELP %s Latency of each pipeline stage.\n",
+                name, name, name);
+    for (int stage = 0; stage < YUREI_STAGE_COUNT; ++stage) {
+        char labels[64];
+        yurei_metrics_snapshot(server->metrics, (YureiStage)stage, snapshot);
+        snprintf(labels, sizeof(labels), "stage=\"%s\"", yurei_stage_name((YureiStage)stage));
+        append_histogram_series(server, name, labels, snapshot);
+    }
+}
+
+// Per-provider connection state, first-arrival wins and lag behind the
+// fastest provider
+static void append_ws_endpoints(YureiMetricsServer *server, YureiHistogramSnapshot *snapshot) {
+    const YureiWebsocketClient *ws = server->ws;
+    char labels[YUREI_WS_MAX_ENDPOINTS][320];
+    for (size_t i = 0; i < ws->endpoint_count; ++i) {
+        snprintf(labels[i], sizeof(labels[i]), "endpoint=\"%zu\",host=\"%s\"",
+                 i, ws->endpoints[i].host);
+    }
+    body_append(server, "# TYPE yurei_ws_endpoint_connected gauge\n"
+                        "# HELP yurei_ws_endpoint_connected Whether the WebSocket endpoint is connected.\n");
+    for (size_t i = 0; i < ws->endpoint_count; ++i) {
+        body_append(server, "yurei_ws_endpoint_connected{%s} %d\n", labels[i],
+                    atomic_load_explicit(&ws->endpoints[i].connected, memory_order_relaxed) ? 1 : 0);
+    }
+    if (ws->endpoint_count < 2) {
+        return;
+    }
+    body_append(server, "# TYPE yurei_ws_endpoint_notifications counter\n"
+                        "# HELP yurei_ws_endpoint_notifications Notifications received per endpoint.\n");
+    for (size_t i = 0; i < ws->endpoint_count; ++i) {
+        body_append(server, "yurei_ws_endpoint_notifications_total{%s} %" PRIu64 "\n", labels[i],
+                    atomic_load_explicit(&ws->endpoints[i].notifications, memory_order_relaxed));
+    }
+    body_append(server, "# TYPE yurei_ws_endpoint_wins counter\n"
+                        "# HELP yurei_ws_endpoint_wins Notifications this endpoint delivered first.\n");
+    for (size_t i = 0; i < ws->endpoint_count; ++i) {
+        body_append(server, "yurei_ws_endpoint_wins_total{%s} %" PRIu64 "\n", labels[i],
+                    atomic_load_explicit(&ws->endpoints[i].wins, memory_order_relaxed));
+    }
+    body_append(server, "# TYPE yurei_ws_endpoint_dropped counter\n"
+                        "# HELP yurei_ws_endpoint_dropped First copies dropped because the parser "
+                        "buffer was full; another endpoint's copy may still be forwarded.\n");
+    for (size_t i = 0; i < ws->endpoint_count; ++i) {
+        body_append(server, "yurei_ws_endpoint_dropped_total{%s} %" PRIu64 "\n", labels[i],
+                    atomic_load_explicit(&ws->endpoints[i].hedge_dropped, memory_order_relaxed));
+    }
+    const char *name = "yurei_ws_endpoint_lag_seconds";
+    body_append(server, "# TYPE %s histogram\n# UNIT %s seconds\n"
+                        "# HELP %s How far behind the first copy this endpoint's copies arrived.\n",
+                name, name, name);
+    for (size_t i = 0; i < ws->endpoint_count; ++i) {
+        memset(snapshot, 0, sizeof(*snapshot));
+        yurei_histogram_merge(snapshot, &ws->endpoints[i].lag);
+        append_histogram_series(server, name, labels[i], snapshot);
+    }
+}
+
+static void render_metrics(YureiMetricsServer *server, YureiHistogramSnapshot *snapshot) {
+    const YureiMetrics *m = server->metrics;
+    server->body_len = 0;
+
+    body_append(server, "# TYPE yurei_rpc_requests counter\n"
+                        "# HELP yurei_rpc_requests HTTP JSON-RPC requests by outcome.\n");
+    body_append(server, "yurei_rpc_requests_total{result=\"success\"} %" PRIu64 "\n",
+                atomic_load_explicit(&m->requests_success, memory_order_relaxed));
+    body_append(server, "yurei_rpc_requests_total{result=\"failed\"} %" PRIu64 "\n",
+                atomic_load_explicit(&m->requests_failed, memory_order_relaxed));
+    append_counter(server, "yurei_http_events", "Events enqueued by the HTTP poller.",
+                   atomic_load_explicit(&m->events_processed, memory_order_relaxed));
+    append_counter(server, "yurei_received_bytes", "Response bytes received over HTTP.",
+                   atomic_load_explicit(&m->bytes_received, memory_order_relaxed));
+    append_counter(server, "yurei_ws_reconnects", "WebSocket reconnections.",
+                   atomic_load_explicit(&m->ws_reconnects, memory_order_relaxed));
+    append_counter(server, "yurei_http_truncated_slots",
+                   "Slots with more matching log entries than the HTTP poller's largest getLogs page.",
+                   atomic_load_explicit(&m->truncated_slots, memory_order_relaxed));
+    append_counter(server, "yurei_log_dropped_lines", "Log lines dropped because a log ring was full.",
+                   yurei_log_dropped());
+    append_counter(server, "yurei_log_suppressed_lines",
+                   "Log lines held back by rate-limited call sites.", yurei_log_suppressed());
+
+    const YureiProgramRegistry *programs = &server->config->programs;
+    body_append(server, "# TYPE yurei_program_events counter\n"
+                        "# HELP yurei_program_events Events enqueued per program.\n");
+    for (size_t i = 0; i < programs->count; ++i) {
+        body_append(server, "yurei_program_events_total{program=\"%s\"} %" PRIu64 "\n",
+                    programs->programs[i].name,
+                    yurei_metrics_program_events(m, (YureiEventKind)i));
+    }
+
+    const YureiPipeline *pipeline = server->pipeline;
+    const YureiShardedQueue *queue = pipeline->queue;
+    body_append(server, "# TYPE yurei_queue_depth gauge\n"
+                        "# HELP yurei_queue_depth Events waiting for a DB writer, per shard.\n");
+    size_t capacity = 0;
+    for (size_t i = 0; i < queue->count; ++i) {
+        body_append(server, "yurei_queue_depth{shard=\"%zu\"} %zu\n",
+                    i, yurei_queue_depth(&queue->shards[i]));
+        capacity += queue->shards[i].capacity;
+    }
+    append_gauge(server, "yurei_queue_capacity", "Event slots across all shards.", capacity);
+
+    if (pipeline->dedup) {
+        YureiDedupStats stats;
+        yurei_dedup_stats(pipeline->dedup, &stats);
+        body_append(server, "# TYPE yurei_dedup_lookups counter\n"
+                            "# HELP yurei_dedup_lookups Dedup set lookups; hits are dropped duplicates.\n"
+                            "yurei_dedup_lookups_total{result=\"hit\"} %" PRIu64 "\n"
+                            "yurei_dedup_lookups_total{result=\"miss\"} %" PRIu64 "\n",
+                    stats.hits, stats.misses);
+        append_counter(server, "yurei_dedup_evictions", "Live dedup entries evicted early.",
+                       stats.evictions);
+    }
+    if (pipeline->spills) {
+        uint64_t spilled = 0;
+        uint64_t replayed = 0;
+        uint64_t dead_lettered = 0;
+        uint64_t disk_bytes = 0;
+        for (size_t i = 0; i < queue->count; ++i) {
+            const YureiSpillQueue *spill = &pipeline->spills[i];
+            spilled += atomic_load_explicit(&spill->spilled, memory_order_relaxed);
+            replayed += atomic_load_explicit(&spill->replayed, memory_order_relaxed);
+            dead_lettered += atomic_load_explicit(&spill->dead_lettered, memory_order_relaxed);
+            disk_bytes += atomic_load_explicit(&spill->disk_bytes, memory_order_relaxed);
+        }
+        append_counter(server, "yurei_spilled_events", "Events written to the on-disk spill.",
+                       spilled);
+        append_counter(server, "yurei_replayed_events", "Spilled events committed to the DB.",
+                       replayed);
+        append_counter(server, "yurei_dead_lettered_events",
+                       "Spilled events the DB kept rejecting, moved to .dead files.", dead_lettered);
+        append_gauge(server, "yurei_spill_disk_bytes", "Bytes of spill segments on disk.",
+                     disk_bytes);
+    }
+    if (server->parsers) {
+        append_counter(server, "yurei_parser_dropped_messages",
+                       "WebSocket messages dropped because the parser buffer was full.",
+                       atomic_load_explicit(&server->parsers->dropped, memory_order_relaxed));
+    }
+
+    if (server->ws) {
+        append_ws_endpoints(server, snapshot);
+    }
+
+    append_stage_histograms(server, snapshot);
+    body_append(server, "# EOF\n");
+}
+
+static bool send_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+static void send_response(int fd, const char *status, const char *content_type,
+                          const char *body, size_t body_len) {
+    char header[256];
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+                              "Connection: close\r\n\r\n",
+                              status, content_type, body_len);
+    if (send_all(fd, header, (size_t)header_len) && body_len > 0) {
+        send_all(fd, body, body_len);
+    }
+}
+
+static void handle_connection(YureiMetricsServer *server, int fd, YureiHistogramSnapshot *snapshot) {
+    struct timeval timeout = {SERVER_IO_TIMEOUT_S, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // Only the request line matters; read until the end of the headers
+    char request[SERVER_REQUEST_MAX];
+    size_t len = 0;
+    while (len < sizeof(request) - 1) {
+        ssize_t n = recv(fd, request + len, sizeof(request) - 1 - len, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        len += (size_t)n;
+        request[len] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) {
+            break;
+        }
+    }
+    request[len] = '\0';
+
+    bool is_get = strncmp(request, "GET ", 4) == 0;
+    bool is_head = strncmp(request, "HEAD ", 5) == 0;
+    if (!is_get && !is_head) {
+        static const char msg[] = "method not allowed\n";
+        send_response(fd, "405 Method Not Allowed", "text/plain", msg, sizeof(msg) - 1);
+        return;
+    }
+    const char *path = request + (is_get ? 4 : 5);
+    size_t path_len = strcspn(path, " ?\r\n");
+    if (!((path_len == 8 && strncmp(path, "/metrics", 8) == 0) ||
+          (path_len == 1 && path[0] == '/'))) {
+        static const char msg[] = "not found\n";
+        send_response(fd, "404 Not Found", "text/plain", msg, sizeof(msg) - 1);
+        return;
+    }
+    render_metrics(server, snapshot);
+    send_response(fd, "200 OK", OPENMETRICS_CONTENT_TYPE,
+                  server->body, is_head ? 0 : server->body_len);
+}
+
+static void *server_thread(void *arg) {
+    YureiMetricsServer *server = (YureiMetricsServer *)arg;
+    YureiHistogramSnapshot *snapshot = malloc(sizeof(*snapshot));
+    if (!snapshot || !body_reserve(server, SERVER_BODY_MIN_CAPACITY)) {
+        YUREI_LOG_ERROR("Unable to allocate metrics endpoint buffers");
+        free(snapshot);
+        return NULL;
+    }
+    struct pollfd pfd = {.fd = server->listen_fd, .events = POLLIN};
+    while (!atomic_load_explicit(&server->stop, memory_order_acquire)) {
+        int ready = poll(&pfd, 1, SERVER_POLL_MS);
+        if (ready <= 0) {
+            continue;
+        }
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        handle_connection(server, fd, snapshot);
+        close(fd);
+    }
+    free(snapshot);
+    return NULL;
+}
+
+int yurei_metrics_server_start(YureiMetricsServer *server,
+                               const YureiConfig *config,
+                               const YureiPipeline *pipeline,
+                               YureiParserPool *parsers,
+                               const YureiWebsocketClient *ws) {
+    if (!server || !config || !pipeline || !pipeline->metrics || !pipeline->queue) {
+        return -1;
+    }
+    memset(server, 0, sizeof(*server));
+    server->listen_fd = -1;
+    if (config->metrics_port == 0) {
+        return 0;
+    }
+    server->config = config;
+    server->pipeline = pipeline;
+    server->metrics = pipeline->metrics;
+    server->parsers = parsers;
+    server->ws = ws;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)config->metrics_port);
+    if (inet_pton(AF_INET, config->metrics_bind, &addr.sin_addr) != 1) {
+        YUREI_LOG_ERROR("Invalid metrics bind address: %s", config->metrics_bind);
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        YUREI_LOG_ERROR("Unable to listen on %s:%u for metrics: %s",
+                        config->metrics_bind, config->metrics_port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    server->listen_fd = fd;
+    atomic_init(&server->stop, false);
+    if (pthread_create(&server->thread, NULL, server_thread, server) != 0) {
+        close(fd);
+        server->listen_fd = -1;
+        return -1;
+    }
+    server->running = true;
+    YUREI_LOG_INFO("Metrics endpoint listening on http://%s:%u/metrics",
+                   config->metrics_bind, config->metrics_port);
+    return 0;
+}
+
+void yurei_metrics_server_stop(YureiMetricsServer *server) {
+    if (!server || !server->running) {
+        return;
+    }
+    atomic_store_explicit(&server->stop, true, memory_order_release);
+    pthread_join(server->thread, NULL);
+    close(server->listen_fd);
+    server->listen_fd = -1;
+    free(server->body);
+    server->body = NULL;
+    server->body_cap = 0;
+    server->running = false;
+}
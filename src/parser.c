@@ -8,7 +8,6 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
-#include <strings.h>
 
 #ifdef __has_include
 #if __has_include(<cjson/cJSON.h>)
@@ -20,120 +19,216 @@
 #include <cjson/cJSON.h>
 #endif
 
+#include "base64.h"
+#include "json_scan.h"
 #include "logging.h"
+#include "program_registry.h"
+
+#define PROGRAM_DATA_MARKER "Program data:"
+#define PROGRAM_DATA_MARKER_LEN (sizeof(PROGRAM_DATA_MARKER) - 1)
+#define PROGRAM_PREFIX "Program "
+#define PROGRAM_PREFIX_LEN (sizeof(PROGRAM_PREFIX) - 1)
+#define INVOKE_SUFFIX " invoke ["
+#define INVOKE_SUFFIX_LEN (sizeof(INVOKE_SUFFIX) - 1)
+// Deeper than the runtime's CPI limit; frames past it are counted, not kept
+#define INVOKE_DEPTH_MAX 16
+
+// Transactions one fast-path scan can hold; larger messages fall back to cJSON
+#define FAST_MAX_ENTRIES 256
 
 typedef struct {
     const YureiConfig *config;
-    YureiEventQueue *queue;
+    const YureiPipeline *pipeline;
     uint64_t highest_slot;
+    uint64_t received_ns;  // arrival of the message, stamped on its events
+    uint64_t started_ns;   // parse start, when stage latencies are tracked
 } ParserContext;
 
-static YureiEventKind program_to_kind(const char *program_id, const YureiConfig *config) {
-    if (!program_id || !config) {
-        return YUREI_EVENT_KIND_UNKNOWN;
-    }
-    if (config->pumpfun_program[0] &&
-        strcasecmp(program_id, config->pumpfun_program) == 0) {
-        return YUREI_EVENT_KIND_PUMPFUN;
+typedef struct {
+    const char *ptr;
+    size_t len;
+} StrSlice;
+
+static StrSlice slice_of(const char *str) {
+    StrSlice slice = {str, str ? strlen(str) : 0};
+    return slice;
+}
+
+static bool slice_starts_with(StrSlice slice, const char *prefix, size_t prefix_len) {
+    return slice.len >= prefix_len && memcmp(slice.ptr, prefix, prefix_len) == 0;
+}
+
+static void copy_slice(char *dst, size_t dst_len, StrSlice slice) {
+    size_t len = slice.len < dst_len - 1 ? slice.len : dst_len - 1;
+    if (len > 0) {
+        memcpy(dst, slice.ptr, len);
     }
-    if (config->raydium_program[0] &&
-        strcasecmp(program_id, config->raydium_program) == 0) {
-        return YUREI_EVENT_KIND_RAYDIUM;
+    dst[len] = '\0';
+}
+
+static const char *find_marker(const char *line, size_t len) {
+    const char *end = line + len;
+    const char *p = line;
+    while ((size_t)(end - p) >= PROGRAM_DATA_MARKER_LEN) {
+        p = memchr(p, 'P', (size_t)(end - p) - PROGRAM_DATA_MARKER_LEN + 1);
+        if (!p) {
+            return NULL;
+        }
+        if (memcmp(p, PROGRAM_DATA_MARKER, PROGRAM_DATA_MARKER_LEN) == 0) {
+            return p;
+        }
+        p++;
     }
-    return YUREI_EVENT_KIND_UNKNOWN;
+    return NULL;
 }
 
-static int8_t base64_table[256];
-static bool base64_table_initialized = false;
+// One transaction's log as it is walked line by line. The invoke stack
+// attributes each "Program data:" line to the program that emitted it, so a
+// transaction touching several registered programs routes each event to its
+// own table and CPI noise from unregistered programs is dropped early.
+typedef struct {
+    StrSlice program_id;  // entry-level programId, when the RPC provides one
+    StrSlice signature;
+    uint64_t slot;
+    StrSlice stack[INVOKE_DEPTH_MAX];
+    size_t depth;
+} TxLog;
+
+static void tx_begin(TxLog *tx, StrSlice program_id, StrSlice signature, uint64_t slot) {
+    tx->program_id = program_id;
+    tx->signature = signature;
+    tx->slot = slot;
+    tx->depth = 0;
+}
 
-static void init_base64_table(void) {
-    if (base64_table_initialized) {
+// Track "Program <id> invoke [n]" / "Program <id> success|failed..." lines
+static void track_invoke(TxLog *tx, StrSlice line) {
+    const char *id = line.ptr + PROGRAM_PREFIX_LEN;
+    const char *end = line.ptr + line.len;
+    const char *space = memchr(id, ' ', (size_t)(end - id));
+    if (!space || space == id) {
         return;
     }
-    for (int i = 0; i < 256; ++i) {
-        base64_table[i] = -1;
-    }
-    const char *alphabet =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    for (int i = 0; alphabet[i]; ++i) {
-        base64_table[(unsigned char)alphabet[i]] = (int8_t)i;
+    StrSlice rest = {space, (size_t)(end - space)};
+    if (slice_starts_with(rest, INVOKE_SUFFIX, INVOKE_SUFFIX_LEN)) {
+        if (tx->depth < INVOKE_DEPTH_MAX) {
+            tx->stack[tx->depth].ptr = id;
+            tx->stack[tx->depth].len = (size_t)(space - id);
+        }
+        tx->depth++;
+    } else if ((slice_starts_with(rest, " success", 8) || slice_starts_with(rest, " failed", 7)) &&
+               tx->depth > 0) {
+        tx->depth--;
     }
-    base64_table[(unsigned char)'='] = 0;
-    base64_table_initialized = true;
 }
 
-static bool decode_base64(const char *input, uint8_t *output, size_t *out_len) {
-    init_base64_table();
-    if (!input || !output || !out_len) {
-        return false;
+// Registered program an event belongs to: the innermost invoked program,
+// else the entry's programId
+static YureiEventKind resolve_kind(const ParserContext *ctx, const TxLog *tx) {
+    const YureiProgramRegistry *registry = &ctx->config->programs;
+    if (tx->depth > INVOKE_DEPTH_MAX) {
+        return YUREI_EVENT_KIND_UNKNOWN;
     }
-
-    size_t out_index = 0;
-    int val = 0;
-    int bits = -8;
-    for (const unsigned char *ptr = (const unsigned char *)input; *ptr; ++ptr) {
-        if (isspace(*ptr)) {
-            continue;
-        }
-        int8_t decoded = base64_table[*ptr];
-        if (decoded == -1) {
-            break;
-        }
-        val = (val << 6) + decoded;
-        bits += 6;
-        if (bits >= 0) {
-            if (out_index >= YUREI_EVENT_PAYLOAD_MAX) {
-                return false;
-            }
-            output[out_index++] = (uint8_t)((val >> bits) & 0xFF);
-            bits -= 8;
-        }
+    if (tx->depth > 0) {
+        const StrSlice *top = &tx->stack[tx->depth - 1];
+        return yurei_program_lookup(registry, top->ptr, top->len);
     }
-    *out_len = out_index;
-    return true;
+    if (tx->program_id.ptr) {
+        return yurei_program_lookup(registry, tx->program_id.ptr, tx->program_id.len);
+    }
+    return YUREI_EVENT_KIND_UNKNOWN;
 }
 
 static void enqueue_event(ParserContext *ctx,
-                          const char *program_id,
-                          const char *signature,
-                          uint64_t slot,
-                          const char *line,
+                          TxLog *tx,
+                          uint32_t log_index,
+                          StrSlice line,
                           int *event_count) {
-    if (!ctx || !line) {
+    if (!ctx || !line.ptr) {
+        return;
+    }
+    if (slice_starts_with(line, PROGRAM_PREFIX, PROGRAM_PREFIX_LEN) &&
+        !slice_starts_with(line, PROGRAM_DATA_MARKER, PROGRAM_DATA_MARKER_LEN)) {
+        track_invoke(tx, line);
         return;
     }
 
-    const char *marker = strstr(line, "Program data:");
+    const char *marker = find_marker(line.ptr, line.len);
     if (!marker) {
         return;
     }
-    marker += strlen("Program data:");
-    while (*marker && isspace((unsigned char)*marker)) {
+    YureiEventKind kind = resolve_kind(ctx, tx);
+    if (kind == YUREI_EVENT_KIND_UNKNOWN) {
+        return;
+    }
+    uint64_t slot = tx->slot;
+    const char *line_end = line.ptr + line.len;
+    marker += PROGRAM_DATA_MARKER_LEN;
+    while (marker < line_end && isspace((unsigned char)*marker)) {
         marker++;
     }
-    if (!*marker) {
+    if (marker == line_end) {
         return;
     }
 
     YureiEvent event;
     memset(&event, 0, sizeof(event));
     event.slot = slot;
-    if (signature) {
-        snprintf(event.signature, sizeof(event.signature), "%s", signature);
+    event.received_ns = ctx->received_ns;
+    if (tx->signature.ptr) {
+        copy_slice(event.signature, sizeof(event.signature), tx->signature);
     }
-    if (program_id) {
-        snprintf(event.program_id, sizeof(event.program_id), "%s", program_id);
+    event.kind = kind;
+    const YureiProgram *program = yurei_program_get(&ctx->config->programs, kind);
+    memcpy(event.program_id, program->program_id, program->program_id_len + 1);
+
+    // Drop lines already enqueued (dual mode, overlapping polls) before they
+    // cost a decode, a queue slot and a DB round-trip
+    uint64_t sig_hash = yurei_signature_hash(event.signature);
+    const YureiPipeline *pipeline = ctx->pipeline;
+    YureiDedupCache *dedup = event.signature[0] ? pipeline->dedup : NULL;
+    if (dedup && yurei_dedup_contains(dedup, sig_hash, log_index)) {
+        return;
     }
-    event.kind = program_to_kind(program_id ? program_id : ctx->config->pumpfun_program,
-                                 ctx->config);
 
-    if (!decode_base64(marker, event.data, &event.data_len)) {
-        YUREI_LOG_WARN("Failed to decode base64 payload (signature=%s)",
-                       event.signature);
+    // Decode straight into a right-sized slab block of the signature's shard;
+    // the pointer is moved through that ring and its writer releases it after
+    // commit. The slack keeps the vector decoder on its fast path through the
+    // final block.
+    size_t shard_idx = yurei_shard_for_hash(sig_hash, pipeline->queue->count);
+    YureiEventQueue *shard = &pipeline->queue->shards[shard_idx];
+    size_t encoded_len = (size_t)(line_end - marker);
+    size_t decoded_max = yurei_base64_decoded_max(encoded_len) + YUREI_BASE64_SIMD_SLACK;
+    if (decoded_max > YUREI_EVENT_PAYLOAD_MAX) {
+        decoded_max = YUREI_EVENT_PAYLOAD_MAX;
+    }
+    if (yurei_event_payload_alloc(shard, &event, decoded_max) != 0) {
+        YUREI_LOG_WARN_LIMITED("Payload allocation failed (signature=%s)", event.signature);
+        return;
+    }
+    if (!yurei_base64_decode(marker, encoded_len, event.data, event.data_cap, &event.data_len)) {
+        YUREI_LOG_WARN_LIMITED("Failed to decode base64 payload (signature=%s)",
+                               event.signature);
+        yurei_event_release(shard, &event);
         return;
     }
 
-    if (yurei_queue_push(ctx->queue, &event) == 0) {
+    YureiMetrics *metrics = pipeline->metrics;
+    if (metrics) {
+        event.parsed_ns = yurei_now_ns();
+        event.enqueued_ns = event.parsed_ns;  // refreshed by the push when published
+    }
+    if (yurei_pipeline_push(pipeline, shard_idx, &event) == 0) {
+        // Only an event that made it into the queue makes later copies duplicates
+        if (dedup) {
+            yurei_dedup_insert(dedup, sig_hash, log_index);
+        }
+        if (metrics) {
+            uint64_t enqueued_ns = yurei_now_ns();
+            yurei_metrics_record(metrics, YUREI_STAGE_PARSE, event.parsed_ns - ctx->started_ns);
+            yurei_metrics_record(metrics, YUREI_STAGE_PARSE_TO_ENQUEUE, enqueued_ns - event.parsed_ns);
+            yurei_metrics_program_event(metrics, kind);
+        }
         if (event_count) {
             (*event_count)++;
         }
@@ -141,25 +236,280 @@ static void enqueue_event(ParserContext *ctx,
             ctx->highest_slot = slot;
         }
     } else {
-        YUREI_LOG_WARN("Queue backpressure prevented enqueue of slot=%" PRIu64, slot);
+        yurei_event_release(shard, &event);
+        YUREI_LOG_WARN_LIMITED("Queue backpressure prevented enqueue of slot=%" PRIu64, slot);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Fast path: single in-place scan of the known logsNotification / getLogs
+// shapes. Phase one validates the message and records slices without side
+// effects, so any surprise can still fall back to cJSON; phase two enqueues.
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    YureiJsonSlice signature;
+    YureiJsonSlice program_id;
+    uint64_t slot;
+    bool has_slot;
+    const char *logs;  // start of the logs array, NULL if absent
+} FastEntry;
+
+typedef struct {
+    FastEntry entries[FAST_MAX_ENTRIES];
+    size_t count;
+    const char *end;
+} FastPlan;
+
+// Logs must be strings; a "Program data:" line with escapes needs decoding,
+// which is left to cJSON.
+static bool scan_logs(YureiJsonScanner *sc) {
+    if (!yurei_json_array_begin(sc)) {
+        return false;
+    }
+    int rc;
+    while ((rc = yurei_json_array_next(sc)) > 0) {
+        if (yurei_json_peek(sc) != YUREI_JSON_STRING) {
+            if (!yurei_json_skip_value(sc)) {
+                return false;
+            }
+            continue;
+        }
+        YureiJsonSlice line;
+        if (!yurei_json_string(sc, &line)) {
+            return false;
+        }
+        if (line.escaped && find_marker(line.ptr, line.len)) {
+            return false;
+        }
+    }
+    return rc == 0;
+}
+
+static bool scan_optional_string(YureiJsonScanner *sc, YureiJsonSlice *out) {
+    if (yurei_json_peek(sc) != YUREI_JSON_STRING) {
+        return yurei_json_skip_value(sc);
+    }
+    return yurei_json_string(sc, out) && !out->escaped;
+}
+
+static bool scan_value_object(YureiJsonScanner *sc, FastPlan *plan) {
+    if (yurei_json_peek(sc) != YUREI_JSON_OBJECT) {
+        return yurei_json_skip_value(sc);
+    }
+    if (plan->count >= FAST_MAX_ENTRIES) {
+        return false;
+    }
+    FastEntry *entry = &plan->entries[plan->count];
+    memset(entry, 0, sizeof(*entry));
+
+    if (!yurei_json_object_begin(sc)) {
+        return false;
+    }
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(sc, &key)) > 0) {
+        YureiJsonType type = yurei_json_peek(sc);
+        if (yurei_json_slice_equals(&key, "logs") && type == YUREI_JSON_ARRAY) {
+            entry->logs = sc->cur;
+            ok = scan_logs(sc);
+        } else if (yurei_json_slice_equals(&key, "signature")) {
+            ok = scan_optional_string(sc, &entry->signature);
+        } else if (yurei_json_slice_equals(&key, "programId")) {
+            ok = scan_optional_string(sc, &entry->program_id);
+        } else if (yurei_json_slice_equals(&key, "slot") && type == YUREI_JSON_NUMBER) {
+            ok = yurei_json_uint64(sc, &entry->slot);
+            entry->has_slot = ok;
+        } else {
+            ok = yurei_json_skip_value(sc);
+        }
+    }
+    if (!ok || rc != 0) {
+        return false;
+    }
+    plan->count++;
+    return true;
+}
+
+static bool scan_value_array(YureiJsonScanner *sc, FastPlan *plan) {
+    if (!yurei_json_array_begin(sc)) {
+        return false;
+    }
+    int rc;
+    while ((rc = yurei_json_array_next(sc)) > 0) {
+        if (!scan_value_object(sc, plan)) {
+            return false;
+        }
     }
+    return rc == 0;
 }
 
+static void apply_fallback_slot(FastPlan *plan, size_t first, uint64_t slot) {
+    for (size_t i = first; i < plan->count; ++i) {
+        if (!plan->entries[i].has_slot) {
+            plan->entries[i].slot = slot;
+            plan->entries[i].has_slot = true;
+        }
+    }
+}
+
+static bool scan_context_slot(YureiJsonScanner *sc, uint64_t *slot) {
+    if (!yurei_json_object_begin(sc)) {
+        return false;
+    }
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(sc, &key)) > 0) {
+        if (yurei_json_slice_equals(&key, "slot") &&
+            yurei_json_peek(sc) == YUREI_JSON_NUMBER) {
+            ok = yurei_json_uint64(sc, slot);
+        } else {
+            ok = yurei_json_skip_value(sc);
+        }
+    }
+    return ok && rc == 0;
+}
+
+// {"context":{"slot":N},"value":{...} | [...]}
+static bool scan_result_object(YureiJsonScanner *sc, FastPlan *plan) {
+    if (!yurei_json_object_begin(sc)) {
+        return false;
+    }
+    size_t first = plan->count;
+    uint64_t context_slot = 0;
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(sc, &key)) > 0) {
+        YureiJsonType type = yurei_json_peek(sc);
+        if (yurei_json_slice_equals(&key, "value") && type == YUREI_JSON_OBJECT) {
+            ok = scan_value_object(sc, plan);
+        } else if (yurei_json_slice_equals(&key, "value") && type == YUREI_JSON_ARRAY) {
+            ok = scan_value_array(sc, plan);
+        } else if (yurei_json_slice_equals(&key, "context") && type == YUREI_JSON_OBJECT) {
+            ok = scan_context_slot(sc, &context_slot);
+        } else {
+            ok = yurei_json_skip_value(sc);
+        }
+    }
+    if (!ok || rc != 0) {
+        return false;
+    }
+    apply_fallback_slot(plan, first, context_slot);
+    return true;
+}
+
+static bool scan_params_object(YureiJsonScanner *sc, FastPlan *plan) {
+    if (!yurei_json_object_begin(sc)) {
+        return false;
+    }
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(sc, &key)) > 0) {
+        if (yurei_json_slice_equals(&key, "result") &&
+            yurei_json_peek(sc) == YUREI_JSON_OBJECT) {
+            ok = scan_result_object(sc, plan);
+        } else {
+            ok = yurei_json_skip_value(sc);
+        }
+    }
+    return ok && rc == 0;
+}
+
+// Returns false if the message is not one of the known shapes
+static bool fast_scan(const char *json, size_t len, FastPlan *plan) {
+    YureiJsonScanner sc;
+    yurei_json_init(&sc, json, len);
+    plan->count = 0;
+    plan->end = json + len;
+
+    if (!yurei_json_object_begin(&sc)) {
+        return false;
+    }
+    bool seen_result = false;
+    YureiJsonSlice key;
+    int rc;
+    bool ok = true;
+    while (ok && (rc = yurei_json_object_next(&sc, &key)) > 0) {
+        YureiJsonType type = yurei_json_peek(&sc);
+        if (yurei_json_slice_equals(&key, "result")) {
+            // A top-level result always wins over params
+            plan->count = 0;
+            seen_result = true;
+            if (type == YUREI_JSON_OBJECT) {
+                ok = scan_result_object(&sc, plan);
+            } else if (type == YUREI_JSON_ARRAY) {
+                ok = scan_value_array(&sc, plan);
+                apply_fallback_slot(plan, 0, 0);
+            } else {
+                ok = yurei_json_skip_value(&sc);
+            }
+        } else if (yurei_json_slice_equals(&key, "params") && !seen_result &&
+                   type == YUREI_JSON_OBJECT) {
+            ok = scan_params_object(&sc, plan);
+        } else {
+            ok = yurei_json_skip_value(&sc);
+        }
+    }
+    return ok && rc == 0 && yurei_json_at_end(&sc);
+}
+
+static StrSlice str_from_json(const YureiJsonSlice *slice) {
+    StrSlice out = {slice->ptr, slice->len};
+    return out;
+}
+
+static void fast_enqueue(const FastPlan *plan, ParserContext *ctx, int *event_count) {
+    for (size_t i = 0; i < plan->count; ++i) {
+        const FastEntry *entry = &plan->entries[i];
+        if (!entry->logs) {
+            continue;
+        }
+        TxLog tx;
+        tx_begin(&tx, str_from_json(&entry->program_id), str_from_json(&entry->signature),
+                 entry->slot);
+
+        // Already validated by scan_logs
+        YureiJsonScanner sc;
+        yurei_json_init(&sc, entry->logs, (size_t)(plan->end - entry->logs));
+        yurei_json_array_begin(&sc);
+        for (uint32_t index = 0; yurei_json_array_next(&sc) > 0; ++index) {
+            YureiJsonSlice line;
+            if (yurei_json_peek(&sc) != YUREI_JSON_STRING) {
+                yurei_json_skip_value(&sc);
+                continue;
+            }
+            yurei_json_string(&sc, &line);
+            enqueue_event(ctx, &tx, index, str_from_json(&line), event_count);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// cJSON fallback for unexpected shapes
+// ---------------------------------------------------------------------------
+
 static void process_logs_array(cJSON *logs,
-                               const char *program_id,
-                               const char *signature,
+                               StrSlice program_id,
+                               StrSlice signature,
                                uint64_t slot,
                                ParserContext *ctx,
                                int *event_count) {
     if (!cJSON_IsArray(logs)) {
         return;
     }
+    TxLog tx;
+    tx_begin(&tx, program_id, signature, slot);
     cJSON *log = NULL;
+    uint32_t index = 0;
     cJSON_ArrayForEach(log, logs) {
-        if (!cJSON_IsString(log) || !log->valuestring) {
-            continue;
+        if (cJSON_IsString(log) && log->valuestring) {
+            enqueue_event(ctx, &tx, index, slice_of(log->valuestring), event_count);
         }
-        enqueue_event(ctx, program_id, signature, slot, log->valuestring, event_count);
+        index++;
     }
 }
 
@@ -181,8 +531,8 @@ static void process_value_object(cJSON *value,
         slot = (uint64_t)slot_item->valuedouble;
     }
 
-    const char *sig_str = cJSON_IsString(signature) ? signature->valuestring : NULL;
-    const char *program_id = cJSON_IsString(program) ? program->valuestring : NULL;
+    StrSlice sig_str = slice_of(cJSON_IsString(signature) ? signature->valuestring : NULL);
+    StrSlice program_id = slice_of(cJSON_IsString(program) ? program->valuestring : NULL);
 
     process_logs_array(logs, program_id, sig_str, slot, ctx, event_count);
 }
@@ -212,24 +562,10 @@ static void process_result_object(cJSON *result, ParserContext *ctx, int *event_
     }
 }
 
-int yurei_parser_handle_message(const char *json,
-                                const YureiConfig *config,
-                                YureiEventQueue *queue,
-                                uint64_t *out_highest_slot) {
-    if (!json || !config || !queue) {
-        return -1;
-    }
-
-    ParserContext ctx = {
-        .config = config,
-        .queue = queue,
-        .highest_slot = out_highest_slot && *out_highest_slot ? *out_highest_slot : 0
-    };
-
-    int event_count = 0;
-    cJSON *root = cJSON_Parse(json);
+static int cjson_handle(const char *json, size_t len, ParserContext *ctx, int *event_count) {
+    cJSON *root = cJSON_ParseWithLength(json, len);
     if (!root) {
-        YUREI_LOG_WARN("Failed to parse JSON payload");
+        YUREI_LOG_WARN_LIMITED("Failed to parse JSON payload");
         return -1;
     }
 
@@ -237,23 +573,71 @@ int yurei_parser_handle_message(const char *json,
     cJSON *params = cJSON_GetObjectItemCaseSensitive(root, "params");
 
     if (cJSON_IsObject(result)) {
-        process_result_object(result, &ctx, &event_count);
+        process_result_object(result, ctx, event_count);
     } else if (cJSON_IsArray(result)) {
         cJSON *entry = NULL;
         cJSON_ArrayForEach(entry, result) {
-            process_value_object(entry, &ctx, &event_count, 0);
+            process_value_object(entry, ctx, event_count, 0);
         }
     } else if (cJSON_IsObject(params)) {
         cJSON *params_result = cJSON_GetObjectItemCaseSensitive(params, "result");
         if (cJSON_IsObject(params_result)) {
-            process_result_object(params_result, &ctx, &event_count);
+            process_result_object(params_result, ctx, event_count);
         }
     }
 
+    cJSON_Delete(root);
+    return 0;
+}
+
+int yurei_parser_handle_message(const char *json,
+                                const YureiConfig *config,
+                                const YureiPipeline *pipeline,
+                                uint64_t *out_highest_slot) {
+    if (!json) {
+        return -1;
+    }
+    return yurei_parser_handle_buffer(json, strlen(json), config, pipeline, out_highest_slot);
+}
+
+int yurei_parser_handle_buffer(const char *json,
+                               size_t len,
+                               const YureiConfig *config,
+                               const YureiPipeline *pipeline,
+                               uint64_t *out_highest_slot) {
+    return yurei_parser_handle_received(json, len, 0, config, pipeline, out_highest_slot);
+}
+
+int yurei_parser_handle_received(const char *json,
+                                 size_t len,
+                                 uint64_t received_ns,
+                                 const YureiConfig *config,
+                                 const YureiPipeline *pipeline,
+                                 uint64_t *out_highest_slot) {
+    if (!json || !config || !pipeline || !pipeline->queue) {
+        return -1;
+    }
+
+    uint64_t started_ns = yurei_now_ns();
+    ParserContext ctx = {
+        .config = config,
+        .pipeline = pipeline,
+        .highest_slot = out_highest_slot && *out_highest_slot ? *out_highest_slot : 0,
+        .received_ns = received_ns ? received_ns : started_ns,
+        .started_ns = started_ns
+    };
+
+    int event_count = 0;
+    // ~10 KB of slices; thread-local so concurrent parsers never share it
+    static _Thread_local FastPlan plan;
+    if (fast_scan(json, len, &plan)) {
+        fast_enqueue(&plan, &ctx, &event_count);
+    } else if (cjson_handle(json, len, &ctx, &event_count) != 0) {
+        return -1;
+    }
+
     if (out_highest_slot) {
         *out_highest_slot = ctx.highest_slot;
     }
-
-    cJSON_Delete(root);
     return event_count;
 }
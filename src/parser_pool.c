@@ -0,0 +1,102 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "parser_pool.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "capture.h"
+#include "logging.h"
+#include "parser.h"
+
+static void *parser_thread(void *arg) {
+    YureiParserPool *pool = (YureiParserPool *)arg;
+    YureiMessage *message;
+    while ((message = yurei_message_ring_take(&pool->ring)) != NULL) {
+        if (pool->pipeline->metrics && message->received_ns) {
+            yurei_metrics_record(pool->pipeline->metrics, YUREI_STAGE_RECEIVE_TO_PARSE,
+                                 yurei_now_ns() - message->received_ns);
+        }
+        yurei_parser_handle_received(message->data,
+                                     message->len,
+                                     message->received_ns,
+                                     pool->config,
+                                     pool->pipeline,
+                                     NULL);
+        yurei_message_ring_done(&pool->ring, message);
+    }
+    return NULL;
+}
+
+int yurei_parser_pool_start(YureiParserPool *pool,
+                            const YureiConfig *config,
+                            const YureiPipeline *pipeline) {
+    if (!pool || !config || !pipeline || !pipeline->queue) {
+        return -1;
+    }
+    memset(pool, 0, sizeof(*pool));
+    pool->config = config;
+    pool->pipeline = pipeline;
+    if (yurei_message_ring_init(&pool->ring, config->parser_buffer_bytes) != 0) {
+        YUREI_LOG_ERROR("Unable to allocate %zu byte parser buffer", config->parser_buffer_bytes);
+        return -1;
+    }
+
+    size_t threads = config->parser_threads ? config->parser_threads : 1;
+    pool->threads = calloc(threads, sizeof(pthread_t));
+    if (!pool->threads) {
+        yurei_message_ring_destroy(&pool->ring);
+        return -1;
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        if (pthread_create(&pool->threads[i], NULL, parser_thread, pool) != 0) {
+            YUREI_LOG_ERROR("Unable to start parser thread %zu", i);
+            yurei_parser_pool_stop(pool);
+            return -1;
+        }
+        pool->thread_count = i + 1;
+    }
+    YUREI_LOG_INFO("Parser pool started (threads=%zu, buffer=%zu KiB)",
+                   pool->thread_count, pool->ring.capacity / 1024);
+    return 0;
+}
+
+int yurei_parser_pool_submit(YureiParserPool *pool, const char *data, size_t len, uint64_t received_ns) {
+    if (!pool || !data) {
+        return -1;
+    }
+    if (pool->pipeline->capture) {
+        yurei_capture_record(pool->pipeline->capture, YUREI_CAPTURE_WS, data, len);
+    }
+    if (!pool->config->parser_drop_when_full) {
+        // Backpressure: the network thread waits for a parser to free room
+        return yurei_message_ring_put_wait(&pool->ring, data, len, received_ns);
+    }
+    if (yurei_message_ring_put(&pool->ring, data, len, received_ns) != 0) {
+        uint64_t dropped = atomic_fetch_add_explicit(&pool->dropped, 1, memory_order_relaxed) + 1;
+        if (!pool->dropping) {
+            YUREI_LOG_WARN("Parser buffer full; dropping messages (%" PRIu64 " dropped so far)",
+                           dropped);
+            pool->dropping = true;
+        }
+        return -1;
+    }
+    pool->dropping = false;
+    return 0;
+}
+
+void yurei_parser_pool_stop(YureiParserPool *pool) {
+    if (!pool || !pool->ring.buffer) {
+        return;
+    }
+    yurei_message_ring_close(&pool->ring);
+    for (size_t i = 0; i < pool->thread_count; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pool->threads = NULL;
+    pool->thread_count = 0;
+    yurei_message_ring_destroy(&pool->ring);
+}
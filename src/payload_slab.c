@@ -0,0 +1,137 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "payload_slab.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Blocks carved from each chunk; chunks are only returned on destroy
+#define SLAB_BLOCKS_PER_CHUNK 64
+
+struct YureiSlabBlock {
+    YureiSlabBlock *next;
+};
+
+struct YureiSlabChunk {
+    YureiSlabChunk *next;
+    // Keep blocks 16-byte aligned after the header
+    uint8_t pad[16 - sizeof(YureiSlabChunk *)];
+};
+
+static int class_for_size(size_t len) {
+    size_t block = (size_t)1 << YUREI_SLAB_MIN_SHIFT;
+    for (int i = 0; i < YUREI_SLAB_CLASSES; ++i, block <<= 1) {
+        if (len <= block) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int yurei_slab_init(YureiPayloadSlab *slab) {
+    if (!slab) {
+        return -1;
+    }
+    memset(slab, 0, sizeof(*slab));
+    for (int i = 0; i < YUREI_SLAB_CLASSES; ++i) {
+        slab->classes[i].block_size = (size_t)1 << (YUREI_SLAB_MIN_SHIFT + i);
+        pthread_mutex_init(&slab->classes[i].mutex, NULL);
+    }
+    return 0;
+}
+
+void yurei_slab_destroy(YureiPayloadSlab *slab) {
+    if (!slab) {
+        return;
+    }
+    for (int i = 0; i < YUREI_SLAB_CLASSES; ++i) {
+        YureiSlabClass *cls = &slab->classes[i];
+        YureiSlabChunk *chunk = cls->chunks;
+        while (chunk) {
+            YureiSlabChunk *next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+        cls->chunks = NULL;
+        cls->free_list = NULL;
+        cls->blocks_total = 0;
+        pthread_mutex_destroy(&cls->mutex);
+    }
+}
+
+// Caller holds cls->mutex
+static int grow_class(YureiSlabClass *cls) {
+    YureiSlabChunk *chunk =
+        malloc(sizeof(YureiSlabChunk) + cls->block_size * SLAB_BLOCKS_PER_CHUNK);
+    if (!chunk) {
+        return -1;
+    }
+    chunk->next = cls->chunks;
+    cls->chunks = chunk;
+
+    uint8_t *base = (uint8_t *)(chunk + 1);
+    for (size_t i = SLAB_BLOCKS_PER_CHUNK; i > 0; --i) {
+        YureiSlabBlock *block = (YureiSlabBlock *)(base + (i - 1) * cls->block_size);
+        block->next = cls->free_list;
+        cls->free_list = block;
+    }
+    cls->blocks_total += SLAB_BLOCKS_PER_CHUNK;
+    return 0;
+}
+
+uint8_t *yurei_slab_alloc(YureiPayloadSlab *slab, size_t len, size_t *out_cap) {
+    if (!slab) {
+        return NULL;
+    }
+    int index = class_for_size(len);
+    if (index < 0) {
+        return NULL;
+    }
+    YureiSlabClass *cls = &slab->classes[index];
+
+    pthread_mutex_lock(&cls->mutex);
+    if (!cls->free_list && grow_class(cls) != 0) {
+        pthread_mutex_unlock(&cls->mutex);
+        return NULL;
+    }
+    YureiSlabBlock *block = cls->free_list;
+    cls->free_list = block->next;
+    pthread_mutex_unlock(&cls->mutex);
+
+    if (out_cap) {
+        *out_cap = cls->block_size;
+    }
+    return (uint8_t *)block;
+}
+
+void yurei_slab_free(YureiPayloadSlab *slab, uint8_t *block, size_t cap) {
+    if (!slab || !block) {
+        return;
+    }
+    int index = class_for_size(cap);
+    if (index < 0) {
+        return;
+    }
+    YureiSlabClass *cls = &slab->classes[index];
+    YureiSlabBlock *node = (YureiSlabBlock *)block;
+
+    pthread_mutex_lock(&cls->mutex);
+    node->next = cls->free_list;
+    cls->free_list = node;
+    pthread_mutex_unlock(&cls->mutex);
+}
+
+size_t yurei_slab_reserved_bytes(YureiPayloadSlab *slab) {
+    if (!slab) {
+        return 0;
+    }
+    size_t total = 0;
+    for (int i = 0; i < YUREI_SLAB_CLASSES; ++i) {
+        YureiSlabClass *cls = &slab->classes[i];
+        pthread_mutex_lock(&cls->mutex);
+        total += cls->blocks_total * cls->block_size;
+        pthread_mutex_unlock(&cls->mutex);
+    }
+    return total;
+}
@@ -0,0 +1,23 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "pipeline.h"
+
+int yurei_pipeline_push(const YureiPipeline *pipeline, size_t shard_idx, YureiEvent *event) {
+    if (!pipeline || !pipeline->queue || !pipeline->queue->shards ||
+        shard_idx >= pipeline->queue->count || !event) {
+        return -1;
+    }
+    YureiEventQueue *shard = &pipeline->queue->shards[shard_idx];
+    if (!pipeline->spills) {
+        return yurei_queue_push(shard, event);
+    }
+    if (yurei_queue_try_push(shard, event) == 0) {
+        return 0;
+    }
+    if (yurei_spill_append(&pipeline->spills[shard_idx], event) == 0) {
+        yurei_event_release(shard, event);
+        return 0;
+    }
+    return yurei_queue_push(shard, event);
+}
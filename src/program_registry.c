@@ -0,0 +1,204 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "program_registry.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "logging.h"
+
+// Seeds tried per table size before doubling the table
+#define REGISTRY_SEED_ATTEMPTS 4096
+
+static uint64_t key_prefix(const char *program_id, size_t len) {
+    uint64_t prefix = 0;
+    memcpy(&prefix, program_id, len < sizeof(prefix) ? len : sizeof(prefix));
+    return prefix ^ (uint64_t)len;
+}
+
+static size_t slot_for(const YureiProgramRegistry *registry, const char *program_id, size_t len) {
+    return (size_t)((key_prefix(program_id, len) * registry->multiplier) >> registry->shift);
+}
+
+void yurei_program_registry_init(YureiProgramRegistry *registry) {
+    if (registry) {
+        memset(registry, 0, sizeof(*registry));
+    }
+}
+
+static bool valid_identifier(const char *value) {
+    if (!value || !*value) {
+        return false;
+    }
+    for (const char *p = value; *p; ++p) {
+        if (!isalnum((unsigned char)*p) && *p != '_' && *p != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+int yurei_program_registry_add(YureiProgramRegistry *registry,
+                               const char *name,
+                               const char *program_id,
+                               const char *table) {
+    if (!registry || !valid_identifier(name) || !valid_identifier(program_id)) {
+        return -1;
+    }
+    size_t id_len = strlen(program_id);
+    if (registry->count >= YUREI_PROGRAMS_MAX || id_len >= YUREI_PROGRAM_ID_MAX ||
+        strlen(name) >= YUREI_PROGRAM_NAME_MAX) {
+        return -1;
+    }
+    char table_name[YUREI_TABLE_NAME_MAX];
+    if (table && *table) {
+        // Table names are spliced into SQL, so only plain identifiers pass
+        if (!valid_identifier(table) || strlen(table) >= sizeof(table_name)) {
+            return -1;
+        }
+        snprintf(table_name, sizeof(table_name), "%s", table);
+    } else if (snprintf(table_name, sizeof(table_name), "%s_events", name) >=
+               (int)sizeof(table_name)) {
+        return -1;
+    }
+    for (size_t i = 0; i < registry->count; ++i) {
+        if (strcmp(registry->programs[i].program_id, program_id) == 0) {
+            return -1;
+        }
+    }
+
+    size_t table_index = 0;
+    while (table_index < registry->table_count &&
+           strcmp(registry->tables[table_index], table_name) != 0) {
+        table_index++;
+    }
+    if (table_index == registry->table_count) {
+        snprintf(registry->tables[table_index], YUREI_TABLE_NAME_MAX, "%s", table_name);
+        registry->table_count++;
+    }
+
+    YureiProgram *program = &registry->programs[registry->count++];
+    snprintf(program->name, sizeof(program->name), "%s", name);
+    snprintf(program->program_id, sizeof(program->program_id), "%s", program_id);
+    program->program_id_len = id_len;
+    program->table = (uint16_t)table_index;
+    return 0;
+}
+
+int yurei_program_registry_parse(YureiProgramRegistry *registry, const char *spec) {
+    if (!registry || !spec) {
+        return -1;
+    }
+    const char *p = spec;
+    while (*p) {
+        while (*p && (*p == ',' || isspace((unsigned char)*p))) {
+            p++;
+        }
+        const char *start = p;
+        while (*p && *p != ',' && !isspace((unsigned char)*p)) {
+            p++;
+        }
+        size_t len = (size_t)(p - start);
+        if (len == 0) {
+            continue;
+        }
+        char entry[YUREI_PROGRAM_NAME_MAX + YUREI_PROGRAM_ID_MAX + YUREI_TABLE_NAME_MAX];
+        if (len >= sizeof(entry)) {
+            YUREI_LOG_ERROR("Program entry too long: %.*s", (int)len, start);
+            return -1;
+        }
+        memcpy(entry, start, len);
+        entry[len] = '\0';
+
+        char *name = entry;
+        char *program_id = strchr(name, ':');
+        char *table = NULL;
+        if (program_id) {
+            *program_id++ = '\0';
+            table = strchr(program_id, ':');
+            if (table) {
+                *table++ = '\0';
+            }
+        }
+        if (!program_id || yurei_program_registry_add(registry, name, program_id, table) != 0) {
+            YUREI_LOG_ERROR("Invalid program entry '%.*s' (expected name:program_id[:table])",
+                            (int)len, start);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int yurei_program_registry_build(YureiProgramRegistry *registry) {
+    if (!registry) {
+        return -1;
+    }
+    size_t size = 8;
+    while (size < registry->count * 4) {
+        size <<= 1;
+    }
+    // Deterministic odd multipliers from a splitmix64 sequence
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (; size <= YUREI_PROGRAM_INDEX_MAX; size <<= 1) {
+        unsigned bits = 0;
+        while (((size_t)1 << bits) < size) {
+            bits++;
+        }
+        registry->shift = 64 - bits;
+        for (int attempt = 0; attempt < REGISTRY_SEED_ATTEMPTS; ++attempt) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            registry->multiplier = (z ^ (z >> 31)) | 1u;
+
+            memset(registry->index, 0, sizeof(registry->index));
+            bool collision = false;
+            for (size_t i = 0; i < registry->count && !collision; ++i) {
+                const YureiProgram *program = &registry->programs[i];
+                size_t slot = slot_for(registry, program->program_id, program->program_id_len);
+                if (registry->index[slot]) {
+                    collision = true;
+                } else {
+                    registry->index[slot] = (uint8_t)(i + 1);
+                }
+            }
+            if (!collision) {
+                return 0;
+            }
+        }
+    }
+    YUREI_LOG_ERROR("Unable to build program lookup table for %zu programs", registry->count);
+    return -1;
+}
+
+YureiEventKind yurei_program_lookup(const YureiProgramRegistry *registry,
+                                    const char *program_id,
+                                    size_t len) {
+    if (!registry || !program_id || registry->count == 0) {
+        return YUREI_EVENT_KIND_UNKNOWN;
+    }
+    uint8_t entry = registry->index[slot_for(registry, program_id, len)];
+    if (entry == 0) {
+        return YUREI_EVENT_KIND_UNKNOWN;
+    }
+    const YureiProgram *program = &registry->programs[entry - 1];
+    if (program->program_id_len != len || memcmp(program->program_id, program_id, len) != 0) {
+        return YUREI_EVENT_KIND_UNKNOWN;
+    }
+    return (YureiEventKind)(entry - 1);
+}
+
+const YureiProgram *yurei_program_get(const YureiProgramRegistry *registry, YureiEventKind kind) {
+    if (!registry || kind >= registry->count) {
+        return NULL;
+    }
+    return &registry->programs[kind];
+}
+
+const char *yurei_program_table(const YureiProgramRegistry *registry, YureiEventKind kind) {
+    const YureiProgram *program = yurei_program_get(registry, kind);
+    return program ? registry->tables[program->table] : NULL;
+}
@@ -0,0 +1,87 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "sharded_queue.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+int yurei_sharded_queue_init(YureiShardedQueue *queue, size_t shard_count, size_t total_capacity) {
+    if (!queue || shard_count == 0 || shard_count > YUREI_QUEUE_SHARDS_MAX) {
+        return -1;
+    }
+    memset(queue, 0, sizeof(*queue));
+    // The rings carry cache-line-aligned members, so the array must be
+    // aligned too (calloc only guarantees max_align_t)
+    size_t bytes = shard_count * sizeof(YureiEventQueue);
+    bytes = (bytes + YUREI_CACHE_LINE - 1) & ~((size_t)YUREI_CACHE_LINE - 1);
+    queue->shards = aligned_alloc(YUREI_CACHE_LINE, bytes);
+    if (!queue->shards) {
+        return -1;
+    }
+    memset(queue->shards, 0, bytes);
+    size_t per_shard = (total_capacity + shard_count - 1) / shard_count;
+    for (size_t i = 0; i < shard_count; ++i) {
+        if (yurei_queue_init(&queue->shards[i], per_shard) != 0) {
+            queue->count = i;
+            yurei_sharded_queue_destroy(queue);
+            return -1;
+        }
+    }
+    queue->count = shard_count;
+    return 0;
+}
+
+void yurei_sharded_queue_destroy(YureiShardedQueue *queue) {
+    if (!queue || !queue->shards) {
+        return;
+    }
+    for (size_t i = 0; i < queue->count; ++i) {
+        yurei_queue_destroy(&queue->shards[i]);
+    }
+    free(queue->shards);
+    queue->shards = NULL;
+    queue->count = 0;
+}
+
+uint64_t yurei_signature_hash(const char *signature) {
+    // FNV-1a with a murmur3 finalizer so the high bits are well mixed
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    if (signature) {
+        for (const unsigned char *p = (const unsigned char *)signature; *p; ++p) {
+            hash ^= *p;
+            hash *= 0x100000001b3ULL;
+        }
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+size_t yurei_shard_for_hash(uint64_t hash, size_t shard_count) {
+    if (shard_count <= 1) {
+        return 0;
+    }
+    // Lemire's multiply-shift reduction instead of a modulo
+    return (size_t)(((hash >> 32) * (uint64_t)shard_count) >> 32);
+}
+
+size_t yurei_shard_for_signature(const char *signature, size_t shard_count) {
+    if (shard_count <= 1 || !signature) {
+        return 0;
+    }
+    return yurei_shard_for_hash(yurei_signature_hash(signature), shard_count);
+}
+
+void yurei_sharded_queue_close(YureiShardedQueue *queue) {
+    if (!queue || !queue->shards) {
+        return;
+    }
+    for (size_t i = 0; i < queue->count; ++i) {
+        yurei_queue_close(&queue->shards[i]);
+    }
+}
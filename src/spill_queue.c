@@ -0,0 +1,585 @@
+// Project Yurei - High-performance Solana data engine (MIT License)
+// Copyright (c) 2025 Project Yurei
+// https://x.com/yureiai  PRD: yurei-jsonrpc-client
+#include "spill_queue.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define YUREI_SPILL_X86 1
+#endif
+
+#include "logging.h"
+#include "metrics.h"
+
+// Version 2 records carry the receive time; version 1 segments are still read
+#define SPILL_MAGIC "YUREISP2"
+#define SPILL_MAGIC_V1 "YUREISP1"
+#define SPILL_ALIGN 8u
+
+typedef struct {
+    char magic[8];
+    uint64_t seq;
+    _Atomic uint64_t committed;  // offset of the first record not yet in the database
+    uint8_t reserved[40];
+} SpillSegmentHeader;
+
+typedef struct {
+    uint32_t length;  // body bytes following this header, before padding
+    uint32_t crc;     // CRC32C of the fields below and the body
+    uint64_t slot;
+    uint32_t data_len;
+    uint8_t signature_len;
+    uint8_t program_id_len;
+    uint16_t reserved;
+    int64_t received_unix_ns;  // wall-clock receive time, 0 if unknown (version 2)
+    // body: signature, program ID, payload
+} SpillRecord;
+
+_Static_assert(sizeof(SpillSegmentHeader) == 64, "segment header is one cache line");
+_Static_assert(sizeof(SpillRecord) % SPILL_ALIGN == 0, "records stay aligned");
+
+#define SPILL_DATA_START ((uint64_t)sizeof(SpillSegmentHeader))
+#define SPILL_CRC_OFFSET (offsetof(SpillRecord, crc) + sizeof(uint32_t))
+#define SPILL_RECORD_V1_BYTES offsetof(SpillRecord, received_unix_ns)
+_Static_assert(SPILL_RECORD_V1_BYTES % SPILL_ALIGN == 0, "version 1 records stay aligned");
+
+// ---------------------------------------------------------------------------
+// CRC32C (Castagnoli): SSE4.2 instruction when available, table otherwise
+// ---------------------------------------------------------------------------
+
+static uint32_t g_crc_table[256];
+
+typedef uint32_t (*CrcFn)(uint32_t crc, const uint8_t *data, size_t len);
+
+static uint32_t crc32c_table(uint32_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        crc = g_crc_table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef YUREI_SPILL_X86
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t *data, size_t len) {
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)crc64;
+    while (len-- > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+static CrcFn g_crc = crc32c_table;
+
+__attribute__((constructor))
+static void crc_init(void) {
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+        }
+        g_crc_table[i] = crc;
+    }
+#ifdef YUREI_SPILL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        g_crc = crc32c_sse42;
+    }
+#endif
+}
+
+// header_bytes is the record header size of the segment's version
+static uint32_t record_crc(const SpillRecord *record, size_t header_bytes) {
+    const uint8_t *start = (const uint8_t *)record + SPILL_CRC_OFFSET;
+    size_t len = header_bytes - SPILL_CRC_OFFSET + record->length;
+    return ~g_crc(~0u, start, len);
+}
+
+// ---------------------------------------------------------------------------
+// Segments
+// ---------------------------------------------------------------------------
+
+static uint64_t align_up(uint64_t value) {
+    return (value + SPILL_ALIGN - 1) & ~(uint64_t)(SPILL_ALIGN - 1);
+}
+
+static void segment_path(const YureiSpillQueue *spill, uint64_t seq, char *out, size_t len) {
+    snprintf(out, len, "%s/shard-%zu-%016" PRIu64 ".spill", spill->dir, spill->shard, seq);
+}
+
+// Wall clock minus monotonic clock, to carry receive times across restarts
+static int64_t wall_offset_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    int64_t wall = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    return wall - (int64_t)yurei_now_ns();
+}
+
+static uint8_t *map_segment(int fd, size_t size) {
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return map == MAP_FAILED ? NULL : (uint8_t *)map;
+}
+
+int yurei_spill_init(YureiSpillQueue *spill, const char *dir, size_t shard, uint64_t max_bytes) {
+    if (!spill || !dir || !*dir) {
+        return -1;
+    }
+    memset(spill, 0, sizeof(*spill));
+    if (strlen(dir) >= sizeof(spill->dir)) {
+        return -1;
+    }
+    snprintf(spill->dir, sizeof(spill->dir), "%s", dir);
+    spill->shard = shard;
+    // The active segment is only freed once its successor exists, so any
+    // cap must leave room for two
+    if (max_bytes && max_bytes < 2ULL * YUREI_SPILL_SEGMENT_BYTES) {
+        max_bytes = 2ULL * YUREI_SPILL_SEGMENT_BYTES;
+    }
+    spill->max_bytes = max_bytes;
+    spill->write_fd = -1;
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        YUREI_LOG_ERROR("Unable to create spill directory %s: %s", dir, strerror(errno));
+        return -1;
+    }
+
+    DIR *handle = opendir(dir);
+    if (!handle) {
+        YUREI_LOG_ERROR("Unable to open spill directory %s: %s", dir, strerror(errno));
+        return -1;
+    }
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    uint64_t bytes = 0;
+    size_t segments = 0;
+    struct dirent *entry;
+    while ((entry = readdir(handle)) != NULL) {
+        size_t entry_shard = 0;
+        uint64_t seq = 0;
+        int consumed = 0;
+        if (sscanf(entry->d_name, "shard-%zu-%" SCNu64 ".spill%n", &entry_shard, &seq, &consumed) != 2 ||
+            entry->d_name[consumed] != '\0' || entry_shard != shard) {
+            continue;
+        }
+        char path[512];
+        segment_path(spill, seq, path, sizeof(path));
+        struct stat st;
+        if (stat(path, &st) == 0) {
+            bytes += (uint64_t)st.st_size;
+        }
+        first = seq < first ? seq : first;
+        last = seq > last ? seq : last;
+        segments++;
+    }
+    closedir(handle);
+
+    if (pthread_mutex_init(&spill->lock, NULL) != 0) {
+        return -1;
+    }
+    // Old segments are sealed: new records always go to a fresh one
+    spill->write_seq = segments ? last + 1 : 1;
+    spill->read_seq = segments ? first : spill->write_seq;
+    atomic_init(&spill->write_seq_published, spill->write_seq);
+    atomic_init(&spill->write_off, 0);
+    atomic_init(&spill->disk_bytes, bytes);
+    atomic_init(&spill->spilled, 0);
+    atomic_init(&spill->replayed, 0);
+    atomic_init(&spill->dead_lettered, 0);
+    if (segments) {
+        YUREI_LOG_INFO("Spill shard %zu: %zu segment(s) (%" PRIu64 " MiB) from a previous run to replay",
+                       shard, segments, bytes >> 20);
+    }
+    return 0;
+}
+
+static void unmap_read(YureiSpillQueue *spill) {
+    if (spill->read_map) {
+        munmap(spill->read_map, spill->read_size);
+        spill->read_map = NULL;
+    }
+    spill->read_size = 0;
+    spill->read_off = 0;
+    spill->committed_off = 0;
+}
+
+void yurei_spill_destroy(YureiSpillQueue *spill) {
+    if (!spill || !spill->dir[0]) {
+        return;
+    }
+    // Segments stay on disk; the next run replays whatever is uncommitted
+    if (spill->write_map) {
+        munmap(spill->write_map, YUREI_SPILL_SEGMENT_BYTES);
+        spill->write_map = NULL;
+    }
+    if (spill->write_fd >= 0) {
+        close(spill->write_fd);
+        spill->write_fd = -1;
+    }
+    unmap_read(spill);
+    pthread_mutex_destroy(&spill->lock);
+    spill->dir[0] = '\0';
+}
+
+// Seal the current segment (if any) and start the next one. Called under lock.
+static bool open_write_segment(YureiSpillQueue *spill) {
+    if (spill->write_map) {
+        munmap(spill->write_map, YUREI_SPILL_SEGMENT_BYTES);
+        close(spill->write_fd);
+        spill->write_map = NULL;
+        spill->write_fd = -1;
+        spill->write_seq++;
+    }
+    uint64_t disk = atomic_load_explicit(&spill->disk_bytes, memory_order_relaxed);
+    if (spill->max_bytes && disk + YUREI_SPILL_SEGMENT_BYTES > spill->max_bytes) {
+        if (!spill->full_logged) {
+            YUREI_LOG_WARN("Spill shard %zu reached its %" PRIu64 " MiB cap; producers will block",
+                           spill->shard, spill->max_bytes >> 20);
+            spill->full_logged = true;
+        }
+        return false;
+    }
+    char path[512];
+    segment_path(spill, spill->write_seq, path, sizeof(path));
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || ftruncate(fd, YUREI_SPILL_SEGMENT_BYTES) != 0) {
+        YUREI_LOG_ERROR("Unable to create spill segment %s: %s", path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+            unlink(path);
+        }
+        return false;
+    }
+    uint8_t *map = map_segment(fd, YUREI_SPILL_SEGMENT_BYTES);
+    if (!map) {
+        YUREI_LOG_ERROR("Unable to map spill segment %s: %s", path, strerror(errno));
+        close(fd);
+        unlink(path);
+        return false;
+    }
+    SpillSegmentHeader *header = (SpillSegmentHeader *)map;
+    memcpy(header->magic, SPILL_MAGIC, sizeof(header->magic));
+    header->seq = spill->write_seq;
+    atomic_store_explicit(&header->committed, SPILL_DATA_START, memory_order_relaxed);
+
+    spill->write_fd = fd;
+    spill->write_map = map;
+    spill->full_logged = false;
+    atomic_fetch_add_explicit(&spill->disk_bytes, YUREI_SPILL_SEGMENT_BYTES, memory_order_relaxed);
+    // Offset first: a reader that sees the new sequence never reads past it
+    atomic_store_explicit(&spill->write_off, SPILL_DATA_START, memory_order_release);
+    atomic_store_explicit(&spill->write_seq_published, spill->write_seq, memory_order_release);
+    return true;
+}
+
+int yurei_spill_append(YureiSpillQueue *spill, const YureiEvent *event) {
+    if (!spill || !event || !spill->dir[0]) {
+        return -1;
+    }
+    size_t signature_len = strnlen(event->signature, sizeof(event->signature));
+    size_t program_id_len = strnlen(event->program_id, sizeof(event->program_id));
+    size_t body = signature_len + program_id_len + event->data_len;
+    uint64_t total = align_up(sizeof(SpillRecord) + body);
+    int64_t received_unix_ns = event->received_ns ? (int64_t)event->received_ns + wall_offset_ns() : 0;
+
+    pthread_mutex_lock(&spill->lock);
+    uint64_t offset = atomic_load_explicit(&spill->write_off, memory_order_relaxed);
+    if ((!spill->write_map || offset + total > YUREI_SPILL_SEGMENT_BYTES) &&
+        !open_write_segment(spill)) {
+        pthread_mutex_unlock(&spill->lock);
+        return -1;
+    }
+    offset = atomic_load_explicit(&spill->write_off, memory_order_relaxed);
+
+    SpillRecord *record = (SpillRecord *)(spill->write_map + offset);
+    uint8_t *cursor = (uint8_t *)(record + 1);
+    memcpy(cursor, event->signature, signature_len);
+    cursor += signature_len;
+    memcpy(cursor, event->program_id, program_id_len);
+    cursor += program_id_len;
+    if (event->data_len > 0) {
+        memcpy(cursor, event->data, event->data_len);
+    }
+    record->slot = event->slot;
+    record->data_len = (uint32_t)event->data_len;
+    record->signature_len = (uint8_t)signature_len;
+    record->program_id_len = (uint8_t)program_id_len;
+    record->reserved = 0;
+    record->received_unix_ns = received_unix_ns;
+    record->length = (uint32_t)body;
+    record->crc = record_crc(record, sizeof(SpillRecord));
+    // Publishing the offset releases the record to the reader
+    atomic_store_explicit(&spill->write_off, offset + total, memory_order_release);
+    pthread_mutex_unlock(&spill->lock);
+
+    atomic_fetch_add_explicit(&spill->spilled, 1, memory_order_relaxed);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Replay (writer thread)
+// ---------------------------------------------------------------------------
+
+static bool segment_sealed(const YureiSpillQueue *spill) {
+    return spill->read_seq < atomic_load_explicit(&spill->write_seq_published, memory_order_acquire);
+}
+
+// Readable bytes of the mapped read segment
+static uint64_t read_limit(const YureiSpillQueue *spill) {
+    if (segment_sealed(spill)) {
+        return spill->read_size;
+    }
+    uint64_t limit = atomic_load_explicit(&spill->write_off, memory_order_acquire);
+    return limit < spill->read_size ? limit : spill->read_size;
+}
+
+// A sealed segment with nothing left to hand out
+static bool segment_exhausted(const YureiSpillQueue *spill) {
+    if (!segment_sealed(spill)) {
+        return false;
+    }
+    if (spill->read_off + spill->read_header > spill->read_size) {
+        return true;
+    }
+    const SpillRecord *record = (const SpillRecord *)(spill->read_map + spill->read_off);
+    return record->length == 0;
+}
+
+static void retire_segment(YureiSpillQueue *spill) {
+    char path[512];
+    segment_path(spill, spill->read_seq, path, sizeof(path));
+    uint64_t size = spill->read_size;
+    unmap_read(spill);
+    if (unlink(path) == 0) {
+        atomic_fetch_sub_explicit(&spill->disk_bytes, size, memory_order_relaxed);
+    }
+    spill->read_seq++;
+}
+
+// Map the segment the reader is on; false if it is not there yet
+static bool open_read_segment(YureiSpillQueue *spill) {
+    for (;;) {
+        uint64_t published = atomic_load_explicit(&spill->write_seq_published, memory_order_acquire);
+        if (spill->read_seq > published ||
+            (spill->read_seq == published &&
+             atomic_load_explicit(&spill->write_off, memory_order_acquire) == 0)) {
+            return false;
+        }
+        char path[512];
+        segment_path(spill, spill->read_seq, path, sizeof(path));
+        int fd = open(path, O_RDWR | O_CLOEXEC);
+        struct stat st;
+        uint8_t *map = NULL;
+        if (fd >= 0 && fstat(fd, &st) == 0 && (uint64_t)st.st_size >= SPILL_DATA_START) {
+            map = map_segment(fd, (size_t)st.st_size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+        const SpillSegmentHeader *header = (const SpillSegmentHeader *)map;
+        uint64_t committed = header ? atomic_load_explicit(&header->committed, memory_order_relaxed) : 0;
+        bool current = map && memcmp(header->magic, SPILL_MAGIC, sizeof(header->magic)) == 0;
+        bool v1 = map && memcmp(header->magic, SPILL_MAGIC_V1, sizeof(header->magic)) == 0;
+        if ((current || v1) && committed >= SPILL_DATA_START && committed <= (uint64_t)st.st_size) {
+            spill->read_map = map;
+            spill->read_header = current ? sizeof(SpillRecord) : SPILL_RECORD_V1_BYTES;
+            spill->read_size = (uint64_t)st.st_size;
+            spill->read_off = committed;
+            spill->committed_off = committed;
+            return true;
+        }
+        // Missing (already retired) or unusable: set it aside and move on
+        if (map) {
+            munmap(map, (size_t)st.st_size);
+        }
+        if (fd >= 0 || errno != ENOENT) {
+            char bad[520];
+            snprintf(bad, sizeof(bad), "%s.corrupt", path);
+            YUREI_LOG_ERROR("Spill segment %s is unreadable; moved to %s", path, bad);
+            rename(path, bad);
+        }
+        spill->read_seq++;
+    }
+}
+
+bool yurei_spill_pending(YureiSpillQueue *spill) {
+    if (!spill || !spill->dir[0]) {
+        return false;
+    }
+    uint64_t published = atomic_load_explicit(&spill->write_seq_published, memory_order_acquire);
+    if (spill->read_seq != published) {
+        return spill->read_seq < published;
+    }
+    uint64_t offset = spill->read_map ? spill->read_off : SPILL_DATA_START;
+    return offset < atomic_load_explicit(&spill->write_off, memory_order_acquire);
+}
+
+static bool record_valid(const SpillRecord *record, size_t header_bytes, uint64_t offset, uint64_t limit) {
+    if (record->signature_len >= YUREI_SIGNATURE_MAX ||
+        record->program_id_len >= YUREI_PROGRAM_ID_MAX ||
+        record->data_len > YUREI_EVENT_PAYLOAD_MAX ||
+        (uint64_t)record->signature_len + record->program_id_len + record->data_len != record->length ||
+        offset + align_up(header_bytes + record->length) > limit) {
+        return false;
+    }
+    return record_crc(record, header_bytes) == record->crc;
+}
+
+size_t yurei_spill_read(YureiSpillQueue *spill, YureiEvent *events, size_t max) {
+    if (!spill || !events || !spill->dir[0]) {
+        return 0;
+    }
+    size_t count = 0;
+    int64_t offset_ns = wall_offset_ns();
+    while (count < max) {
+        if (!spill->read_map && !open_read_segment(spill)) {
+            break;
+        }
+        if (segment_exhausted(spill)) {
+            if (count > 0) {
+                // Payloads point into this mapping; retire it on commit
+                break;
+            }
+            retire_segment(spill);
+            continue;
+        }
+        uint64_t limit = read_limit(spill);
+        if (spill->read_off + spill->read_header > limit) {
+            break;
+        }
+        const SpillRecord *record = (const SpillRecord *)(spill->read_map + spill->read_off);
+        if (record->length == 0 && !segment_sealed(spill)) {
+            break;
+        }
+        if (!record_valid(record, spill->read_header, spill->read_off, limit)) {
+            // Torn or damaged: nothing after it in this segment can be trusted
+            YUREI_LOG_ERROR("Spill shard %zu: bad record at %" PRIu64 " in segment %" PRIu64
+                            "; skipping the rest of the segment",
+                            spill->shard, spill->read_off, spill->read_seq);
+            spill->read_off = segment_sealed(spill) ? spill->read_size : limit;
+            continue;
+        }
+
+        YureiEvent *event = &events[count++];
+        memset(event, 0, sizeof(*event));
+        const uint8_t *body = (const uint8_t *)record + spill->read_header;
+        memcpy(event->signature, body, record->signature_len);
+        body += record->signature_len;
+        memcpy(event->program_id, body, record->program_id_len);
+        body += record->program_id_len;
+        event->kind = YUREI_EVENT_KIND_UNKNOWN;
+        event->slot = record->slot;
+        // Back onto this process's monotonic clock; a time from before the
+        // clock's start (an earlier boot) stays unknown
+        int64_t received_unix_ns = spill->read_header > SPILL_RECORD_V1_BYTES ? record->received_unix_ns : 0;
+        int64_t received_ns = received_unix_ns ? received_unix_ns - offset_ns : 0;
+        event->received_ns = received_ns > 0 ? (uint64_t)received_ns : 0;
+        event->data = (uint8_t *)body;
+        event->data_len = record->data_len;
+        spill->read_off += align_up(spill->read_header + record->length);
+    }
+    spill->read_count += count;
+    return count;
+}
+
+// Move the committed offset up to everything read so far
+static void advance_committed(YureiSpillQueue *spill) {
+    spill->committed_off = spill->read_off;
+    SpillSegmentHeader *header = (SpillSegmentHeader *)spill->read_map;
+    atomic_store_explicit(&header->committed, spill->committed_off, memory_order_release);
+    spill->read_count = 0;
+    if (segment_exhausted(spill)) {
+        retire_segment(spill);
+    }
+}
+
+void yurei_spill_commit(YureiSpillQueue *spill) {
+    if (!spill || !spill->read_map) {
+        return;
+    }
+    atomic_fetch_add_explicit(&spill->replayed, spill->read_count, memory_order_relaxed);
+    advance_committed(spill);
+}
+
+void yurei_spill_rewind(YureiSpillQueue *spill) {
+    if (!spill) {
+        return;
+    }
+    spill->read_off = spill->committed_off;
+    spill->read_count = 0;
+}
+
+static bool write_all(int fd, const void *data, size_t len) {
+    const uint8_t *cursor = data;
+    while (len > 0) {
+        ssize_t written = write(fd, cursor, len);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        cursor += written;
+        len -= (size_t)written;
+    }
+    return true;
+}
+
+int yurei_spill_dead_letter(YureiSpillQueue *spill) {
+    if (!spill || !spill->read_map || spill->read_off == spill->committed_off) {
+        return 0;
+    }
+    char path[512];
+    char dead[520];
+    segment_path(spill, spill->read_seq, path, sizeof(path));
+    snprintf(dead, sizeof(dead), "%s.dead", path);
+    uint64_t count = spill->read_count;
+
+    // Records are copied verbatim, CRC included, behind a header of their own
+    bool saved = false;
+    int fd = open(dead, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0) {
+        saved = true;
+        if (st.st_size == 0) {
+            SpillSegmentHeader header;
+            memset(&header, 0, sizeof(header));
+            // Same version as the records copied in
+            memcpy(header.magic, spill->read_map, sizeof(header.magic));
+            header.seq = spill->read_seq;
+            atomic_init(&header.committed, SPILL_DATA_START);
+            saved = write_all(fd, &header, sizeof(header));
+        }
+        saved = saved && write_all(fd, spill->read_map + spill->committed_off,
+                                   spill->read_off - spill->committed_off);
+    }
+    if (saved) {
+        YUREI_LOG_ERROR("Spill shard %zu: moved %" PRIu64 " record(s) the database keeps rejecting to %s",
+                        spill->shard, count, dead);
+    } else {
+        YUREI_LOG_ERROR("Spill shard %zu: unable to save %" PRIu64 " rejected record(s) to %s: %s; dropping them",
+                        spill->shard, count, dead, strerror(errno));
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    atomic_fetch_add_explicit(&spill->dead_lettered, count, memory_order_relaxed);
+    advance_committed(spill);
+    return saved ? 0 : -1;
+}
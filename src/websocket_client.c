@@ -5,15 +5,17 @@
 
 #include <libwebsockets.h>
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
-#include <unistd.h>
 
 #include "logging.h"
-#include "parser.h"
+#include "metrics.h"
+#include "parser_pool.h"
+#include "sharded_queue.h"
 
 typedef struct {
     char address[256];
@@ -22,13 +24,14 @@ typedef struct {
     bool secure;
 } WsEndpoint;
 
-typedef struct {
-    char outbound[512];
-    size_t outbound_len;
-    bool send_pending;
-} WsSessionData;
-
-static YureiWebsocketClient *g_client = NULL;
+// Upper bound on a reassembled message; anything larger is dropped
+#define WS_RX_MAX_MESSAGE (16u * 1024u * 1024u)
+#define WS_RX_INITIAL_CAPACITY (64u * 1024u)
+// lws_service wait; also the granularity of reconnect backoff
+#define WS_SERVICE_TIMEOUT_MS 100
+// First-arrival table size (power of two) and linear probe length
+#define WS_HEDGE_ENTRIES (1u << 17)
+#define WS_HEDGE_PROBES 8
 
 static int parse_endpoint(const char *url, WsEndpoint *endpoint) {
     if (!url || !endpoint) {
@@ -86,114 +89,279 @@ static int parse_endpoint(const char *url, WsEndpoint *endpoint) {
     return 0;
 }
 
-static void build_mentions_array(const YureiConfig *config, char *out, size_t len) {
-    bool first = true;
-    size_t offset = 0;
-    if (len == 0) {
+// logsSubscribe accepts a single address in "mentions", so each registered
+// program gets its own subscription, sent one per writeable callback.
+static void schedule_subscription(YureiWsEndpoint *session, const YureiConfig *config) {
+    if (!session || !config) {
         return;
     }
-    offset += snprintf(out + offset, len - offset, "[");
-    if (config->pumpfun_program[0]) {
-        offset += snprintf(out + offset,
-                           len - offset,
-                           "%s\"%s\"",
-                           first ? "" : ",",
-                           config->pumpfun_program);
-        first = false;
-    }
-    if (config->raydium_program[0]) {
-        offset += snprintf(out + offset,
-                           len - offset,
-                           "%s\"%s\"",
-                           first ? "" : ",",
-                           config->raydium_program);
-        first = false;
-    }
-    if (first) {
-        offset += snprintf(out + offset,
-                           len - offset,
-                           "\"%s\"",
-                           config->pumpfun_program);
-    }
-    snprintf(out + offset, len - offset, "]");
-}
-
-static void schedule_subscription(WsSessionData *session, const YureiConfig *config) {
-    if (!session || !config) {
+    const YureiProgram *program = yurei_program_get(&config->programs, (YureiEventKind)session->next_program);
+    if (!program) {
+        session->send_pending = false;
         return;
     }
-    char mentions[256];
-    build_mentions_array(config, mentions, sizeof(mentions));
     session->outbound_len = (size_t)snprintf(
         session->outbound,
         sizeof(session->outbound),
-        "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"logsSubscribe\","
-        "\"params\":[{\"mentions\":%s},{\"commitment\":\"confirmed\"}]}",
-        mentions);
+        "{\"jsonrpc\":\"2.0\",\"id\":%zu,\"method\":\"logsSubscribe\","
+        "\"params\":[{\"mentions\":[\"%s\"]},{\"commitment\":\"confirmed\"}]}",
+        session->next_program + 1,
+        program->program_id);
+    session->next_program++;
     session->send_pending = true;
 }
 
+static bool reserve_rx(YureiWsEndpoint *client, size_t needed) {
+    if (needed <= client->rx_capacity) {
+        return true;
+    }
+    if (needed > WS_RX_MAX_MESSAGE) {
+        return false;
+    }
+    size_t capacity = client->rx_capacity ? client->rx_capacity : WS_RX_INITIAL_CAPACITY;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    if (capacity > WS_RX_MAX_MESSAGE) {
+        capacity = WS_RX_MAX_MESSAGE;
+    }
+    char *grown = realloc(client->rx_buffer, capacity);
+    if (!grown) {
+        return false;
+    }
+    client->rx_buffer = grown;
+    client->rx_capacity = capacity;
+    return true;
+}
+
+// Slice of the "signature" value in a notification, or NULL if there is none
+// (subscription replies, errors)
+static const char *find_signature(const char *json, size_t len, size_t *out_len) {
+    static const char key[] = "\"signature\"";
+    const char *end = json + len;
+    const char *p = json;
+    for (;;) {
+        p = memchr(p, '"', (size_t)(end - p));
+        if (!p || (size_t)(end - p) < sizeof(key) - 1) {
+            return NULL;
+        }
+        if (memcmp(p, key, sizeof(key) - 1) == 0) {
+            break;
+        }
+        p++;
+    }
+    p += sizeof(key) - 1;
+    while (p < end && (*p == ' ' || *p == ':')) {
+        p++;
+    }
+    if (p >= end || *p != '"') {
+        return NULL;
+    }
+    const char *start = p + 1;
+    const char *close = memchr(start, '"', (size_t)(end - start));
+    if (!close || (size_t)(close - start) >= YUREI_SIGNATURE_MAX) {
+        return NULL;
+    }
+    *out_len = (size_t)(close - start);
+    return start;
+}
+
+// Check a complete message against the copies already forwarded. A copy
+// another endpoint delivered first records how far behind it was; one this
+// endpoint delivered twice (a transaction matching two of its subscriptions)
+// is dropped without counting. For a first copy, *claim is the entry to
+// take once the message is actually handed on (NULL without a signature).
+static bool hedge_is_duplicate(YureiWsEndpoint *endpoint,
+                               const char *json,
+                               size_t len,
+                               YureiWsHedgeEntry **claim,
+                               uint64_t *claim_hash) {
+    YureiWebsocketClient *client = endpoint->client;
+    *claim = NULL;
+    size_t sig_len = 0;
+    const char *sig = find_signature(json, len, &sig_len);
+    if (!sig) {
+        return false;
+    }
+    char signature[YUREI_SIGNATURE_MAX];
+    memcpy(signature, sig, sig_len);
+    signature[sig_len] = '\0';
+    uint64_t hash = yurei_signature_hash(signature);
+    uint64_t now = endpoint->rx_started_ns;
+
+    YureiWsHedgeEntry *victim = NULL;
+    for (size_t probe = 0; probe < WS_HEDGE_PROBES; ++probe) {
+        YureiWsHedgeEntry *entry = &client->hedge[(hash + probe) & client->hedge_mask];
+        // A message that started arriving before the entry was written still counts
+        bool live = entry->first_ns &&
+                    (now < entry->first_ns || now - entry->first_ns < client->hedge_window_ns);
+        if (live && entry->sig_hash == hash) {
+            if (entry->winner != endpoint->index) {
+                atomic_fetch_add_explicit(&endpoint->notifications, 1, memory_order_relaxed);
+                yurei_histogram_record(&endpoint->lag, now > entry->first_ns ? now - entry->first_ns : 0);
+            }
+            return true;
+        }
+        // Prefer an expired entry; otherwise overwrite the oldest in the probe run
+        if (!live) {
+            if (!victim || victim->first_ns) {
+                victim = entry;
+            }
+        } else if (!victim || (victim->first_ns && entry->first_ns < victim->first_ns)) {
+            victim = entry;
+        }
+    }
+    *claim = victim;
+    *claim_hash = hash;
+    return false;
+}
+
+static void deliver(YureiWsEndpoint *endpoint, const char *data, size_t len) {
+    YureiWebsocketClient *client = endpoint->client;
+    YureiWsHedgeEntry *claim = NULL;
+    uint64_t hash = 0;
+    if (client->hedge && hedge_is_duplicate(endpoint, data, len, &claim, &hash)) {
+        return;
+    }
+    if (yurei_parser_pool_submit(client->parsers, data, len, endpoint->rx_started_ns) != 0) {
+        // Not recorded as seen, so another provider's copy can still get through
+        if (claim) {
+            atomic_fetch_add_explicit(&endpoint->hedge_dropped, 1, memory_order_relaxed);
+        }
+        return;
+    }
+    if (claim) {
+        claim->sig_hash = hash;
+        claim->first_ns = endpoint->rx_started_ns ? endpoint->rx_started_ns : 1;
+        claim->winner = (uint32_t)endpoint->index;
+        atomic_fetch_add_explicit(&endpoint->notifications, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&endpoint->wins, 1, memory_order_relaxed);
+    }
+}
+
+// Feed one receive callback's bytes. Single-frame messages are copied straight
+// from the lws buffer into the parser pool; fragmented ones are reassembled
+// first. Nothing here parses or blocks, so the service loop stays responsive.
+static void handle_receive(YureiWsEndpoint *endpoint, struct lws *wsi, const char *in, size_t len) {
+    bool complete = lws_is_final_fragment(wsi) && lws_remaining_packet_payload(wsi) == 0;
+    if (endpoint->rx_discarding) {
+        // Fragments of a message already dropped; the next message starts clean
+        endpoint->rx_discarding = !complete;
+        return;
+    }
+    if (endpoint->rx_len == 0) {
+        // A message's latency is measured from its first frame
+        endpoint->rx_started_ns = yurei_now_ns();
+    }
+    if (complete && endpoint->rx_len == 0) {
+        deliver(endpoint, in, len);
+        return;
+    }
+
+    size_t remaining = lws_remaining_packet_payload(wsi);
+    if (!reserve_rx(endpoint, endpoint->rx_len + len + remaining)) {
+        YUREI_LOG_WARN_LIMITED("Dropping WebSocket message over %u bytes", WS_RX_MAX_MESSAGE);
+        endpoint->rx_len = 0;
+        endpoint->rx_discarding = !complete;
+        return;
+    }
+    memcpy(endpoint->rx_buffer + endpoint->rx_len, in, len);
+    endpoint->rx_len += len;
+
+    if (complete) {
+        deliver(endpoint, endpoint->rx_buffer, endpoint->rx_len);
+        endpoint->rx_len = 0;
+    }
+}
+
+// Back off exponentially before the next connection attempt
+static void schedule_retry(YureiWsEndpoint *endpoint, uint64_t now) {
+    const YureiConfig *config = endpoint->client->config;
+    endpoint->retry_at_ns = now + (uint64_t)endpoint->backoff_ms * 1000000ULL;
+    if (endpoint->backoff_ms < config->ws_backoff_max_ms) {
+        endpoint->backoff_ms = (endpoint->backoff_ms * 2);
+        if (endpoint->backoff_ms > config->ws_backoff_max_ms) {
+            endpoint->backoff_ms = config->ws_backoff_max_ms;
+        }
+    }
+}
+
+static void reset_connection(YureiWsEndpoint *endpoint) {
+    atomic_store_explicit(&endpoint->connected, false, memory_order_relaxed);
+    endpoint->wsi = NULL;
+    endpoint->rx_len = 0;
+    endpoint->rx_discarding = false;
+    endpoint->send_pending = false;
+}
+
 static int ws_callback(struct lws *wsi,
                        enum lws_callback_reasons reason,
                        void *user,
                        void *in,
                        size_t len) {
-    WsSessionData *session = (WsSessionData *)user;
+    // Each connection's user data is its endpoint (set at connect time)
+    YureiWsEndpoint *endpoint = (YureiWsEndpoint *)user;
     switch (reason) {
         case LWS_CALLBACK_CLIENT_ESTABLISHED: {
-            if (g_client) {
-                g_client->connected = true;
-                g_client->backoff_ms = g_client->config->ws_backoff_ms;
-                schedule_subscription(session, g_client->config);
-                lws_callback_on_writable(wsi);
-                YUREI_LOG_INFO("WebSocket connected to %s", g_client->config->wss_endpoint);
+            if (!endpoint) {
+                break;
+            }
+            YureiWebsocketClient *client = endpoint->client;
+            atomic_store_explicit(&endpoint->connected, true, memory_order_relaxed);
+            if (endpoint->established && client->metrics) {
+                yurei_metrics_ws_reconnect(client->metrics);
             }
+            endpoint->established = true;
+            endpoint->backoff_ms = client->config->ws_backoff_ms;
+            endpoint->next_program = 0;
+            schedule_subscription(endpoint, client->config);
+            lws_callback_on_writable(wsi);
+            YUREI_LOG_INFO("WebSocket connected to %s", endpoint->host);
             break;
         }
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR: {
-            YUREI_LOG_WARN("WebSocket connection error: %s",
-                           in ? (const char *)in : "unknown");
-            if (g_client) {
-                g_client->connected = false;
-                g_client->wsi = NULL;
+            YUREI_LOG_WARN_LIMITED("WebSocket connection error (%s): %s",
+                                   endpoint ? endpoint->host : "unknown",
+                                   in ? (const char *)in : "unknown");
+            if (endpoint) {
+                reset_connection(endpoint);
+                schedule_retry(endpoint, yurei_now_ns());
             }
             break;
         }
         case LWS_CALLBACK_CLOSED:
         case LWS_CALLBACK_CLIENT_CLOSED: {
-            if (g_client) {
-                g_client->connected = false;
-                g_client->wsi = NULL;
+            if (endpoint) {
+                // Reconnect on the next service pass
+                reset_connection(endpoint);
+                endpoint->retry_at_ns = 0;
             }
             break;
         }
         case LWS_CALLBACK_CLIENT_RECEIVE: {
-            if (!g_client || !g_client->queue || !g_client->config) {
-                break;
-            }
-            char *payload = calloc(len + 1, 1);
-            if (!payload) {
+            if (!endpoint || !endpoint->client->parsers) {
                 break;
             }
-            memcpy(payload, in, len);
-            payload[len] = '\0';
-            yurei_parser_handle_message(payload, g_client->config, g_client->queue, NULL);
-            free(payload);
+            handle_receive(endpoint, wsi, (const char *)in, len);
             break;
         }
         case LWS_CALLBACK_CLIENT_WRITEABLE: {
-            if (session && session->send_pending) {
+            if (endpoint && endpoint->send_pending) {
                 unsigned char buffer[LWS_PRE + 512];
-                if (session->outbound_len > sizeof(buffer) - LWS_PRE) {
-                    session->send_pending = false;
+                if (endpoint->outbound_len > sizeof(buffer) - LWS_PRE) {
+                    endpoint->send_pending = false;
                     break;
                 }
-                memcpy(&buffer[LWS_PRE], session->outbound, session->outbound_len);
+                memcpy(&buffer[LWS_PRE], endpoint->outbound, endpoint->outbound_len);
                 lws_write(wsi,
                           &buffer[LWS_PRE],
-                          session->outbound_len,
+                          endpoint->outbound_len,
                           LWS_WRITE_TEXT);
-                session->send_pending = false;
+                endpoint->send_pending = false;
+                schedule_subscription(endpoint, endpoint->client->config);
+                if (endpoint->send_pending) {
+                    lws_callback_on_writable(wsi);
+                }
             }
             break;
         }
@@ -203,32 +371,28 @@ static int ws_callback(struct lws *wsi,
     return 0;
 }
 
-static int establish_connection(YureiWebsocketClient *client) {
-    if (!client || !client->config) {
-        return -1;
-    }
-
-    WsEndpoint endpoint;
-    if (parse_endpoint(client->config->wss_endpoint, &endpoint) != 0) {
-        YUREI_LOG_ERROR("Invalid WSS endpoint: %s", client->config->wss_endpoint);
+static int establish_connection(YureiWsEndpoint *endpoint) {
+    WsEndpoint url;
+    if (parse_endpoint(endpoint->url, &url) != 0) {
         return -1;
     }
 
     struct lws_client_connect_info ccinfo;
     memset(&ccinfo, 0, sizeof(ccinfo));
-    ccinfo.context = (struct lws_context *)client->context;
-    ccinfo.address = endpoint.address;
-    ccinfo.port = endpoint.port;
-    ccinfo.path = endpoint.path;
-    ccinfo.host = endpoint.address;
-    ccinfo.origin = endpoint.address;
+    ccinfo.context = (struct lws_context *)endpoint->client->context;
+    ccinfo.address = url.address;
+    ccinfo.port = url.port;
+    ccinfo.path = url.path;
+    ccinfo.host = url.address;
+    ccinfo.origin = url.address;
     ccinfo.protocol = "yurei-protocol";
-    ccinfo.pwsi = (struct lws **)&client->wsi;
-    ccinfo.ssl_connection = endpoint.secure ? LCCSCF_USE_SSL : 0;
+    ccinfo.pwsi = (struct lws **)&endpoint->wsi;
+    ccinfo.userdata = endpoint;
+    ccinfo.ssl_connection = url.secure ? LCCSCF_USE_SSL : 0;
 
     if (!lws_client_connect_via_info(&ccinfo)) {
-        YUREI_LOG_WARN("Unable to connect to %s", client->config->wss_endpoint);
-        client->wsi = NULL;
+        YUREI_LOG_WARN_LIMITED("Unable to connect to %s", endpoint->host);
+        endpoint->wsi = NULL;
         return -1;
     }
 
@@ -241,7 +405,7 @@ static void *ws_thread(void *arg) {
         {
             .name = "yurei-protocol",
             .callback = ws_callback,
-            .per_session_data_size = sizeof(WsSessionData),
+            .per_session_data_size = 0,  // each connection gets its endpoint as user data
             .rx_buffer_size = 0,
         },
         { NULL, NULL, 0, 0 }
@@ -260,19 +424,20 @@ static void *ws_thread(void *arg) {
         return NULL;
     }
 
+    // One service loop drives every endpoint; a provider in backoff never
+    // delays the others
     while (client->running) {
-        if (!client->wsi && !client->connected) {
-            if (establish_connection(client) != 0) {
-                usleep(client->backoff_ms * 1000);
-                if (client->backoff_ms < client->config->ws_backoff_max_ms) {
-                    client->backoff_ms = (client->backoff_ms * 2);
-                    if (client->backoff_ms > client->config->ws_backoff_max_ms) {
-                        client->backoff_ms = client->config->ws_backoff_max_ms;
-                    }
+        uint64_t now = yurei_now_ns();
+        for (size_t i = 0; i < client->endpoint_count; ++i) {
+            YureiWsEndpoint *endpoint = &client->endpoints[i];
+            if (!endpoint->wsi && !atomic_load_explicit(&endpoint->connected, memory_order_relaxed) &&
+                now >= endpoint->retry_at_ns) {
+                if (establish_connection(endpoint) != 0) {
+                    schedule_retry(endpoint, now);
                 }
             }
         }
-        lws_service((struct lws_context *)client->context, 100);
+        lws_service((struct lws_context *)client->context, WS_SERVICE_TIMEOUT_MS);
     }
 
     if (client->context) {
@@ -282,32 +447,97 @@ static void *ws_thread(void *arg) {
     return NULL;
 }
 
+// Split the comma-separated endpoint list, validating each URL up front
+static int add_endpoints(YureiWebsocketClient *client, const char *list) {
+    const char *cursor = list;
+    while (*cursor) {
+        size_t len = strcspn(cursor, ",");
+        const char *start = cursor;
+        const char *end = cursor + len;
+        cursor = *end ? end + 1 : end;
+        while (start < end && (*start == ' ' || *start == '\t')) {
+            start++;
+        }
+        while (end > start && (end[-1] == ' ' || end[-1] == '\t')) {
+            end--;
+        }
+        if (start == end) {
+            continue;
+        }
+        if (client->endpoint_count == YUREI_WS_MAX_ENDPOINTS) {
+            YUREI_LOG_WARN("Only the first %d WSS endpoints are used", YUREI_WS_MAX_ENDPOINTS);
+            break;
+        }
+        YureiWsEndpoint *endpoint = &client->endpoints[client->endpoint_count];
+        WsEndpoint url;
+        if ((size_t)(end - start) >= sizeof(endpoint->url)) {
+            YUREI_LOG_ERROR("WSS endpoint too long: %.64s...", start);
+            return -1;
+        }
+        memcpy(endpoint->url, start, (size_t)(end - start));
+        endpoint->url[end - start] = '\0';
+        if (parse_endpoint(endpoint->url, &url) != 0) {
+            YUREI_LOG_ERROR("Invalid WSS endpoint: %s", endpoint->url);
+            return -1;
+        }
+        snprintf(endpoint->host, sizeof(endpoint->host), "%s", url.address);
+        endpoint->client = client;
+        endpoint->index = client->endpoint_count++;
+        endpoint->backoff_ms = client->config->ws_backoff_ms;
+    }
+    return client->endpoint_count > 0 ? 0 : -1;
+}
+
+static void free_endpoints(YureiWebsocketClient *client) {
+    for (size_t i = 0; i < client->endpoint_count; ++i) {
+        YureiWsEndpoint *endpoint = &client->endpoints[i];
+        free(endpoint->rx_buffer);
+        endpoint->rx_buffer = NULL;
+        endpoint->rx_len = 0;
+        endpoint->rx_capacity = 0;
+    }
+    free(client->hedge);
+    client->hedge = NULL;
+}
+
 int yurei_ws_client_start(YureiWebsocketClient *client,
                           const YureiConfig *config,
-                          YureiEventQueue *queue) {
-    if (!client || !config || !queue) {
-        return -1;
-    }
-    if (g_client) {
+                          YureiParserPool *parsers) {
+    if (!client || !config || !parsers) {
         return -1;
     }
 
     memset(client, 0, sizeof(*client));
     client->config = config;
-    client->queue = queue;
+    client->parsers = parsers;
+    client->metrics = parsers->pipeline ? parsers->pipeline->metrics : NULL;
+    if (add_endpoints(client, config->wss_endpoint) != 0) {
+        YUREI_LOG_ERROR("No usable WSS endpoint in '%s'", config->wss_endpoint);
+        return -1;
+    }
+    if (client->endpoint_count > 1) {
+        client->hedge = calloc(WS_HEDGE_ENTRIES, sizeof(*client->hedge));
+        if (!client->hedge) {
+            YUREI_LOG_ERROR("Unable to allocate WebSocket hedging table");
+            return -1;
+        }
+        client->hedge_mask = WS_HEDGE_ENTRIES - 1;
+        client->hedge_window_ns = (uint64_t)(config->ws_hedge_window_ms ? config->ws_hedge_window_ms : 1) *
+                                  1000000ULL;
+        YUREI_LOG_INFO("Hedging WebSocket subscriptions across %zu endpoints", client->endpoint_count);
+    }
     client->running = true;
-    client->backoff_ms = config->ws_backoff_ms;
-    g_client = client;
 
     if (pthread_create(&client->thread, NULL, ws_thread, client) != 0) {
-        g_client = NULL;
+        client->running = false;
+        free_endpoints(client);
         return -1;
     }
     return 0;
 }
 
 void yurei_ws_client_stop(YureiWebsocketClient *client) {
-    if (!client) {
+    if (!client || client->endpoint_count == 0) {
         return;
     }
     client->running = false;
@@ -315,5 +545,35 @@ void yurei_ws_client_stop(YureiWebsocketClient *client) {
         lws_cancel_service((struct lws_context *)client->context);
     }
     pthread_join(client->thread, NULL);
-    g_client = NULL;
+    free_endpoints(client);
+}
+
+void yurei_ws_client_log(const YureiWebsocketClient *client) {
+    if (!client || client->endpoint_count < 2) {
+        return;
+    }
+    // The snapshot is several KiB; keep it off the caller's stack
+    YureiHistogramSnapshot *snapshot = malloc(sizeof(*snapshot));
+    if (!snapshot) {
+        return;
+    }
+    for (size_t i = 0; i < client->endpoint_count; ++i) {
+        const YureiWsEndpoint *endpoint = &client->endpoints[i];
+        uint64_t notifications = atomic_load_explicit(&endpoint->notifications, memory_order_relaxed);
+        uint64_t wins = atomic_load_explicit(&endpoint->wins, memory_order_relaxed);
+        memset(snapshot, 0, sizeof(*snapshot));
+        yurei_histogram_merge(snapshot, &endpoint->lag);
+        YUREI_LOG_INFO("WS endpoint %s%s: %" PRIu64 " notifications, %.1f%% first, %" PRIu64
+                       " first copies dropped | behind n=%" PRIu64 " p50=%.2fms p99=%.2fms max=%.2fms",
+                       endpoint->host,
+                       atomic_load_explicit(&endpoint->connected, memory_order_relaxed) ? "" : " (down)",
+                       notifications,
+                       notifications ? (double)wins / (double)notifications * 100.0 : 0.0,
+                       atomic_load_explicit(&endpoint->hedge_dropped, memory_order_relaxed),
+                       snapshot->count,
+                       (double)yurei_histogram_quantile(snapshot, 0.50) / 1e6,
+                       (double)yurei_histogram_quantile(snapshot, 0.99) / 1e6,
+                       (double)snapshot->max_ns / 1e6);
+    }
+    free(snapshot);
 }